@@ -0,0 +1,438 @@
+/*
+ * Our ALT point-to-point shortest path engine.
+ */
+
+#include "alt.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "pq.h"
+#include "snapshot.h"
+
+#define NOTHING -1
+
+/*************************************************************************
+ ** Preprocessing
+ *************************************************************************/
+
+/* Returns the vertex whose smallest distance in 'nearest' is largest;
+ * vertices that no landmark reaches come first, so every component gets a
+ * landmark before any component gets a second one.
+ */
+static int farthestVertex(int* nearest, int numVertices) {
+  int farthest = 0;
+  for (int v = 1; v < numVertices; v++) {
+    if (nearest[v] > nearest[farthest]) farthest = v;
+  }
+  return farthest;
+}
+
+/* Sets components[v] to the smallest vertex ID in the connected component
+ * of each vertex v of 'graph', by breadth-first search.
+ */
+static void labelComponents(CSRGraph* graph, int* components) {
+  int numVertices = graph->numVertices;
+  int* queue = malloc(sizeof(int) * numVertices);
+  for (int v = 0; v < numVertices; v++) {
+    components[v] = NOTHING;
+  }
+  for (int root = 0; root < numVertices; root++) {
+    if (components[root] != NOTHING) continue;
+    components[root] = root;
+    int head = 0;
+    int tail = 0;
+    queue[tail++] = root;
+    while (head < tail) {
+      int u = queue[head++];
+      int end = graph->offsets[u + 1];
+      for (int i = graph->offsets[u]; i < end; i++) {
+        int v = graph->targets[i];
+        if (components[v] == NOTHING) {
+          components[v] = root;
+          queue[tail++] = v;
+        }
+      }
+    }
+  }
+  free(queue);
+}
+
+/* Returns newly created landmark tables for CSRGraph 'graph' with
+ * 'numLandmarks' landmarks (at most one per vertex). The first landmark is
+ * the vertex farthest from vertex 0, and each further one the vertex
+ * farthest from all landmarks chosen so far; distances come from
+ * getShortestPathsCSR configured by 'options' (NULL for the defaults).
+ * Returns NULL if 'graph' has no vertices, 'numLandmarks' < 1, or 'options'
+ * names no priority queue.
+ * Precondition: 'graph' is undirected, i.e. every edge is in the adjacency
+ *               lists of both its endpoints
+ */
+Landmarks* newLandmarks(CSRGraph* graph, int numLandmarks,
+                        AlgoOptions* options) {
+  int numVertices = graph->numVertices;
+  if (numVertices < 1 || numLandmarks < 1 || chooseQueue(options) == NULL) {
+    return NULL;
+  }
+  if (numLandmarks > numVertices) numLandmarks = numVertices;
+  // the lazy frontier leaves unreached vertices at exactly INT_MAX
+  AlgoOptions lazy = {PQ_DARY_HEAP};
+  if (options != NULL) lazy = *options;
+  lazy.lazyFrontier = true;
+
+  Landmarks* landmarks = malloc(sizeof(Landmarks));
+  landmarks->numVertices = numVertices;
+  landmarks->numLandmarks = numLandmarks;
+  landmarks->vertices = malloc(sizeof(int) * numLandmarks);
+  landmarks->components = malloc(sizeof(int) * numVertices);
+  landmarks->distances = malloc(sizeof(int) * (long)numVertices * numLandmarks);
+  landmarks->checksum = snapshotChecksum(graph);
+  landmarks->mapping = NULL;
+  landmarks->mappingSize = 0;
+  labelComponents(graph, landmarks->components);
+
+  int* nearest = malloc(sizeof(int) * numVertices);
+  Edge* tree = getShortestPathsCSR(graph, 0, &lazy);
+  for (int v = 0; v < numVertices; v++) {
+    nearest[v] = tree[v].weight;
+  }
+  free(tree);
+  for (int i = 0; i < numLandmarks; i++) {
+    int landmark = farthestVertex(nearest, numVertices);
+    landmarks->vertices[i] = landmark;
+    tree = getShortestPathsCSR(graph, landmark, &lazy);
+    for (int v = 0; v < numVertices; v++) {
+      landmarks->distances[(long)v * numLandmarks + i] = tree[v].weight;
+      if (i == 0 || tree[v].weight < nearest[v]) nearest[v] = tree[v].weight;
+    }
+    nearest[landmark] = -1;  // never picked twice, even at distance 0
+    free(tree);
+  }
+  free(nearest);
+  return landmarks;
+}
+
+/* Frees memory allocated for 'landmarks'.
+ */
+void deleteLandmarks(Landmarks* landmarks) {
+  if (landmarks == NULL) return;
+  if (landmarks->mapping != NULL) {
+    munmap(landmarks->mapping, landmarks->mappingSize);
+  } else {
+    free(landmarks->vertices);
+    free(landmarks->components);
+    free(landmarks->distances);
+  }
+  free(landmarks);
+}
+
+/*************************************************************************
+ ** Saving and loading
+ *************************************************************************/
+
+/* Returns the checksum of the arrays of 'landmarks'. */
+static uint64_t tablesChecksum(Landmarks* landmarks) {
+  uint64_t hash = CHECKSUM_SEED;
+  hash = hashInts(hash, landmarks->vertices, landmarks->numLandmarks);
+  hash = hashInts(hash, landmarks->components, landmarks->numVertices);
+  hash = hashInts(hash, landmarks->distances,
+                  (uint64_t)landmarks->numVertices * landmarks->numLandmarks);
+  return hash;
+}
+
+/* Fills in 'header' for a file holding 'landmarks'. */
+static void makeHeader(Landmarks* landmarks, LandmarksHeader* header) {
+  memset(header, 0, sizeof(LandmarksHeader));
+  strcpy(header->magic, LANDMARKS_MAGIC);
+  header->version = LANDMARKS_VERSION;
+  header->byteOrder = LANDMARKS_BYTE_ORDER;
+  header->headerSize = sizeof(LandmarksHeader);
+  header->numLandmarks = landmarks->numLandmarks;
+  header->numVertices = landmarks->numVertices;
+  header->checksum = landmarks->checksum;
+  header->tablesChecksum = tablesChecksum(landmarks);
+  header->verticesOffset = alignSection(sizeof(LandmarksHeader));
+  header->componentsOffset = alignSection(
+      header->verticesOffset + sizeof(int) * header->numLandmarks);
+  header->distancesOffset = alignSection(
+      header->componentsOffset + sizeof(int) * header->numVertices);
+  header->fileSize = header->distancesOffset + sizeof(int) *
+                                                   header->numVertices *
+                                                   header->numLandmarks;
+}
+
+/* Writes 'landmarks' to the file at 'path', under a temporary name that is
+ * renamed into place. Returns false and fills in 'error' (if not NULL) on
+ * failure.
+ */
+bool writeLandmarks(Landmarks* landmarks, const char* path, LoadError* error) {
+  if (error != NULL) error->failed = false;
+  LandmarksHeader header;
+  makeHeader(landmarks, &header);
+
+  FileSection sections[] = {
+      {0, &header, sizeof(LandmarksHeader)},
+      {header.verticesOffset, landmarks->vertices,
+       sizeof(int) * header.numLandmarks},
+      {header.componentsOffset, landmarks->components,
+       sizeof(int) * header.numVertices},
+      {header.distancesOffset, landmarks->distances,
+       sizeof(int) * header.numVertices * header.numLandmarks},
+  };
+  return writeFileAtomically(path, sections, 4, "landmark file", error);
+}
+
+/* Checks 'header' of a landmark file of 'fileSize' bytes against CSRGraph
+ * 'graph'. Returns false and fills in 'error' if the file cannot be used
+ * with 'graph'.
+ */
+static bool checkHeader(LandmarksHeader* header, uint64_t fileSize,
+                        CSRGraph* graph, LoadError* error) {
+  if (fileSize < sizeof(LandmarksHeader) ||
+      memcmp(header->magic, LANDMARKS_MAGIC, sizeof(LANDMARKS_MAGIC)) != 0) {
+    setLoadError(error, 0, 0, 0, "Not a landmark file");
+    return false;
+  }
+  if (header->version != LANDMARKS_VERSION) {
+    setLoadError(error, 0, 0, 0, "Unsupported landmark file version %u",
+                 header->version);
+    return false;
+  }
+  if (header->byteOrder != LANDMARKS_BYTE_ORDER ||
+      header->headerSize != sizeof(LandmarksHeader)) {
+    setLoadError(error, 0, 0, 0,
+                 "Landmark file was written on another platform");
+    return false;
+  }
+  if (header->numLandmarks < 1 || header->numLandmarks > header->numVertices ||
+      header->numVertices >= INT32_MAX || header->fileSize != fileSize ||
+      header->verticesOffset % SECTION_ALIGN != 0 ||
+      header->componentsOffset % SECTION_ALIGN != 0 ||
+      header->distancesOffset % SECTION_ALIGN != 0 ||
+      !sectionFits(header->verticesOffset, header->numLandmarks, sizeof(int),
+                   header->componentsOffset) ||
+      !sectionFits(header->componentsOffset, header->numVertices, sizeof(int),
+                   header->distancesOffset) ||
+      // the checks before keep this product below 2^62
+      !sectionFits(header->distancesOffset,
+                   header->numVertices * header->numLandmarks, sizeof(int),
+                   fileSize)) {
+    setLoadError(error, 0, 0, 0, "Landmark file is truncated or corrupt");
+    return false;
+  }
+  if (header->numVertices != (uint64_t)graph->numVertices ||
+      header->checksum != snapshotChecksum(graph)) {
+    setLoadError(error, 0, 0, 0, "Landmark file was built for another graph");
+    return false;
+  }
+  return true;
+}
+
+/* Checks the arrays of 'landmarks', loaded from a file with 'header'.
+ * Returns false and fills in 'error' if they are corrupt.
+ */
+static bool checkTables(Landmarks* landmarks, LandmarksHeader* header,
+                        LoadError* error) {
+  if (tablesChecksum(landmarks) != header->tablesChecksum) {
+    setLoadError(error, 0, 0, 0, "Landmark file checksum mismatch");
+    return false;
+  }
+  int numVertices = landmarks->numVertices;
+  for (int i = 0; i < landmarks->numLandmarks; i++) {
+    if (landmarks->vertices[i] < 0 || landmarks->vertices[i] >= numVertices) {
+      setLoadError(error, 0, 0, header->verticesOffset + sizeof(int) * i,
+                   "Invalid landmark ID: %d", landmarks->vertices[i]);
+      return false;
+    }
+  }
+  for (int v = 0; v < numVertices; v++) {
+    if (landmarks->components[v] < 0 ||
+        landmarks->components[v] >= numVertices) {
+      setLoadError(error, 0, 0, header->componentsOffset + sizeof(int) * v,
+                   "Invalid component ID: %d", landmarks->components[v]);
+      return false;
+    }
+  }
+  long numDistances = (long)numVertices * landmarks->numLandmarks;
+  for (long i = 0; i < numDistances; i++) {
+    if (landmarks->distances[i] < 0) {
+      setLoadError(error, 0, 0, header->distancesOffset + sizeof(int) * i,
+                   "Negative landmark distance: %d", landmarks->distances[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Returns landmark tables whose arrays point straight into the
+ * memory-mapped file at 'path'. The file must have been written for
+ * CSRGraph 'graph': its vertex count and checksum must match. The arrays
+ * are checked against their checksum and for IDs and distances out of
+ * range, which reads the whole file. The result must be freed with
+ * deleteLandmarks and must not be modified.
+ * Returns NULL and fills in 'error' (if not NULL) on failure.
+ */
+Landmarks* loadLandmarks(const char* path, CSRGraph* graph, LoadError* error) {
+  if (error != NULL) error->failed = false;
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    setLoadError(error, 0, 0, 0, "Unable to open landmark file: %s",
+                 strerror(errno));
+    return NULL;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 ||
+      info.st_size < (off_t)sizeof(LandmarksHeader)) {
+    setLoadError(error, 0, 0, 0, "Not a landmark file");
+    close(fd);
+    return NULL;
+  }
+  void* mapping = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    setLoadError(error, 0, 0, 0, "Could not map landmark file: %s",
+                 strerror(errno));
+    return NULL;
+  }
+
+  LandmarksHeader* header = mapping;
+  if (!checkHeader(header, info.st_size, graph, error)) {
+    munmap(mapping, info.st_size);
+    return NULL;
+  }
+  Landmarks* landmarks = malloc(sizeof(Landmarks));
+  char* base = mapping;
+  landmarks->numVertices = header->numVertices;
+  landmarks->numLandmarks = header->numLandmarks;
+  landmarks->vertices = (int*)(base + header->verticesOffset);
+  landmarks->components = (int*)(base + header->componentsOffset);
+  landmarks->distances = (int*)(base + header->distancesOffset);
+  landmarks->checksum = header->checksum;
+  landmarks->mapping = mapping;
+  landmarks->mappingSize = info.st_size;
+  if (!checkTables(landmarks, header, error)) {
+    deleteLandmarks(landmarks);
+    return NULL;
+  }
+  return landmarks;
+}
+
+/*************************************************************************
+ ** Queries
+ *************************************************************************/
+
+/* Returns the landmark lower bound on the distance between vertices with
+ * IDs 'vertex' and 'targetVertex', or INT_MAX if they lie in different
+ * components, so that no path joins them. Landmarks at distance INT_MAX
+ * from either vertex are skipped.
+ */
+int landmarkBound(Landmarks* landmarks, int vertex, int targetVertex) {
+  if (landmarks->components[vertex] != landmarks->components[targetVertex]) {
+    return INT_MAX;
+  }
+  int k = landmarks->numLandmarks;
+  int* fromVertex = landmarks->distances + (long)vertex * k;
+  int* fromTarget = landmarks->distances + (long)targetVertex * k;
+  int bound = 0;
+  for (int i = 0; i < k; i++) {
+    // INT_MAX stands for another component or for a distance too large
+    // to store; either way this landmark bounds nothing
+    if (fromVertex[i] == INT_MAX || fromTarget[i] == INT_MAX) continue;
+    int difference = fromVertex[i] - fromTarget[i];
+    if (difference < 0) difference = -difference;
+    if (difference > bound) bound = difference;
+  }
+  return bound;
+}
+
+/* Returns the path from 'targetVertex' along 'predecessors' to
+ * 'startVertex', with edge weights taken from the differences in
+ * 'distances', in the form getShortestPath returns.
+ */
+static AdjList* tracePath(int* predecessors, int* distances, int startVertex,
+                          int targetVertex) {
+  AdjList* head = NULL;
+  AdjList* tail = NULL;
+  for (int v = targetVertex; v != startVertex; v = predecessors[v]) {
+    int next = predecessors[v];
+    AdjList* node =
+        newAdjList(newEdge(v, next, distances[v] - distances[next]), NULL);
+    if (head == NULL) {
+      head = node;
+    } else {
+      tail->next = node;
+    }
+    tail = node;
+  }
+  return head;
+}
+
+/* Like getShortestPathCSR, but runs an A* search guided by landmarkBound
+ * from 'landmarks', which must have been built for 'graph'. The search
+ * stops as soon as the target is settled; options->bidirectional is
+ * ignored.
+ */
+AdjList* altGetShortestPath(CSRGraph* graph, Landmarks* landmarks,
+                            int startVertex, int targetVertex,
+                            AlgoOptions* options, int* distance) {
+  int ignored;
+  if (distance == NULL) distance = &ignored;
+  *distance = INT_MAX;
+  int numVertices = graph->numVertices;
+  const PQOps* ops = chooseQueue(options);
+  if (startVertex < 0 || startVertex >= numVertices || targetVertex < 0 ||
+      targetVertex >= numVertices || ops == NULL) {
+    return NULL;
+  }
+  if (startVertex == targetVertex) {
+    *distance = 0;
+    return NULL;
+  }
+  if (landmarkBound(landmarks, startVertex, targetVertex) == INT_MAX) {
+    return NULL;
+  }
+
+  // the queue holds reached vertices by distance + bound; with a
+  // consistent bound every vertex is settled once, in order of that key.
+  // The search runs on the forward side of this thread's query scratch, so
+  // it only pays for the vertices it reaches.
+  PathQuery* query = threadPathQuery(numVertices, ops);
+  int* distances = query->distances[0];
+  bool* finished = query->finished[0];
+  PriorityQueue* pq = &query->pq[0];
+  reachQueryVertex(query, 0, startVertex, 0,
+                   landmarkBound(landmarks, startVertex, targetVertex),
+                   NOTHING);
+  while (!pqIsEmpty(pq)) {
+    int u = pqExtractMin(pq).id;
+    finished[u] = true;
+    if (u == targetVertex) break;
+    int end = graph->offsets[u + 1];
+    for (int i = graph->offsets[u]; i < end; i++) {
+      int v = graph->targets[i];
+      // sums are taken in long long; as in dijkstraRelax, a path of
+      // INT_MAX or more is no path at all, and neither is a key that large,
+      // since the bound never overestimates the rest of the way
+      long long reach = (long long)distances[u] + graph->weights[i];
+      if (finished[v] || reach >= distances[v]) continue;
+      int bound = landmarkBound(landmarks, v, targetVertex);
+      if (bound == INT_MAX) continue;  // v cannot reach the target
+      long long key = reach + bound;
+      if (key >= INT_MAX) continue;
+      reachQueryVertex(query, 0, v, reach, key, u);
+    }
+  }
+
+  AdjList* path = NULL;
+  if (finished[targetVertex]) {
+    *distance = distances[targetVertex];
+    path = tracePath(query->predecessors[0], distances, startVertex,
+                     targetVertex);
+  }
+  return path;
+}
@@ -0,0 +1,128 @@
+/*
+ * Header file for our ALT point-to-point shortest path engine (A*,
+ * landmarks, triangle inequality).
+ *
+ * Preprocessing picks a few landmark vertices and stores the distance from
+ * every vertex to every landmark. For any vertices v and t and landmark L,
+ * the triangle inequality gives dist(v, t) >= |dist(L, t) - dist(L, v)|, a
+ * lower bound that steers an A* search towards the target.
+ *
+ * Distances of INT_MAX or more are stored as INT_MAX and give no bound; each
+ * vertex also records its component, so that the tables still tell which
+ * vertices no path joins.
+ *
+ * Tables can be saved to disk and loaded back with a single mmap. A saved
+ * table records the checksum of the graph it was built for, and is refused
+ * for any other graph, as well as a checksum of its own arrays.
+ *
+ * Layout of a landmark file (native byte order, sections 64-byte aligned):
+ *   LandmarksHeader
+ *   int vertices[numLandmarks]
+ *   int components[numVertices]
+ *   int distances[numVertices * numLandmarks]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "csr.h"
+#include "graph.h"
+#include "graph_algos.h"
+#include "graph_io.h"
+
+#ifndef __ALT_header
+#define __ALT_header
+
+#define LANDMARKS_MAGIC "PRIMALT"
+#define LANDMARKS_VERSION 3
+#define LANDMARKS_BYTE_ORDER 0x01020304u
+
+typedef struct landmarks {
+  int numVertices;     // number of vertices of the graph
+  int numLandmarks;    // number of landmarks
+  int* vertices;       // vertices[i] is the ID of landmark i
+  int* components;     // components[v] is the smallest vertex ID in the
+                       //   connected component of vertex v
+  int* distances;      // distances[v * numLandmarks + i] is the distance
+                       //   between vertex v and landmark i, INT_MAX if
+                       //   there is no path shorter than INT_MAX
+  uint64_t checksum;   // snapshotChecksum of the graph (see snapshot.h)
+  void* mapping;       // memory map holding the arrays, or NULL if they
+                       //   are malloc'd
+  size_t mappingSize;  // length of 'mapping' in bytes
+} Landmarks;
+
+typedef struct landmarks_header {
+  char magic[8];              // LANDMARKS_MAGIC, NUL-terminated
+  uint32_t version;           // LANDMARKS_VERSION of the writer
+  uint32_t byteOrder;         // LANDMARKS_BYTE_ORDER as written by the writer
+  uint32_t headerSize;        // sizeof(LandmarksHeader)
+  uint32_t numLandmarks;      // number of landmarks
+  uint64_t numVertices;       // number of vertices of the graph
+  uint64_t checksum;          // snapshotChecksum of the graph
+  uint64_t tablesChecksum;    // checksum of the three arrays below
+  uint64_t verticesOffset;    // byte offset of the vertices array in the file
+  uint64_t componentsOffset;  // byte offset of the components array
+  uint64_t distancesOffset;   // byte offset of the distances array
+  uint64_t fileSize;          // total size of the file, in bytes
+} LandmarksHeader;
+
+/***** Preprocessing ********************************************************/
+
+/* Returns newly created landmark tables for CSRGraph 'graph' with
+ * 'numLandmarks' landmarks (at most one per vertex). The first landmark is
+ * the vertex farthest from vertex 0, and each further one the vertex
+ * farthest from all landmarks chosen so far; distances come from
+ * getShortestPathsCSR configured by 'options' (NULL for the defaults).
+ * Returns NULL if 'graph' has no vertices, 'numLandmarks' < 1, or 'options'
+ * names no priority queue.
+ * Precondition: 'graph' is undirected, i.e. every edge is in the adjacency
+ *               lists of both its endpoints
+ */
+Landmarks* newLandmarks(CSRGraph* graph, int numLandmarks,
+                        AlgoOptions* options);
+
+/* Frees memory allocated for 'landmarks'.
+ */
+void deleteLandmarks(Landmarks* landmarks);
+
+/***** Saving and loading ***************************************************/
+
+/* Writes 'landmarks' to the file at 'path', under a temporary name that is
+ * renamed into place. Returns false and fills in 'error' (if not NULL) on
+ * failure.
+ */
+bool writeLandmarks(Landmarks* landmarks, const char* path, LoadError* error);
+
+/* Returns landmark tables whose arrays point straight into the
+ * memory-mapped file at 'path'. The file must have been written for
+ * CSRGraph 'graph': its vertex count and checksum must match. The arrays
+ * are checked against their checksum and for IDs and distances out of
+ * range, which reads the whole file. The result must be freed with
+ * deleteLandmarks and must not be modified.
+ * Returns NULL and fills in 'error' (if not NULL) on failure.
+ */
+Landmarks* loadLandmarks(const char* path, CSRGraph* graph, LoadError* error);
+
+/***** Queries **************************************************************/
+
+/* Returns the landmark lower bound on the distance between vertices with
+ * IDs 'vertex' and 'targetVertex', or INT_MAX if they lie in different
+ * components, so that no path joins them. Landmarks at distance INT_MAX
+ * from either vertex are skipped.
+ */
+int landmarkBound(Landmarks* landmarks, int vertex, int targetVertex);
+
+/* Like getShortestPathCSR, but runs an A* search guided by landmarkBound
+ * from 'landmarks', which must have been built for 'graph'. The search
+ * stops as soon as the target is settled; options->bidirectional is
+ * ignored. Like getShortestPathCSR, it runs on the calling thread's query
+ * scratch (see threadPathQuery).
+ */
+AdjList* altGetShortestPath(CSRGraph* graph, Landmarks* landmarks,
+                            int startVertex, int targetVertex,
+                            AlgoOptions* options, int* distance);
+
+#endif
@@ -0,0 +1,88 @@
+/*
+ * Our arena (bump-pointer) allocator.
+ */
+
+#include "arena.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define MAX_BLOCK_SIZE (64 * 1024 * 1024)
+
+/* Returns 'bytes' rounded up to a multiple of the strictest alignment. */
+static size_t alignUp(size_t bytes) {
+  size_t align = sizeof(max_align_t);
+  return (bytes + align - 1) / align * align;
+}
+
+/* Returns a newly created empty Arena whose first block will hold
+ * 'initialBlockSize' bytes; later blocks double in size. Returns NULL if
+ * memory could not be allocated.
+ * Precondition: initialBlockSize > 0
+ */
+Arena* newArena(size_t initialBlockSize) {
+  Arena* new = malloc(sizeof(Arena));
+  if (new == NULL) return NULL;
+  new->head = NULL;
+  new->nextSize = alignUp(initialBlockSize);
+  new->maxBlockSize = MAX_BLOCK_SIZE;
+  new->numBlocks = 0;
+  return new;
+}
+
+/* Starts a new block in 'arena' with room for at least 'bytes' bytes.
+ * Returns false if memory could not be allocated.
+ */
+static bool addBlock(Arena* arena, size_t bytes) {
+  size_t size = arena->nextSize;
+  if (size < bytes) size = bytes;
+  ArenaBlock* block = malloc(sizeof(ArenaBlock) + size);
+  if (block == NULL) return false;
+  block->next = arena->head;
+  block->used = 0;
+  block->size = size;
+  arena->head = block;
+  arena->numBlocks++;
+  if (arena->nextSize < arena->maxBlockSize) {
+    arena->nextSize *= 2;
+  }
+  return true;
+}
+
+/* Returns a pointer to 'bytes' bytes from 'arena', suitably aligned for any
+ * type. Returns NULL if memory could not be allocated.
+ */
+void* arenaAlloc(Arena* arena, size_t bytes) {
+  bytes = alignUp(bytes);
+  ArenaBlock* block = arena->head;
+  if (block == NULL || block->size - block->used < bytes) {
+    if (!addBlock(arena, bytes)) return NULL;
+    block = arena->head;
+  }
+  void* result = (char*)block->data + block->used;
+  block->used += bytes;
+  return result;
+}
+
+/* Like arenaAlloc, but zeroes the returned 'count' * 'bytes' bytes. Returns
+ * NULL if that product does not fit in a size_t.
+ */
+void* arenaCalloc(Arena* arena, size_t count, size_t bytes) {
+  if (bytes != 0 && count > SIZE_MAX / bytes) return NULL;
+  void* result = arenaAlloc(arena, count * bytes);
+  if (result != NULL) memset(result, 0, count * bytes);
+  return result;
+}
+
+/* Frees 'arena' and every allocation made from it. */
+void deleteArena(Arena* arena) {
+  if (arena == NULL) return;
+  ArenaBlock* block = arena->head;
+  ArenaBlock* next;
+  while (block != NULL) {
+    next = block->next;
+    free(block);
+    block = next;
+  }
+  free(arena);
+}
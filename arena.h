@@ -0,0 +1,52 @@
+/*
+ * Header file for our arena (bump-pointer) allocator.
+ *
+ * An Arena hands out memory from a few large blocks. Individual allocations
+ * are never freed; the whole arena is released at once by deleteArena, which
+ * costs one free per block.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef __Arena_header
+#define __Arena_header
+
+typedef struct arena_block {
+  struct arena_block* next;  // the previously filled block, or NULL
+  size_t used;               // number of bytes handed out from 'data'
+  size_t size;               // number of bytes available in 'data'
+  max_align_t data[];        // storage for the allocations
+} ArenaBlock;
+
+typedef struct arena {
+  ArenaBlock* head;     // block currently being filled, or NULL
+  size_t nextSize;      // size of the next block to allocate
+  size_t maxBlockSize;  // blocks never grow past this (unless one allocation
+                        //   is larger)
+  size_t numBlocks;     // number of blocks allocated so far
+} Arena;
+
+/* Returns a newly created empty Arena whose first block will hold
+ * 'initialBlockSize' bytes; later blocks double in size. Returns NULL if
+ * memory could not be allocated.
+ * Precondition: initialBlockSize > 0
+ */
+Arena* newArena(size_t initialBlockSize);
+
+/* Returns a pointer to 'bytes' bytes from 'arena', suitably aligned for any
+ * type. Returns NULL if memory could not be allocated.
+ */
+void* arenaAlloc(Arena* arena, size_t bytes);
+
+/* Like arenaAlloc, but zeroes the returned 'count' * 'bytes' bytes. Returns
+ * NULL if that product does not fit in a size_t.
+ */
+void* arenaCalloc(Arena* arena, size_t count, size_t bytes);
+
+/* Frees 'arena' and every allocation made from it. */
+void deleteArena(Arena* arena);
+
+#endif
@@ -0,0 +1,559 @@
+/*
+ * Our contraction hierarchies.
+ */
+
+#include "ch.h"
+
+#include <limits.h>
+
+#define NOTHING -1
+
+// most vertices a witness search settles before giving up; a search that
+// gives up only costs an unneeded shortcut
+#ifndef CH_WITNESS_LIMIT
+#define CH_WITNESS_LIMIT 256
+#endif
+
+/*************************************************************************
+ ** The remaining graph during contraction
+ *************************************************************************/
+
+typedef struct arc {
+  int target;  // other end of the arc
+  int weight;  // weight of the arc
+  int middle;  // vertex a shortcut was added for, or NOTHING for an edge
+} Arc;
+
+typedef struct arc_list {
+  Arc* arcs;     // the arcs
+  int size;      // number of arcs in 'arcs'
+  int capacity;  // number of arcs 'arcs' has room for
+} ArcList;
+
+typedef struct contraction {
+  int numVertices;            // total number of vertices
+  ArcList* lists;             // lists[v] holds v's arcs to vertices that were
+                              //   not contracted before v
+  int* contractedNeighbours;  // number of contracted neighbours of each v
+  int* depths;                // depths[v] is one more than the largest depth
+                              //   of a contracted neighbour of v, or 0
+  int* distances;             // witness search distances, INT_MAX if not
+                              //   reached
+  int* touched;               // vertices the witness search reached
+  int* targets;               // targets[v] == round iff v is a vertex the
+                              //   current witness search looks for
+  int round;                  // number of witness searches so far
+  int numTouched;             // number of vertices in 'touched'
+  PriorityQueue pq;           // witness search frontier
+} Contraction;
+
+/* Appends 'arc' to 'list'. */
+static void pushArc(ArcList* list, Arc arc) {
+  if (list->size == list->capacity) {
+    list->capacity = list->capacity > 0 ? 2 * list->capacity : 4;
+    list->arcs = realloc(list->arcs, sizeof(Arc) * list->capacity);
+  }
+  list->arcs[list->size++] = arc;
+}
+
+/* Returns the index of the arc to 'target' in 'list', or NOTHING. */
+static int findArc(ArcList* list, int target) {
+  for (int i = 0; i < list->size; i++) {
+    if (list->arcs[i].target == target) return i;
+  }
+  return NOTHING;
+}
+
+/* Removes the arc to 'target' from 'list', if there is one. */
+static void removeArc(ArcList* list, int target) {
+  int i = findArc(list, target);
+  if (i != NOTHING) list->arcs[i] = list->arcs[--list->size];
+}
+
+/* Joins 'u' and 'w' by an arc of weight 'weight' added for 'middle', unless
+ * they are already joined by an arc at most as heavy, in which case nothing
+ * changes. Returns true iff an arc was added or made lighter.
+ */
+static bool joinVertices(Contraction* c, int u, int w, int weight,
+                         int middle) {
+  int i = findArc(&c->lists[u], w);
+  if (i != NOTHING) {
+    if (c->lists[u].arcs[i].weight <= weight) return false;
+    int j = findArc(&c->lists[w], u);
+    c->lists[u].arcs[i] = (Arc){w, weight, middle};
+    c->lists[w].arcs[j] = (Arc){u, weight, middle};
+    return true;
+  }
+  pushArc(&c->lists[u], (Arc){w, weight, middle});
+  pushArc(&c->lists[w], (Arc){u, weight, middle});
+  return true;
+}
+
+/* Runs Dijkstra's algorithm from 'source' in the remaining graph without
+ * vertex 'avoid', until the 'numTargets' vertices marked in c->targets are
+ * settled, the distance exceeds 'limit', or CH_WITNESS_LIMIT vertices are
+ * settled. The distances found stay in c->distances until
+ * clearWitnessSearch.
+ */
+static void witnessSearch(Contraction* c, int source, int avoid, int limit,
+                          int numTargets) {
+  c->distances[source] = 0;
+  c->touched[c->numTouched++] = source;
+  pqInsert(&c->pq, 0, source);
+  int settled = 0;
+  while (!pqIsEmpty(&c->pq) && settled < CH_WITNESS_LIMIT) {
+    HeapNode node = pqExtractMin(&c->pq);
+    if (node.priority > limit) break;
+    if (c->targets[node.id] == c->round && --numTargets == 0) break;
+    settled++;
+    ArcList* list = &c->lists[node.id];
+    for (int i = 0; i < list->size; i++) {
+      int v = list->arcs[i].target;
+      if (v == avoid) continue;
+      long reach = (long)node.priority + list->arcs[i].weight;
+      if (reach >= c->distances[v]) continue;
+      if (c->distances[v] == INT_MAX) {
+        c->touched[c->numTouched++] = v;
+        c->distances[v] = reach;
+        pqInsert(&c->pq, reach, v);
+      } else {
+        c->distances[v] = reach;
+        if (pqContains(&c->pq, v)) pqDecreasePriority(&c->pq, v, reach);
+      }
+    }
+  }
+}
+
+/* Resets the distances of the last witness search and empties its queue. */
+static void clearWitnessSearch(Contraction* c) {
+  for (int i = 0; i < c->numTouched; i++) {
+    c->distances[c->touched[i]] = INT_MAX;
+  }
+  c->numTouched = 0;
+  while (!pqIsEmpty(&c->pq)) pqExtractMin(&c->pq);
+}
+
+/* Returns the number of shortcuts contracting 'v' needs, and adds them if
+ * 'simulate' is false.
+ */
+static int contractVertex(Contraction* c, int v, bool simulate) {
+  ArcList* list = &c->lists[v];
+  int shortcuts = 0;
+  // each pair of neighbours is checked once, from the one listed first
+  for (int i = 0; i + 1 < list->size; i++) {
+    Arc in = list->arcs[i];
+    long long heaviest = 0;
+    c->round++;
+    for (int j = i + 1; j < list->size; j++) {
+      c->targets[list->arcs[j].target] = c->round;
+      if (list->arcs[j].weight > heaviest) heaviest = list->arcs[j].weight;
+    }
+    // sums are taken in long long; as in dijkstraRelax, a path of INT_MAX
+    // or more is no path at all, so it needs no shortcut
+    long long limit = in.weight + heaviest;
+    witnessSearch(c, in.target, v, limit < INT_MAX ? limit : INT_MAX,
+                  list->size - i - 1);
+    for (int j = i + 1; j < list->size; j++) {
+      Arc out = list->arcs[j];
+      long long through = (long long)in.weight + out.weight;
+      if (through >= INT_MAX) continue;
+      if (c->distances[out.target] <= through) continue;  // witness found
+      shortcuts++;
+      if (!simulate) joinVertices(c, in.target, out.target, through, v);
+    }
+    clearWitnessSearch(c);
+  }
+  return shortcuts;
+}
+
+/* Returns the priority of contracting 'v' now: twice its edge difference,
+ * plus the number of its neighbours already contracted and its depth. The
+ * last two spread contractions evenly over the graph, which keeps the
+ * hierarchy shallow.
+ */
+static int contractionPriority(Contraction* c, int v) {
+  return 2 * contractVertex(c, v, true) - 2 * c->lists[v].size +
+         c->contractedNeighbours[v] + c->depths[v];
+}
+
+/* Creates the remaining graph for contracting Graph 'graph'. */
+static Contraction* newContraction(Graph* graph) {
+  int numVertices = graph->numVertices;
+  Contraction* c = malloc(sizeof(Contraction));
+  c->numVertices = numVertices;
+  c->lists = calloc(numVertices, sizeof(ArcList));
+  c->contractedNeighbours = calloc(numVertices, sizeof(int));
+  c->depths = calloc(numVertices, sizeof(int));
+  c->distances = malloc(sizeof(int) * numVertices);
+  c->touched = malloc(sizeof(int) * numVertices);
+  c->numTouched = 0;
+  c->targets = calloc(numVertices, sizeof(int));
+  c->round = 0;
+  for (int v = 0; v < numVertices; v++) {
+    c->distances[v] = INT_MAX;
+  }
+  initPriorityQueue(&c->pq, pqOpsFor(PQ_DARY_HEAP), numVertices);
+  for (int v = 0; v < numVertices; v++) {
+    for (AdjList* adjList = graph->vertices[v].adjList; adjList != NULL;
+         adjList = adjList->next) {
+      Edge* edge = adjList->edge;
+      int u = edge->fromVertex == v ? edge->toVertex : edge->fromVertex;
+      if (u != v) joinVertices(c, v, u, edge->weight, NOTHING);
+    }
+  }
+  return c;
+}
+
+/* Frees 'c' except for its arc lists' arrays, which the caller owns. */
+static void deleteContraction(Contraction* c) {
+  free(c->lists);
+  free(c->contractedNeighbours);
+  free(c->depths);
+  free(c->distances);
+  free(c->touched);
+  free(c->targets);
+  freePriorityQueue(&c->pq);
+  free(c);
+}
+
+/*************************************************************************
+ ** Preprocessing
+ *************************************************************************/
+
+/* Returns a newly created contraction hierarchy of Graph 'graph'. Vertices
+ * are contracted in order of twice their edge difference (shortcuts added
+ * minus edges removed), plus their number of contracted neighbours and their
+ * depth in the hierarchy so far; priorities are re-evaluated lazily. A
+ * shortcut is skipped when a witness search, limited to CH_WITNESS_LIMIT
+ * settled vertices (see ch.c), finds a path at least as short that avoids
+ * the contracted vertex. Parallel edges keep the lightest.
+ * Returns NULL if 'graph' is NULL.
+ * Precondition: 'graph' is undirected, i.e. every edge is in the adjacency
+ *               lists of both its endpoints
+ */
+ContractionHierarchy* newContractionHierarchy(Graph* graph) {
+  if (graph == NULL) return NULL;
+  int numVertices = graph->numVertices;
+  Contraction* c = newContraction(graph);
+  ContractionHierarchy* hierarchy = malloc(sizeof(ContractionHierarchy));
+  hierarchy->numVertices = numVertices;
+  hierarchy->rank = malloc(sizeof(int) * numVertices);
+
+  int* ids = malloc(sizeof(int) * (numVertices > 0 ? numVertices : 1));
+  int* priorities = malloc(sizeof(int) * (numVertices > 0 ? numVertices : 1));
+  for (int v = 0; v < numVertices; v++) {
+    ids[v] = v;
+    priorities[v] = contractionPriority(c, v);
+  }
+  MinHeap* order = newHeapFromArrays(numVertices, ids, priorities, numVertices);
+  free(ids);
+  free(priorities);
+  int nextRank = 0;
+  while (order->size > 0) {
+    int v = extractMin(order).id;
+    int priority = contractionPriority(c, v);
+    if (order->size > 0 && priority > getMin(order).priority) {
+      insert(order, priority, v);  // stale priority: try again later
+      continue;
+    }
+    contractVertex(c, v, false);
+    hierarchy->rank[v] = nextRank++;
+    // v's list keeps exactly its upward arcs; unlink v from the rest
+    ArcList* list = &c->lists[v];
+    for (int i = 0; i < list->size; i++) {
+      removeArc(&c->lists[list->arcs[i].target], v);
+      int u = list->arcs[i].target;
+      c->contractedNeighbours[u]++;
+      if (c->depths[u] < c->depths[v] + 1) c->depths[u] = c->depths[v] + 1;
+    }
+  }
+  deleteHeap(order);
+
+  hierarchy->offsets = malloc(sizeof(int) * (numVertices + 1));
+  int numArcs = 0;
+  for (int v = 0; v < numVertices; v++) {
+    hierarchy->offsets[v] = numArcs;
+    numArcs += c->lists[v].size;
+  }
+  hierarchy->offsets[numVertices] = numArcs;
+  hierarchy->numArcs = numArcs;
+  hierarchy->numShortcuts = 0;
+  hierarchy->targets = malloc(sizeof(int) * (numArcs > 0 ? numArcs : 1));
+  hierarchy->weights = malloc(sizeof(int) * (numArcs > 0 ? numArcs : 1));
+  hierarchy->middles = malloc(sizeof(int) * (numArcs > 0 ? numArcs : 1));
+  for (int v = 0; v < numVertices; v++) {
+    ArcList* list = &c->lists[v];
+    for (int i = 0; i < list->size; i++) {
+      int slot = hierarchy->offsets[v] + i;
+      hierarchy->targets[slot] = list->arcs[i].target;
+      hierarchy->weights[slot] = list->arcs[i].weight;
+      hierarchy->middles[slot] = list->arcs[i].middle;
+      if (list->arcs[i].middle != NOTHING) hierarchy->numShortcuts++;
+    }
+    free(list->arcs);
+  }
+  deleteContraction(c);
+  return hierarchy;
+}
+
+/* Frees memory allocated for 'hierarchy'.
+ */
+void deleteContractionHierarchy(ContractionHierarchy* hierarchy) {
+  if (hierarchy == NULL) return;
+  free(hierarchy->rank);
+  free(hierarchy->offsets);
+  free(hierarchy->targets);
+  free(hierarchy->weights);
+  free(hierarchy->middles);
+  free(hierarchy);
+}
+
+/*************************************************************************
+ ** Queries
+ *************************************************************************/
+
+/* Returns newly created scratch space for queries on 'hierarchy'. A CHQuery
+ * is reused from query to query and only resets what the last query
+ * touched; each thread needs its own.
+ */
+CHQuery* newCHQuery(ContractionHierarchy* hierarchy) {
+  int numVertices = hierarchy->numVertices;
+  CHQuery* query = malloc(sizeof(CHQuery));
+  query->hierarchy = hierarchy;
+  for (int side = 0; side < 2; side++) {
+    query->distances[side] = malloc(sizeof(int) * numVertices);
+    query->predecessors[side] = malloc(sizeof(int) * numVertices);
+    query->finished[side] = calloc(numVertices, sizeof(bool));
+    for (int v = 0; v < numVertices; v++) {
+      query->distances[side][v] = INT_MAX;
+    }
+    initPriorityQueue(&query->pq[side], pqOpsFor(PQ_DARY_HEAP), numVertices);
+  }
+  query->touched = malloc(sizeof(int) * numVertices);
+  query->numTouched = 0;
+  return query;
+}
+
+/* Frees memory allocated for 'query'.
+ */
+void deleteCHQuery(CHQuery* query) {
+  if (query == NULL) return;
+  for (int side = 0; side < 2; side++) {
+    free(query->distances[side]);
+    free(query->predecessors[side]);
+    free(query->finished[side]);
+    freePriorityQueue(&query->pq[side]);
+  }
+  free(query->touched);
+  free(query);
+}
+
+/* Resets everything the last search of 'query' touched. */
+static void clearQuery(CHQuery* query) {
+  for (int i = 0; i < query->numTouched; i++) {
+    int v = query->touched[i];
+    for (int side = 0; side < 2; side++) {
+      query->distances[side][v] = INT_MAX;
+      query->finished[side][v] = false;
+    }
+  }
+  query->numTouched = 0;
+  for (int side = 0; side < 2; side++) {
+    while (!pqIsEmpty(&query->pq[side])) pqExtractMin(&query->pq[side]);
+  }
+}
+
+/* Reaches vertex 'v' at distance 'distance' via 'pred' on 'side'. */
+static void reachVertex(CHQuery* query, int side, int v, int distance,
+                        int pred) {
+  if (query->distances[0][v] == INT_MAX && query->distances[1][v] == INT_MAX) {
+    query->touched[query->numTouched++] = v;
+  }
+  PriorityQueue* pq = &query->pq[side];
+  if (query->distances[side][v] == INT_MAX) {
+    pqInsert(pq, distance, v);
+  } else {
+    pqDecreasePriority(pq, v, distance);
+  }
+  query->distances[side][v] = distance;
+  query->predecessors[side][v] = pred;
+}
+
+/* Runs the upward searches from 'startVertex' and 'targetVertex', and
+ * returns the vertex where a shortest path between them peaks, or NOTHING
+ * if there is none. The searches' records stay in 'query' until
+ * clearQuery.
+ */
+static int searchUpward(CHQuery* query, int startVertex, int targetVertex) {
+  ContractionHierarchy* hierarchy = query->hierarchy;
+  reachVertex(query, 0, startVertex, 0, NOTHING);
+  reachVertex(query, 1, targetVertex, 0, NOTHING);
+  // paths of INT_MAX or more count as none, as in dijkstraRelax, so the
+  // sum of the two distances at the peak always fits in an int
+  long best = INT_MAX;
+  int peak = NOTHING;
+  bool active[2] = {true, true};
+  int side = 0;
+  while (active[0] || active[1]) {
+    if (!active[side] || pqIsEmpty(&query->pq[side])) {
+      active[side] = false;
+      side = 1 - side;
+      continue;
+    }
+    HeapNode node = pqExtractMin(&query->pq[side]);
+    if (node.priority >= best) {  // nothing shorter is left on this side
+      active[side] = false;
+      side = 1 - side;
+      continue;
+    }
+    int u = node.id;
+    query->finished[side][u] = true;
+    if (query->finished[1 - side][u]) {
+      long through = (long)node.priority + query->distances[1 - side][u];
+      if (through < best) {
+        best = through;
+        peak = u;
+      }
+    }
+    int end = hierarchy->offsets[u + 1];
+    for (int i = hierarchy->offsets[u]; i < end; i++) {
+      int v = hierarchy->targets[i];
+      long reach = (long)node.priority + hierarchy->weights[i];
+      if (reach < query->distances[side][v] && reach < INT_MAX) {
+        reachVertex(query, side, v, reach, u);
+      }
+    }
+    side = 1 - side;
+  }
+  return peak;
+}
+
+/* Returns the slot of the upward arc joining 'a' and 'b' in 'hierarchy'.
+ * Precondition: the arc exists
+ */
+static int findUpwardArc(ContractionHierarchy* hierarchy, int a, int b) {
+  int lower = hierarchy->rank[a] < hierarchy->rank[b] ? a : b;
+  int upper = lower == a ? b : a;
+  int slot = hierarchy->offsets[lower];
+  while (hierarchy->targets[slot] != upper) slot++;
+  return slot;
+}
+
+/* Appends the edge (fromVertex -- toVertex, weight) to the path from
+ * '*head' to '*tail'.
+ */
+static void appendEdge(AdjList** head, AdjList** tail, int fromVertex,
+                       int toVertex, int weight) {
+  AdjList* node = newAdjList(newEdge(fromVertex, toVertex, weight), NULL);
+  if (*head == NULL) {
+    *head = node;
+  } else {
+    (*tail)->next = node;
+  }
+  *tail = node;
+}
+
+/* Appends to the path from '*head' to '*tail' the edges of the graph that
+ * the upward arc from 'a' to 'b' stands for, in order from 'a' to 'b'.
+ * 'stack' has room for 2 * (numVertices + 1) ints.
+ */
+static void unpackArc(ContractionHierarchy* hierarchy, int a, int b,
+                      int* stack, AdjList** head, AdjList** tail) {
+  int size = 0;
+  stack[size++] = a;
+  stack[size++] = b;
+  while (size > 0) {
+    int to = stack[--size];
+    int from = stack[--size];
+    int slot = findUpwardArc(hierarchy, from, to);
+    int middle = hierarchy->middles[slot];
+    if (middle == NOTHING) {
+      appendEdge(head, tail, from, to, hierarchy->weights[slot]);
+      continue;
+    }
+    // the middle vertex is ranked below both ends, so both halves are
+    // upward arcs of its own; unpack the first half first
+    stack[size++] = middle;
+    stack[size++] = to;
+    stack[size++] = from;
+    stack[size++] = middle;
+  }
+}
+
+/* Returns the unpacked path from the target through 'peak' to the start
+ * found by the last searchUpward of 'query'.
+ */
+static AdjList* tracePath(CHQuery* query, int peak) {
+  ContractionHierarchy* hierarchy = query->hierarchy;
+  // vertices from the target up to the peak and down to the start
+  int* sequence = malloc(sizeof(int) * 2 * (query->numTouched + 1));
+  int length = 0;
+  for (int v = peak; v != NOTHING; v = query->predecessors[1][v]) {
+    sequence[length++] = v;
+  }
+  for (int i = 0; i < length / 2; i++) {
+    int swap = sequence[i];
+    sequence[i] = sequence[length - 1 - i];
+    sequence[length - 1 - i] = swap;
+  }
+  for (int v = query->predecessors[0][peak]; v != NOTHING;
+       v = query->predecessors[0][v]) {
+    sequence[length++] = v;
+  }
+
+  int* stack = malloc(sizeof(int) * 2 * (hierarchy->numVertices + 1));
+  AdjList* head = NULL;
+  AdjList* tail = NULL;
+  for (int i = 0; i + 1 < length; i++) {
+    unpackArc(hierarchy, sequence[i], sequence[i + 1], stack, &head, &tail);
+  }
+  free(stack);
+  free(sequence);
+  return head;
+}
+
+/* Returns the length of a shortest path between vertices with IDs
+ * 'startVertex' and 'targetVertex' of the hierarchy of 'query', or INT_MAX
+ * if there is none or either vertex is not valid.
+ */
+int chGetDistance(CHQuery* query, int startVertex, int targetVertex) {
+  int numVertices = query->hierarchy->numVertices;
+  if (startVertex < 0 || startVertex >= numVertices || targetVertex < 0 ||
+      targetVertex >= numVertices) {
+    return INT_MAX;
+  }
+  int peak = searchUpward(query, startVertex, targetVertex);
+  int distance = INT_MAX;
+  if (peak != NOTHING) {
+    distance = query->distances[0][peak] + query->distances[1][peak];
+  }
+  clearQuery(query);
+  return distance;
+}
+
+/* Like chGetDistance, but also returns the shortest path, with all
+ * shortcuts unpacked into edges of the graph, in the form getShortestPath
+ * returns (see graph_algos.h):
+ *   [(target -- id_1, w_0), (id_1 -- id_2, w_1), ..., (id_n -- start, w_n)]
+ * and sets '*distance' (if 'distance' is not NULL) to its length.
+ * Returns NULL if there is no such path or the two vertices are the same.
+ */
+AdjList* chGetShortestPath(CHQuery* query, int startVertex, int targetVertex,
+                           int* distance) {
+  int ignored;
+  if (distance == NULL) distance = &ignored;
+  *distance = INT_MAX;
+  int numVertices = query->hierarchy->numVertices;
+  if (startVertex < 0 || startVertex >= numVertices || targetVertex < 0 ||
+      targetVertex >= numVertices) {
+    return NULL;
+  }
+  int peak = searchUpward(query, startVertex, targetVertex);
+  AdjList* path = NULL;
+  if (peak != NOTHING) {
+    *distance = query->distances[0][peak] + query->distances[1][peak];
+    path = tracePath(query, peak);
+  }
+  clearQuery(query);
+  return path;
+}
@@ -0,0 +1,99 @@
+/*
+ * Header file for our contraction hierarchies.
+ *
+ * Preprocessing contracts the vertices of an undirected Graph one at a time,
+ * least important first. Contracting v removes it from the remaining graph
+ * and, for every pair of its remaining neighbours u and w whose shortest
+ * path runs through v, adds a shortcut edge u -- w of the same length. The
+ * contraction order is the vertices' rank. Every edge and shortcut is kept
+ * once, at its lower-ranked endpoint, as an upward arc.
+ *
+ * A shortest path then always climbs in rank from both ends to a single
+ * highest vertex. A query therefore runs two small Dijkstra searches, one
+ * from each end, that only follow upward arcs, and shortcuts on the path
+ * they find are unpacked back into original edges.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "graph.h"
+#include "pq.h"
+
+#ifndef __CH_header
+#define __CH_header
+
+typedef struct contraction_hierarchy {
+  int numVertices;   // total number of vertices
+  int numArcs;       // number of upward arcs (edges and shortcuts)
+  int numShortcuts;  // number of upward arcs that are shortcuts
+  int* rank;         // rank[v] is the position of v in the contraction order
+  int* offsets;      // array of numVertices + 1 offsets; v's upward arcs are
+                     //   in slots offsets[v] .. offsets[v + 1] - 1
+  int* targets;      // targets[i] is the higher-ranked end of arc i
+  int* weights;      // weights[i] is the weight of arc i
+  int* middles;      // middles[i] is the vertex shortcut i was added for,
+                     //   or -1 if arc i is an edge of the graph
+} ContractionHierarchy;
+
+typedef struct ch_query {
+  ContractionHierarchy* hierarchy;  // hierarchy being queried
+  int* distances[2];     // distances[side][v] is v's tentative distance from
+                         //   the start (side 0) or the target (side 1),
+                         //   INT_MAX if not reached
+  int* predecessors[2];  // predecessors[side][v] is v's predecessor on side
+  bool* finished[2];     // finished[side][v] is true iff v is settled on side
+  int* touched;          // vertices reached by the current query
+  int numTouched;        // number of vertices in 'touched'
+  PriorityQueue pq[2];   // frontier of each side
+} CHQuery;
+
+/***** Preprocessing ********************************************************/
+
+/* Returns a newly created contraction hierarchy of Graph 'graph'. Vertices
+ * are contracted in order of twice their edge difference (shortcuts added
+ * minus edges removed), plus their number of contracted neighbours and their
+ * depth in the hierarchy so far; priorities are re-evaluated lazily. A
+ * shortcut is skipped when a witness search, limited to CH_WITNESS_LIMIT
+ * settled vertices (see ch.c), finds a path at least as short that avoids
+ * the contracted vertex. Parallel edges keep the lightest.
+ * Returns NULL if 'graph' is NULL.
+ * Precondition: 'graph' is undirected, i.e. every edge is in the adjacency
+ *               lists of both its endpoints
+ */
+ContractionHierarchy* newContractionHierarchy(Graph* graph);
+
+/* Frees memory allocated for 'hierarchy'.
+ */
+void deleteContractionHierarchy(ContractionHierarchy* hierarchy);
+
+/***** Queries **************************************************************/
+
+/* Returns newly created scratch space for queries on 'hierarchy'. A CHQuery
+ * is reused from query to query and only resets what the last query
+ * touched; each thread needs its own.
+ */
+CHQuery* newCHQuery(ContractionHierarchy* hierarchy);
+
+/* Frees memory allocated for 'query'.
+ */
+void deleteCHQuery(CHQuery* query);
+
+/* Returns the length of a shortest path between vertices with IDs
+ * 'startVertex' and 'targetVertex' of the hierarchy of 'query', or INT_MAX
+ * if there is none or either vertex is not valid.
+ */
+int chGetDistance(CHQuery* query, int startVertex, int targetVertex);
+
+/* Like chGetDistance, but also returns the shortest path, with all
+ * shortcuts unpacked into edges of the graph, in the form getShortestPath
+ * returns (see graph_algos.h):
+ *   [(target -- id_1, w_0), (id_1 -- id_2, w_1), ..., (id_n -- start, w_n)]
+ * and sets '*distance' (if 'distance' is not NULL) to its length.
+ * Returns NULL if there is no such path or the two vertices are the same.
+ */
+AdjList* chGetShortestPath(CHQuery* query, int startVertex, int targetVertex,
+                           int* distance);
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ * Our compressed sparse row (CSR) graph implementation.
+ */
+
+#include "csr.h"
+
+#include <sys/mman.h>
+
+/* Returns a newly created CSRGraph with space for 'numVertices' vertices and
+ * 'numEdges' adjacency slots. All offsets are 0.
+ * Precondition: numVertices >= 0, numEdges >= 0
+ */
+CSRGraph* newCSRGraph(int numVertices, int numEdges) {
+  CSRGraph* new = malloc(sizeof(CSRGraph));
+  new->numVertices = numVertices;
+  new->numEdges = numEdges;
+  new->offsets = calloc(numVertices + 1, sizeof(int));
+  new->targets = malloc(sizeof(int) * (numEdges > 0 ? numEdges : 1));
+  new->weights = malloc(sizeof(int) * (numEdges > 0 ? numEdges : 1));
+  new->mapping = NULL;
+  new->mappingSize = 0;
+  return new;
+}
+
+/* Returns a newly created CSRGraph with the same vertices and adjacency lists
+ * as 'graph'. Each vertex's neighbours are stored in the order they appear in
+ * its AdjList, so algorithms visit them in the same order on both.
+ * Returns NULL if 'graph' is NULL.
+ */
+CSRGraph* csrFromGraph(Graph* graph) {
+  if (graph == NULL) return NULL;
+
+  int numVertices = graph->numVertices;
+  int numEdges = 0;
+  AdjList* adjList;
+  for (int i = 0; i < numVertices; i++) {
+    for (adjList = graph->vertices[i].adjList; adjList != NULL;
+         adjList = adjList->next) {
+      numEdges++;
+    }
+  }
+
+  CSRGraph* csr = newCSRGraph(numVertices, numEdges);
+  int slot = 0;
+  for (int i = 0; i < numVertices; i++) {
+    csr->offsets[i] = slot;
+    for (adjList = graph->vertices[i].adjList; adjList != NULL;
+         adjList = adjList->next) {
+      if (adjList->edge->fromVertex == i) {
+        csr->targets[slot] = adjList->edge->toVertex;
+      } else {
+        csr->targets[slot] = adjList->edge->fromVertex;
+      }
+      csr->weights[slot] = adjList->edge->weight;
+      slot++;
+    }
+  }
+  csr->offsets[numVertices] = slot;
+  return csr;
+}
+
+/* Returns a newly created CSRGraph on 'numVertices' vertices built from the
+ * array 'edges' of 'numEdges' directed edges. Edge (u -- v, w) is stored in
+ * u's adjacency; edges sharing a "from" vertex keep their relative order.
+ * Returns NULL if some edge has an endpoint outside 0 .. numVertices-1.
+ */
+CSRGraph* csrFromEdges(int numVertices, int numEdges, Edge* edges) {
+  for (int i = 0; i < numEdges; i++) {
+    if (edges[i].fromVertex < 0 || edges[i].fromVertex >= numVertices ||
+        edges[i].toVertex < 0 || edges[i].toVertex >= numVertices) {
+      return NULL;
+    }
+  }
+
+  CSRGraph* csr = newCSRGraph(numVertices, numEdges);
+  // counting sort on fromVertex: count, prefix-sum, then place in order
+  for (int i = 0; i < numEdges; i++) {
+    csr->offsets[edges[i].fromVertex + 1]++;
+  }
+  for (int v = 0; v < numVertices; v++) {
+    csr->offsets[v + 1] += csr->offsets[v];
+  }
+  int* cursor = malloc(sizeof(int) * (numVertices > 0 ? numVertices : 1));
+  for (int v = 0; v < numVertices; v++) {
+    cursor[v] = csr->offsets[v];
+  }
+  for (int i = 0; i < numEdges; i++) {
+    int slot = cursor[edges[i].fromVertex]++;
+    csr->targets[slot] = edges[i].toVertex;
+    csr->weights[slot] = edges[i].weight;
+  }
+  free(cursor);
+  return csr;
+}
+
+/* Frees memory allocated for 'graph'.
+ */
+void deleteCSRGraph(CSRGraph* graph) {
+  if (graph == NULL) return;
+  if (graph->mapping != NULL) {
+    munmap(graph->mapping, graph->mappingSize);
+  } else {
+    free(graph->offsets);
+    free(graph->targets);
+    free(graph->weights);
+  }
+  free(graph);
+}
+
+/* Prints CSRGraph 'graph' in the same format printGraph uses for a Graph. */
+void printCSRGraph(CSRGraph* graph) {
+  if (graph == NULL) return;
+
+  printf("Number of vertices: %d. Number of edges: %d.\n\n", graph->numVertices,
+         graph->numEdges);
+
+  for (int v = 0; v < graph->numVertices; v++) {
+    printf("%d: ", v);
+    for (int i = graph->offsets[v]; i < graph->offsets[v + 1]; i++) {
+      printf("(%d -- %d, %d)  ", v, graph->targets[i], graph->weights[i]);
+    }
+    printf("\n");
+  }
+  printf("\n");
+}
@@ -0,0 +1,63 @@
+/*
+ * Header file for our compressed sparse row (CSR) graph representation.
+ *
+ * A CSRGraph is a frozen copy of a Graph: the adjacency list of vertex v
+ * occupies slots offsets[v] .. offsets[v + 1] - 1 of the contiguous 'targets'
+ * and 'weights' arrays, so walking a vertex's neighbours is a sequential scan
+ * instead of a chain of AdjList/Edge pointers.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "graph.h"
+
+#ifndef __CSR_header
+#define __CSR_header
+
+typedef struct csr_graph {
+  int numVertices;     // total number of vertices
+  int numEdges;        // total number of adjacency slots (directed edges)
+  int* offsets;        // array of numVertices + 1 offsets into targets and
+                       //   weights; v's neighbours are in slots
+                       //   offsets[v] .. offsets[v + 1] - 1
+  int* targets;        // targets[i] is the neighbour stored in slot i
+  int* weights;        // weights[i] is the weight of the edge in slot i
+  void* mapping;       // memory map holding the arrays (see snapshot.h), or
+                       //   NULL if they are malloc'd
+  size_t mappingSize;  // length of 'mapping' in bytes
+} CSRGraph;
+
+/***** Construction *********************************************************/
+
+/* Returns a newly created CSRGraph with space for 'numVertices' vertices and
+ * 'numEdges' adjacency slots. All offsets are 0.
+ * Precondition: numVertices >= 0, numEdges >= 0
+ */
+CSRGraph* newCSRGraph(int numVertices, int numEdges);
+
+/* Returns a newly created CSRGraph with the same vertices and adjacency lists
+ * as 'graph'. Each vertex's neighbours are stored in the order they appear in
+ * its AdjList, so algorithms visit them in the same order on both.
+ * Returns NULL if 'graph' is NULL.
+ */
+CSRGraph* csrFromGraph(Graph* graph);
+
+/* Returns a newly created CSRGraph on 'numVertices' vertices built from the
+ * array 'edges' of 'numEdges' directed edges. Edge (u -- v, w) is stored in
+ * u's adjacency; edges sharing a "from" vertex keep their relative order.
+ * Returns NULL if some edge has an endpoint outside 0 .. numVertices-1.
+ */
+CSRGraph* csrFromEdges(int numVertices, int numEdges, Edge* edges);
+
+/* Frees memory allocated for 'graph'.
+ */
+void deleteCSRGraph(CSRGraph* graph);
+
+/***** Displaying ***********************************************************/
+
+/* Prints CSRGraph 'graph' in the same format printGraph uses for a Graph. */
+void printCSRGraph(CSRGraph* graph);
+
+#endif
@@ -0,0 +1,205 @@
+/*
+ * Our d-ary min-heap implementation.
+ */
+
+#include "dheap.h"
+
+#include <stdint.h>
+
+#include "stats.h"
+
+#define NOTHING -1
+#define CACHE_LINE 64
+
+/* Moves the hole at index 'nodeIndex' of heap 'heap' up until node
+ * ('priority', 'id') can be placed there without breaking the heap
+ * property, then places it.
+ */
+static void siftUp(DaryHeap* heap, int nodeIndex, int priority, int id) {
+  int* priorities = heap->priorities;
+  int* ids = heap->ids;
+  int arity = heap->arity;
+  int depth = 0;
+  while (nodeIndex > 0) {
+    int parent = (nodeIndex - 1) / arity;
+    if (priorities[parent] <= priority) break;
+    priorities[nodeIndex] = priorities[parent];
+    ids[nodeIndex] = ids[parent];
+    heap->indexMap[ids[nodeIndex]] = nodeIndex;
+    nodeIndex = parent;
+    depth++;
+  }
+  STATS_SIFT(depth);
+  priorities[nodeIndex] = priority;
+  ids[nodeIndex] = id;
+  heap->indexMap[id] = nodeIndex;
+}
+
+/* Moves the hole at index 'nodeIndex' of heap 'heap' down until node
+ * ('priority', 'id') can be placed there without breaking the heap
+ * property, then places it.
+ */
+static void siftDown(DaryHeap* heap, int nodeIndex, int priority, int id) {
+  int* priorities = heap->priorities;
+  int* ids = heap->ids;
+  int arity = heap->arity;
+  int size = heap->size;
+  int depth = 0;
+  while (1) {
+    int first = arity * nodeIndex + 1;
+    if (first >= size) break;
+    int last = first + arity < size ? first + arity : size;
+    int minIdx = first;
+    for (int child = first + 1; child < last; child++) {
+      if (priorities[child] < priorities[minIdx]) minIdx = child;
+    }
+    if (priorities[minIdx] >= priority) break;
+    priorities[nodeIndex] = priorities[minIdx];
+    ids[nodeIndex] = ids[minIdx];
+    heap->indexMap[ids[nodeIndex]] = nodeIndex;
+    nodeIndex = minIdx;
+    depth++;
+  }
+  STATS_SIFT(depth);
+  priorities[nodeIndex] = priority;
+  ids[nodeIndex] = id;
+  heap->indexMap[id] = nodeIndex;
+}
+
+/* Returns the node with minimum priority in heap 'heap'.
+ * Precondition: heap is non-empty
+ */
+HeapNode daryGetMin(DaryHeap* heap) {
+  HeapNode min = {heap->priorities[0], heap->ids[0]};
+  return min;
+}
+
+/* Removes and returns the node with minimum priority in heap 'heap'.
+ * Precondition: heap is non-empty
+ */
+HeapNode daryExtractMin(DaryHeap* heap) {
+  HeapNode min = daryGetMin(heap);
+  heap->indexMap[min.id] = NOTHING;
+  heap->size--;
+  int size = heap->size;
+  if (size > 0) {
+    siftDown(heap, 0, heap->priorities[size], heap->ids[size]);
+  }
+  return min;
+}
+
+/* Inserts a new node with priority 'priority' and ID 'id' into heap 'heap'.
+ * Precondition: 'id' is unique within this heap
+ *               0 <= 'id' < heap->capacity
+ *               heap->size < heap->capacity
+ */
+void daryInsert(DaryHeap* heap, int priority, int id) {
+  heap->size++;
+  siftUp(heap, heap->size - 1, priority, id);
+}
+
+/* Returns priority of the node with ID 'id' in 'heap', or -1 if there is no
+ * such node.
+ * Precondition: 0 <= 'id' < heap->capacity
+ */
+int daryGetPriority(DaryHeap* heap, int id) {
+  int index = heap->indexMap[id];
+  if (index == NOTHING) {
+    return NOTHING;
+  }
+  return heap->priorities[index];
+}
+
+/* Returns true iff a node with ID 'id' is in 'heap'. */
+bool daryContains(DaryHeap* heap, int id) {
+  return 0 <= id && id < heap->capacity && heap->indexMap[id] != NOTHING;
+}
+
+/* Sets priority of node with ID 'id' in heap 'heap' to 'newPriority', if
+ * such a node exists in 'heap' and its priority is larger than
+ * 'newPriority', and returns True. Has no effect and returns False, otherwise.
+ */
+bool daryDecreasePriority(DaryHeap* heap, int id, int newPriority) {
+  if (!daryContains(heap, id)) {
+    return false;
+  }
+  int index = heap->indexMap[id];
+  if (heap->priorities[index] <= newPriority) {
+    return false;
+  }
+  siftUp(heap, index, newPriority, id);
+  return true;
+}
+
+/* Returns a newly created empty heap with initial capacity 'capacity' in
+ * which every node has 'arity' children.
+ * Precondition: capacity >= 0, arity >= 2
+ */
+DaryHeap* newDaryHeap(int capacity, int arity) {
+  DaryHeap* new = malloc(sizeof(DaryHeap));
+  new->size = 0;
+  new->capacity = capacity;
+  new->arity = arity;
+  // children of index i start at arity * i + 1; shifting the array by
+  // arity - 1 slots makes every sibling group start on a multiple of arity
+  size_t bytes = sizeof(int) * ((size_t)capacity + arity) + CACHE_LINE;
+  new->block = malloc(bytes);
+  uintptr_t aligned =
+      ((uintptr_t)new->block + CACHE_LINE - 1) & ~(uintptr_t)(CACHE_LINE - 1);
+  new->priorities = (int*)aligned + (arity - 1);
+  new->ids = malloc(sizeof(int) * (capacity > 0 ? capacity : 1));
+  new->indexMap = malloc(sizeof(int) * (capacity > 0 ? capacity : 1));
+  for (int i = 0; i < capacity; i++) {
+    new->indexMap[i] = NOTHING;
+  }
+  return new;
+}
+
+/* Returns a newly created heap with capacity 'capacity', in which every
+ * node has 'arity' children, holding the 'count' nodes with IDs ids[i] and
+ * priorities priorities[i]. The array is filled in order and then
+ * heapified bottom-up in O(count) time. Nodes that are already in heap
+ * order stay where they are.
+ * Precondition: 0 <= count <= capacity, arity >= 2
+ *               the IDs are unique and 0 <= ids[i] < capacity
+ */
+DaryHeap* newDaryHeapFromArrays(int capacity, int arity, int* ids,
+                                int* priorities, int count) {
+  DaryHeap* heap = newDaryHeap(capacity, arity);
+  for (int i = 0; i < count; i++) {
+    heap->priorities[i] = priorities[i];
+    heap->ids[i] = ids[i];
+    heap->indexMap[ids[i]] = i;
+  }
+  heap->size = count;
+  for (int i = (count - 2) / arity; count > 1 && i >= 0; i--) {
+    siftDown(heap, i, heap->priorities[i], heap->ids[i]);
+  }
+  return heap;
+}
+
+/* Frees all memory allocated for heap 'heap'.
+ */
+void deleteDaryHeap(DaryHeap* heap) {
+  free(heap->block);
+  free(heap->ids);
+  free(heap->indexMap);
+  free(heap);
+}
+
+/* Prints the contents of this heap, in the same format as printHeap. */
+void printDaryHeap(DaryHeap* heap) {
+  printf("%d-ary MinHeap with size: %d\n\tcapacity: %d\n\n", heap->arity,
+         heap->size, heap->capacity);
+  printf("index: priority [ID]\t ID: index\n");
+  for (int i = 0; i < heap->capacity; i++) {
+    if (i < heap->size) {
+      printf("%d: %d [%d]\t\t%d: %d\n", i, heap->priorities[i], heap->ids[i],
+             i, heap->indexMap[i]);
+    } else {
+      printf("%d: %d [%d]\t\t%d: %d\n", i, NOTHING, NOTHING, i,
+             heap->indexMap[i]);
+    }
+  }
+  printf("\n\n");
+}
@@ -0,0 +1,87 @@
+/*
+ * Header file for our d-ary Priority Queue implementation.
+ *
+ * A DaryHeap offers the same contract as MinHeap, but every node has 'arity'
+ * children and the heap keeps priorities and IDs in two separate arrays. The
+ * priorities array is laid out so that all children of a node start on a
+ * multiple of 'arity' elements, which puts a 4-ary or 8-ary sibling group
+ * within a single cache line. Nodes move by shifting a hole rather than by
+ * pairwise swaps, so indexMap is written once per level.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "minheap.h"
+
+#ifndef __DaryHeap_header
+#define __DaryHeap_header
+
+typedef struct dary_heap {
+  int size;         // the number of nodes in this heap; 0 <= size <= capacity
+  int capacity;     // the number of nodes that can be stored in this heap
+  int arity;        // the number of children of each node; arity >= 2
+  int* priorities;  // priorities[i] is the priority of the node at index i
+  int* ids;         // ids[i] is the ID of the node at index i
+  int* indexMap;    // indexMap[id] is the index of node with ID id, or -1
+  void* block;      // allocation backing 'priorities'
+} DaryHeap;
+
+/* Returns the node with minimum priority in heap 'heap'.
+ * Precondition: heap is non-empty
+ */
+HeapNode daryGetMin(DaryHeap* heap);
+
+/* Removes and returns the node with minimum priority in heap 'heap'.
+ * Precondition: heap is non-empty
+ */
+HeapNode daryExtractMin(DaryHeap* heap);
+
+/* Inserts a new node with priority 'priority' and ID 'id' into heap 'heap'.
+ * Precondition: 'id' is unique within this heap
+ *               0 <= 'id' < heap->capacity
+ *               heap->size < heap->capacity
+ */
+void daryInsert(DaryHeap* heap, int priority, int id);
+
+/* Returns priority of the node with ID 'id' in 'heap', or -1 if there is no
+ * such node.
+ * Precondition: 0 <= 'id' < heap->capacity
+ */
+int daryGetPriority(DaryHeap* heap, int id);
+
+/* Returns true iff a node with ID 'id' is in 'heap'. */
+bool daryContains(DaryHeap* heap, int id);
+
+/* Sets priority of node with ID 'id' in heap 'heap' to 'newPriority', if
+ * such a node exists in 'heap' and its priority is larger than
+ * 'newPriority', and returns True. Has no effect and returns False, otherwise.
+ */
+bool daryDecreasePriority(DaryHeap* heap, int id, int newPriority);
+
+/* Prints the contents of this heap, in the same format as printHeap. */
+void printDaryHeap(DaryHeap* heap);
+
+/* Returns a newly created empty heap with initial capacity 'capacity' in
+ * which every node has 'arity' children.
+ * Precondition: capacity >= 0, arity >= 2
+ */
+DaryHeap* newDaryHeap(int capacity, int arity);
+
+/* Returns a newly created heap with capacity 'capacity', in which every
+ * node has 'arity' children, holding the 'count' nodes with IDs ids[i] and
+ * priorities priorities[i]. The array is filled in order and then
+ * heapified bottom-up in O(count) time. Nodes that are already in heap
+ * order stay where they are.
+ * Precondition: 0 <= count <= capacity, arity >= 2
+ *               the IDs are unique and 0 <= ids[i] < capacity
+ */
+DaryHeap* newDaryHeapFromArrays(int capacity, int arity, int* ids,
+                                int* priorities, int count);
+
+/* Frees all memory allocated for heap 'heap'.
+ */
+void deleteDaryHeap(DaryHeap* heap);
+
+#endif
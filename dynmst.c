@@ -0,0 +1,385 @@
+/*
+ * Our dynamic minimum spanning forest.
+ */
+
+#include "dynmst.h"
+
+#include <limits.h>
+
+#include "graph_algos.h"
+#include "unionfind.h"
+
+#define NOTHING -1
+
+// hash table markers; real keys are never negative
+#define EMPTY_KEY -1
+#define TOMBSTONE_KEY -2
+
+/*************************************************************************
+ ** Edge slots and the vertex pair hash table
+ *************************************************************************/
+
+/* Returns the hash table key of the vertex pair 'u', 'v'. */
+static int64_t pairKey(int u, int v) {
+  if (u > v) {
+    int t = u;
+    u = v;
+    v = t;
+  }
+  return (int64_t)u << 32 | (uint32_t)v;
+}
+
+/* Returns the first hash table index to probe for 'key' in a table of
+ * 'tableSize' entries, a power of two.
+ */
+static int firstProbe(int64_t key, int tableSize) {
+  return (int)(((uint64_t)key * 0x9e3779b97f4a7c15ull) >> 32) &
+         (tableSize - 1);
+}
+
+/* Returns the edge slot joining 'u' and 'v' in 'dynamic', or NOTHING. */
+static int findEdge(DynamicMST* dynamic, int u, int v) {
+  int64_t key = pairKey(u, v);
+  int mask = dynamic->tableSize - 1;
+  for (int i = firstProbe(key, dynamic->tableSize);; i = (i + 1) & mask) {
+    if (dynamic->keys[i] == key) return dynamic->slots[i];
+    if (dynamic->keys[i] == EMPTY_KEY) return NOTHING;
+  }
+}
+
+/* Rebuilds the hash table of 'dynamic' with 'tableSize' entries, dropping
+ * tombstones.
+ */
+static void rebuildTable(DynamicMST* dynamic, int tableSize) {
+  int64_t* keys = dynamic->keys;
+  int* slots = dynamic->slots;
+  int oldSize = dynamic->tableSize;
+  dynamic->keys = malloc(sizeof(int64_t) * tableSize);
+  dynamic->slots = malloc(sizeof(int) * tableSize);
+  dynamic->tableSize = tableSize;
+  dynamic->tableUsed = 0;
+  for (int i = 0; i < tableSize; i++) {
+    dynamic->keys[i] = EMPTY_KEY;
+  }
+  for (int i = 0; i < oldSize; i++) {
+    if (keys[i] < 0) continue;
+    int j = firstProbe(keys[i], tableSize);
+    while (dynamic->keys[j] != EMPTY_KEY) j = (j + 1) & (tableSize - 1);
+    dynamic->keys[j] = keys[i];
+    dynamic->slots[j] = slots[i];
+    dynamic->tableUsed++;
+  }
+  free(keys);
+  free(slots);
+}
+
+/* Records in the hash table of 'dynamic' that edge slot 'e' joins 'u' and
+ * 'v'.
+ * Precondition: no edge joins 'u' and 'v' yet
+ */
+static void addToTable(DynamicMST* dynamic, int u, int v, int e) {
+  // keep the table at most half full, counting tombstones
+  if (2 * (dynamic->tableUsed + 1) > dynamic->tableSize) {
+    int tableSize = dynamic->tableSize;
+    while (4 * (dynamic->numEdges + 1) > tableSize) tableSize *= 2;
+    rebuildTable(dynamic, tableSize);
+  }
+  int64_t key = pairKey(u, v);
+  int mask = dynamic->tableSize - 1;
+  int i = firstProbe(key, dynamic->tableSize);
+  while (dynamic->keys[i] != EMPTY_KEY) i = (i + 1) & mask;
+  dynamic->keys[i] = key;
+  dynamic->slots[i] = e;
+  dynamic->tableUsed++;
+}
+
+/* Removes the pair 'u', 'v' from the hash table of 'dynamic'.
+ * Precondition: the pair is in the table
+ */
+static void removeFromTable(DynamicMST* dynamic, int u, int v) {
+  int64_t key = pairKey(u, v);
+  int mask = dynamic->tableSize - 1;
+  int i = firstProbe(key, dynamic->tableSize);
+  while (dynamic->keys[i] != key) i = (i + 1) & mask;
+  dynamic->keys[i] = TOMBSTONE_KEY;
+}
+
+/* Returns the LinkCutTree node of edge slot 'e' of 'dynamic'. */
+static int edgeNode(DynamicMST* dynamic, int e) {
+  return dynamic->numVertices + e;
+}
+
+/* Stores the edge (u -- v, weight) in a free slot of 'dynamic', which it
+ * returns. The edge is not in the forest.
+ */
+static int addEdgeSlot(DynamicMST* dynamic, int u, int v, int weight) {
+  if (dynamic->freeSlot == NOTHING) {
+    int capacity = dynamic->edgeCapacity > 0 ? 2 * dynamic->edgeCapacity : 16;
+    dynamic->edges = realloc(dynamic->edges, sizeof(Edge) * capacity);
+    dynamic->inTree = realloc(dynamic->inTree, sizeof(bool) * capacity);
+    for (int e = capacity - 1; e >= dynamic->edgeCapacity; e--) {
+      dynamic->edges[e] = (Edge){NOTHING, dynamic->freeSlot, 0};
+      dynamic->inTree[e] = false;
+      dynamic->freeSlot = e;
+    }
+    dynamic->edgeCapacity = capacity;
+    lctGrow(dynamic->forest, dynamic->numVertices + capacity);
+  }
+  int e = dynamic->freeSlot;
+  dynamic->freeSlot = dynamic->edges[e].toVertex;
+  dynamic->edges[e] = (Edge){u, v, weight};
+  addToTable(dynamic, u, v, e);
+  dynamic->numEdges++;
+  return e;
+}
+
+/* Frees edge slot 'e' of 'dynamic'.
+ * Precondition: edge 'e' is not in the forest
+ */
+static void freeEdgeSlot(DynamicMST* dynamic, int e) {
+  removeFromTable(dynamic, dynamic->edges[e].fromVertex,
+                  dynamic->edges[e].toVertex);
+  dynamic->edges[e] = (Edge){NOTHING, dynamic->freeSlot, 0};
+  dynamic->freeSlot = e;
+  dynamic->numEdges--;
+}
+
+/*************************************************************************
+ ** The forest
+ *************************************************************************/
+
+/* Adds edge slot 'e' of 'dynamic' to the forest.
+ * Precondition: its endpoints are not connected
+ */
+static void linkEdge(DynamicMST* dynamic, int e) {
+  Edge edge = dynamic->edges[e];
+  int node = edgeNode(dynamic, e);
+  lctSetValue(dynamic->forest, node, edge.weight);
+  lctLink(dynamic->forest, edge.fromVertex, node);
+  lctLink(dynamic->forest, node, edge.toVertex);
+  dynamic->inTree[e] = true;
+  dynamic->numTreeEdges++;
+  dynamic->weight += edge.weight;
+}
+
+/* Removes edge slot 'e' of 'dynamic' from the forest.
+ * Precondition: edge 'e' is in the forest
+ */
+static void cutEdge(DynamicMST* dynamic, int e) {
+  Edge edge = dynamic->edges[e];
+  int node = edgeNode(dynamic, e);
+  lctCut(dynamic->forest, edge.fromVertex, node);
+  lctCut(dynamic->forest, node, edge.toVertex);
+  dynamic->inTree[e] = false;
+  dynamic->numTreeEdges--;
+  dynamic->weight -= edge.weight;
+}
+
+/* Puts edge slot 'e' of 'dynamic', which is not in the forest, into the
+ * forest if it joins two trees, or in place of the heaviest edge on the
+ * tree path it closes if that edge is heavier.
+ */
+static void offerEdge(DynamicMST* dynamic, int e) {
+  Edge edge = dynamic->edges[e];
+  if (!lctConnected(dynamic->forest, edge.fromVertex, edge.toVertex)) {
+    linkEdge(dynamic, e);
+    return;
+  }
+  int heaviest =
+      lctPathMax(dynamic->forest, edge.fromVertex, edge.toVertex) -
+      dynamic->numVertices;
+  if (dynamic->edges[heaviest].weight > edge.weight) {
+    cutEdge(dynamic, heaviest);
+    linkEdge(dynamic, e);
+  }
+}
+
+/* Reconnects the trees of 'a' and 'b' in 'dynamic', just split by removing
+ * an edge between them, with the lightest edge of the graph that joins
+ * them, if there is one. Scans every edge not in the forest.
+ */
+static void replaceEdge(DynamicMST* dynamic, int a, int b) {
+  LinkCutTree* forest = dynamic->forest;
+  // nothing below moves the roots, so they identify the two trees
+  int rootA = lctFindRoot(forest, a);
+  int rootB = lctFindRoot(forest, b);
+  int best = NOTHING;
+  for (int e = 0; e < dynamic->edgeCapacity; e++) {
+    Edge edge = dynamic->edges[e];
+    if (edge.fromVertex == NOTHING || dynamic->inTree[e]) continue;
+    // cheap test first: only lighter edges are worth the tree queries
+    if (best != NOTHING && edge.weight >= dynamic->edges[best].weight) {
+      continue;
+    }
+    int rootX = lctFindRoot(forest, edge.fromVertex);
+    if (rootX != rootA && rootX != rootB) continue;
+    int rootY = lctFindRoot(forest, edge.toVertex);
+    if (rootY == (rootX == rootA ? rootB : rootA)) best = e;
+  }
+  if (best != NOTHING) linkEdge(dynamic, best);
+}
+
+/*************************************************************************
+ ** Construction
+ *************************************************************************/
+
+/* Returns a newly created DynamicMST of Graph 'graph' whose forest starts
+ * as 'mst', the result of primGetMST on 'graph' (placeholder edges to -1,
+ * which primGetMST leaves for unreached vertices, are skipped). If 'mst' is
+ * NULL, primGetMST is run from vertex 0. The graph's edges are copied, so
+ * 'graph' may change or be deleted afterwards. Parallel edges keep the
+ * lightest.
+ * Returns NULL if 'graph' is NULL.
+ * Precondition: 'graph' is undirected, i.e. every edge is in the adjacency
+ *               lists of both its endpoints
+ */
+DynamicMST* newDynamicMST(Graph* graph, Edge* mst) {
+  if (graph == NULL) return NULL;
+  int numVertices = graph->numVertices;
+  DynamicMST* dynamic = calloc(1, sizeof(DynamicMST));
+  dynamic->numVertices = numVertices;
+  dynamic->freeSlot = NOTHING;
+  dynamic->forest = newLinkCutTree(numVertices);
+  rebuildTable(dynamic, 16);
+
+  for (int v = 0; v < numVertices; v++) {
+    for (AdjList* adjList = graph->vertices[v].adjList; adjList != NULL;
+         adjList = adjList->next) {
+      Edge* edge = adjList->edge;
+      int u = edge->fromVertex == v ? edge->toVertex : edge->fromVertex;
+      if (u == v || u < 0 || u >= numVertices) continue;
+      int e = findEdge(dynamic, u, v);
+      if (e == NOTHING) {
+        addEdgeSlot(dynamic, v, u, edge->weight);
+      } else if (edge->weight < dynamic->edges[e].weight) {
+        dynamic->edges[e].weight = edge->weight;
+      }
+    }
+  }
+
+  Edge* seed = mst;
+  if (seed == NULL && numVertices > 0) seed = primGetMST(graph, 0);
+  UnionFind* trees = newUnionFind(numVertices);
+  for (int i = 0; seed != NULL && i < numVertices - 1; i++) {
+    int u = seed[i].fromVertex;
+    int v = seed[i].toVertex;
+    if (u < 0 || u >= numVertices || v < 0 || v >= numVertices) continue;
+    int e = findEdge(dynamic, u, v);
+    if (e != NOTHING && ufUnion(trees, u, v)) linkEdge(dynamic, e);
+  }
+  if (seed != mst) free(seed);
+  // edges between the seed's trees, e.g. in components primGetMST never
+  // reached, still have to be considered
+  for (int e = 0; e < dynamic->edgeCapacity; e++) {
+    Edge edge = dynamic->edges[e];
+    if (edge.fromVertex == NOTHING || dynamic->inTree[e]) continue;
+    if (!ufConnected(trees, edge.fromVertex, edge.toVertex)) {
+      offerEdge(dynamic, e);
+    }
+  }
+  deleteUnionFind(trees);
+  return dynamic;
+}
+
+/* Frees memory allocated for 'dynamic'.
+ */
+void deleteDynamicMST(DynamicMST* dynamic) {
+  if (dynamic == NULL) return;
+  free(dynamic->edges);
+  free(dynamic->inTree);
+  free(dynamic->keys);
+  free(dynamic->slots);
+  deleteLinkCutTree(dynamic->forest);
+  free(dynamic);
+}
+
+/*************************************************************************
+ ** Updates
+ *************************************************************************/
+
+/* Adds the edge (u -- v, weight) to the graph of 'dynamic' and updates the
+ * forest. If u and v are already joined, this sets the edge's weight.
+ * Returns false, changing nothing, if u or v is not a valid vertex or
+ * u == v.
+ */
+bool dmstInsertEdge(DynamicMST* dynamic, int u, int v, int weight) {
+  if (u < 0 || u >= dynamic->numVertices || v < 0 ||
+      v >= dynamic->numVertices || u == v) {
+    return false;
+  }
+  if (findEdge(dynamic, u, v) != NOTHING) {
+    return dmstSetWeight(dynamic, u, v, weight);
+  }
+  offerEdge(dynamic, addEdgeSlot(dynamic, u, v, weight));
+  return true;
+}
+
+/* Sets the weight of the edge between 'u' and 'v' in the graph of
+ * 'dynamic' to 'weight' and updates the forest.
+ * Returns false if there is no such edge.
+ */
+bool dmstSetWeight(DynamicMST* dynamic, int u, int v, int weight) {
+  if (u < 0 || u >= dynamic->numVertices || v < 0 ||
+      v >= dynamic->numVertices) {
+    return false;
+  }
+  int e = findEdge(dynamic, u, v);
+  if (e == NOTHING) return false;
+  int old = dynamic->edges[e].weight;
+  if (!dynamic->inTree[e]) {
+    dynamic->edges[e].weight = weight;
+    if (weight < old) offerEdge(dynamic, e);
+  } else if (weight <= old) {
+    // a lighter tree edge stays in the tree
+    dynamic->edges[e].weight = weight;
+    dynamic->weight += weight - old;
+    lctSetValue(dynamic->forest, edgeNode(dynamic, e), weight);
+  } else {
+    // a heavier one may be replaced: cut it and pick the lightest edge
+    // across the cut, which may be the edge itself
+    cutEdge(dynamic, e);
+    dynamic->edges[e].weight = weight;
+    replaceEdge(dynamic, u, v);
+  }
+  return true;
+}
+
+/* Removes the edge between 'u' and 'v' from the graph of 'dynamic' and
+ * updates the forest.
+ * Returns false if there is no such edge.
+ */
+bool dmstDeleteEdge(DynamicMST* dynamic, int u, int v) {
+  if (u < 0 || u >= dynamic->numVertices || v < 0 ||
+      v >= dynamic->numVertices) {
+    return false;
+  }
+  int e = findEdge(dynamic, u, v);
+  if (e == NOTHING) return false;
+  if (!dynamic->inTree[e]) {
+    freeEdgeSlot(dynamic, e);
+    return true;
+  }
+  cutEdge(dynamic, e);
+  freeEdgeSlot(dynamic, e);
+  replaceEdge(dynamic, u, v);
+  return true;
+}
+
+/*************************************************************************
+ ** Results
+ *************************************************************************/
+
+/* Returns a newly created array of the dynamic->numTreeEdges edges of the
+ * current forest. For a connected graph these are numVertices - 1 edges
+ * of the same total weight as primGetMST's.
+ */
+Edge* dmstGetMST(DynamicMST* dynamic) {
+  Edge* result =
+      malloc(sizeof(Edge) * (dynamic->numTreeEdges > 0 ? dynamic->numTreeEdges
+                                                       : 1));
+  int count = 0;
+  for (int e = 0; e < dynamic->edgeCapacity; e++) {
+    if (dynamic->inTree[e]) result[count++] = dynamic->edges[e];
+  }
+  return result;
+}
@@ -0,0 +1,92 @@
+/*
+ * Header file for our dynamic minimum spanning forest.
+ *
+ * A DynamicMST keeps a minimum spanning forest of a changing undirected
+ * graph, with the forest's edges in a LinkCutTree. Each graph edge is a
+ * node of the LinkCutTree between its two endpoint nodes, valued by its
+ * weight, so the heaviest edge on a tree path is a single query.
+ *
+ * An edge that is inserted or gets lighter replaces the heaviest edge on
+ * the tree path it closes, if that edge is heavier. This takes
+ * O(log n) amortized time. An edge of the forest that is deleted or gets
+ * heavier falls back to scanning every non-tree edge for the lightest
+ * replacement, which takes O(m log n) time.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "graph.h"
+#include "linkcut.h"
+
+#ifndef __DynMST_header
+#define __DynMST_header
+
+typedef struct dynamic_mst {
+  int numVertices;      // vertices are 0, 1, ..., numVertices-1
+  int numEdges;         // number of edges in the graph
+  int numTreeEdges;     // number of edges in the forest
+  long long weight;     // total weight of the forest
+  int edgeCapacity;     // number of edge slots allocated
+  Edge* edges;          // edges[e] is the edge in slot e; a free slot has
+                        //   fromVertex -1 and toVertex the next free slot
+  bool* inTree;         // inTree[e] is true iff edge e is in the forest
+  int freeSlot;         // first free edge slot, or -1 if none
+  int64_t* keys;        // hash table of vertex pairs (see dynmst.c)
+  int* slots;           // slots[i] is the edge slot of keys[i]
+  int tableSize;        // number of entries in the hash table
+  int tableUsed;        // number of entries holding a key or a tombstone
+  LinkCutTree* forest;  // node v < numVertices is vertex v, node
+                        //   numVertices + e is edge slot e
+} DynamicMST;
+
+/***** Construction *********************************************************/
+
+/* Returns a newly created DynamicMST of Graph 'graph' whose forest starts
+ * as 'mst', the result of primGetMST on 'graph' (placeholder edges to -1,
+ * which primGetMST leaves for unreached vertices, are skipped). If 'mst' is
+ * NULL, primGetMST is run from vertex 0. The graph's edges are copied, so
+ * 'graph' may change or be deleted afterwards. Parallel edges keep the
+ * lightest.
+ * Returns NULL if 'graph' is NULL.
+ * Precondition: 'graph' is undirected, i.e. every edge is in the adjacency
+ *               lists of both its endpoints
+ */
+DynamicMST* newDynamicMST(Graph* graph, Edge* mst);
+
+/* Frees memory allocated for 'dynamic'.
+ */
+void deleteDynamicMST(DynamicMST* dynamic);
+
+/***** Updates **************************************************************/
+
+/* Adds the edge (u -- v, weight) to the graph of 'dynamic' and updates the
+ * forest. If u and v are already joined, this sets the edge's weight.
+ * Returns false, changing nothing, if u or v is not a valid vertex or
+ * u == v.
+ */
+bool dmstInsertEdge(DynamicMST* dynamic, int u, int v, int weight);
+
+/* Sets the weight of the edge between 'u' and 'v' in the graph of
+ * 'dynamic' to 'weight' and updates the forest.
+ * Returns false if there is no such edge.
+ */
+bool dmstSetWeight(DynamicMST* dynamic, int u, int v, int weight);
+
+/* Removes the edge between 'u' and 'v' from the graph of 'dynamic' and
+ * updates the forest.
+ * Returns false if there is no such edge.
+ */
+bool dmstDeleteEdge(DynamicMST* dynamic, int u, int v);
+
+/***** Results **************************************************************/
+
+/* Returns a newly created array of the dynamic->numTreeEdges edges of the
+ * current forest. For a connected graph these are numVertices - 1 edges
+ * of the same total weight as primGetMST's.
+ */
+Edge* dmstGetMST(DynamicMST* dynamic);
+
+#endif
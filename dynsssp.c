@@ -0,0 +1,219 @@
+/*
+ * Our incremental shortest path tree repair.
+ */
+
+#include "dynsssp.h"
+
+#include <limits.h>
+
+#define NOTHING -1
+
+/*************************************************************************
+ ** Scratch space
+ *************************************************************************/
+
+/* Returns newly created scratch space for repairing distance trees of
+ * graphs with 'numVertices' vertices, using the priority queue chosen by
+ * 'options' (NULL for the defaults). An SSSPRepair is reused from repair to
+ * repair and only resets what the last repair touched; each thread needs
+ * its own. A monotone queue, such as the radix heap, is rebuilt for every
+ * repair instead.
+ * Returns NULL if 'options' names no priority queue.
+ * Precondition: numVertices >= 0
+ */
+SSSPRepair* newSSSPRepair(int numVertices, AlgoOptions* options) {
+  const PQOps* queue = chooseQueue(options);
+  if (queue == NULL) return NULL;
+  SSSPRepair* repair = malloc(sizeof(SSSPRepair));
+  repair->numVertices = numVertices;
+  repair->changed = calloc(numVertices > 0 ? numVertices : 1, sizeof(bool));
+  repair->cutOff = calloc(numVertices > 0 ? numVertices : 1, sizeof(bool));
+  repair->touched = malloc(sizeof(int) * (numVertices > 0 ? numVertices : 1));
+  repair->numTouched = 0;
+  repair->queue = queue;
+  initPriorityQueue(&repair->pq, queue, numVertices);
+  return repair;
+}
+
+/* Frees memory allocated for 'repair'.
+ */
+void deleteSSSPRepair(SSSPRepair* repair) {
+  if (repair == NULL) return;
+  free(repair->changed);
+  free(repair->cutOff);
+  free(repair->touched);
+  freePriorityQueue(&repair->pq);
+  free(repair);
+}
+
+/*************************************************************************
+ ** Repair
+ *************************************************************************/
+
+/* Returns the weight of the lightest edge from vertex 'from' to vertex 'to'
+ * in the adjacency list of 'from' in 'graph', or INT_MAX if there is none.
+ */
+static int lightestEdge(Graph* graph, int from, int to) {
+  int lightest = INT_MAX;
+  for (AdjList* adjList = graph->vertices[from].adjList; adjList != NULL;
+       adjList = adjList->next) {
+    if (adjacentId(adjList->edge, from) == to &&
+        adjList->edge->weight < lightest) {
+      lightest = adjList->edge->weight;
+    }
+  }
+  return lightest;
+}
+
+/* Adds 'v' to the vertices the current repair of 'repair' touched. */
+static void touch(SSSPRepair* repair, int v) {
+  if (repair->changed[v]) return;
+  repair->changed[v] = true;
+  repair->touched[repair->numTouched++] = v;
+}
+
+/* Offers vertex 'v' the path of length 'distance' through 'pred', as
+ * Dijkstra's algorithm does, recording it in 'distTree' if it is shorter.
+ */
+static void offer(SSSPRepair* repair, Edge* distTree, int v, int pred,
+                  long long distance) {
+  if (distance >= distTree[v].weight) return;
+  distTree[v] = (Edge){v, pred, (int)distance};
+  touch(repair, v);
+  if (pqContains(&repair->pq, v)) {
+    pqDecreasePriority(&repair->pq, v, (int)distance);
+  } else {
+    pqInsert(&repair->pq, (int)distance, v);
+  }
+}
+
+/* Takes the distances away from 'root' and every vertex below it in
+ * 'distTree', found through their adjacency lists in 'graph'.
+ */
+static void cutOffSubtree(SSSPRepair* repair, Graph* graph, Edge* distTree,
+                          int root) {
+  int first = repair->numTouched;
+  repair->cutOff[root] = true;
+  touch(repair, root);
+  for (int i = first; i < repair->numTouched; i++) {
+    int x = repair->touched[i];
+    distTree[x] = (Edge){x, NOTHING, INT_MAX};
+    for (AdjList* adjList = graph->vertices[x].adjList; adjList != NULL;
+         adjList = adjList->next) {
+      int y = adjacentId(adjList->edge, x);
+      if (y != x && !repair->cutOff[y] && distTree[y].toVertex == x) {
+        repair->cutOff[y] = true;
+        touch(repair, y);
+      }
+    }
+  }
+}
+
+/* Cuts off the subtree below tree edge 'pred' -- 'v' of 'distTree', if
+ * there is such a tree edge and 'graph' no longer has an edge that keeps
+ * v's distance.
+ */
+static void checkTreeEdge(SSSPRepair* repair, Graph* graph, Edge* distTree,
+                          int pred, int v) {
+  if (pred == v || distTree[v].toVertex != pred || repair->cutOff[v]) {
+    return;
+  }
+  int weight = lightestEdge(graph, pred, v);
+  if (weight == INT_MAX ||
+      (long long)distTree[pred].weight + weight > distTree[v].weight) {
+    cutOffSubtree(repair, graph, distTree, v);
+  }
+}
+
+/* Offers 'v' the path over the edge from 'pred' in 'graph', unless pred
+ * was cut off or is unreached; a cut-off vertex offers its edges when its
+ * new distance is settled.
+ */
+static void offerEdge(SSSPRepair* repair, Graph* graph, Edge* distTree,
+                      int pred, int v) {
+  if (repair->cutOff[pred] || distTree[pred].weight == INT_MAX) return;
+  int weight = lightestEdge(graph, pred, v);
+  if (weight == INT_MAX) return;
+  offer(repair, distTree, v, pred, (long long)distTree[pred].weight + weight);
+}
+
+/* Updates 'distTree', the distance tree getShortestPaths returned for some
+ * start vertex of Graph 'graph', after the edges in 'changes' changed:
+ * 'graph' already holds the new edges, and changes[i] names the endpoints
+ * (fromVertex -- toVertex) of an edge that was added, removed, or had its
+ * weight changed; the weight field of a change is not used. Afterwards
+ * 'distTree' holds the distances getShortestPaths would compute on 'graph'
+ * now; where several shortest paths tie, the predecessor kept may differ.
+ * Until the next repair, repair->touched lists the vertices whose tree edge
+ * may have changed: every vertex whose tree edge changed, and every vertex
+ * cut off in step 1 (see dynsssp.h) even if it got its old edge back.
+ * Returns the number of such vertices, or -1, changing nothing, if 'graph'
+ * does not have repair->numVertices vertices or some change names a vertex
+ * that is not valid in 'graph'.
+ * Precondition: 'graph' is undirected, i.e. every edge is in the adjacency
+ *               lists of both its endpoints, if some change makes an edge
+ *               of the tree heavier or removes it (the vertices below it
+ *               are reached through their own adjacency lists)
+ */
+int repairShortestPaths(SSSPRepair* repair, Graph* graph, Edge* distTree,
+                        Edge* changes, int numChanges) {
+  int numVertices = repair->numVertices;
+  if (graph->numVertices != numVertices) return -1;
+  for (int i = 0; i < numChanges; i++) {
+    int u = changes[i].fromVertex;
+    int v = changes[i].toVertex;
+    if (u < 0 || u >= numVertices || v < 0 || v >= numVertices) return -1;
+  }
+  for (int i = 0; i < repair->numTouched; i++) {
+    repair->changed[repair->touched[i]] = false;
+  }
+  repair->numTouched = 0;
+  if (repair->queue->monotone) {
+    // its smallest priority only grows; start again from 0
+    freePriorityQueue(&repair->pq);
+    initPriorityQueue(&repair->pq, repair->queue, numVertices);
+  }
+
+  // step 1: cut off the subtrees below edges that no longer carry them
+  for (int i = 0; i < numChanges; i++) {
+    checkTreeEdge(repair, graph, distTree, changes[i].fromVertex,
+                  changes[i].toVertex);
+    checkTreeEdge(repair, graph, distTree, changes[i].toVertex,
+                  changes[i].fromVertex);
+  }
+  int numCutOff = repair->numTouched;
+
+  // step 2: offer cut-off vertices their neighbours' paths, and the far
+  // ends of changed edges the paths over them
+  for (int i = 0; i < numCutOff; i++) {
+    int x = repair->touched[i];
+    for (AdjList* adjList = graph->vertices[x].adjList; adjList != NULL;
+         adjList = adjList->next) {
+      int y = adjacentId(adjList->edge, x);
+      if (repair->cutOff[y] || distTree[y].weight == INT_MAX) continue;
+      offer(repair, distTree, x, y,
+            (long long)distTree[y].weight + adjList->edge->weight);
+    }
+  }
+  for (int i = 0; i < numChanges; i++) {
+    offerEdge(repair, graph, distTree, changes[i].fromVertex,
+              changes[i].toVertex);
+    offerEdge(repair, graph, distTree, changes[i].toVertex,
+              changes[i].fromVertex);
+  }
+
+  // step 3: Dijkstra's algorithm from every vertex whose distance dropped
+  while (!pqIsEmpty(&repair->pq)) {
+    HeapNode node = pqExtractMin(&repair->pq);
+    for (AdjList* adjList = graph->vertices[node.id].adjList; adjList != NULL;
+         adjList = adjList->next) {
+      offer(repair, distTree, adjacentId(adjList->edge, node.id), node.id,
+            (long long)node.priority + adjList->edge->weight);
+    }
+  }
+
+  for (int i = 0; i < numCutOff; i++) {
+    repair->cutOff[repair->touched[i]] = false;
+  }
+  return repair->numTouched;
+}
@@ -0,0 +1,77 @@
+/*
+ * Header file for our incremental shortest path tree repair.
+ *
+ * After a few edges of a graph change, only part of a distance tree from
+ * getShortestPaths is out of date. repairShortestPaths brings such a tree
+ * up to date in place, in the manner of Ramalingam and Reps:
+ *   1. a tree edge that got heavier or disappeared cuts off the subtree
+ *      below it, whose vertices lose their distances;
+ *   2. those vertices are offered the best path from their neighbours
+ *      outside the subtree, and the far end of every edge that got lighter
+ *      or appeared is offered the path over it;
+ *   3. Dijkstra's algorithm runs from the vertices whose distance dropped,
+ *      only as far as distances keep dropping.
+ * The work is proportional to the edges around the vertices whose distance
+ * or predecessor changes, not to the size of the graph.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "graph.h"
+#include "graph_algos.h"
+#include "pq.h"
+
+#ifndef __DynSSSP_header
+#define __DynSSSP_header
+
+typedef struct sssp_repair {
+  int numVertices;     // number of vertices of the graphs repaired
+  bool* changed;       // changed[v] is true iff v is in 'touched'
+  bool* cutOff;        // cutOff[v] is true iff step 1 of the current repair
+                       //   took v's distance away
+  int* touched;        // vertices whose tree edge the last repair may have
+                       //   changed
+  int numTouched;      // number of vertices in 'touched'
+  const PQOps* queue;  // operations of the priority queue used
+  PriorityQueue pq;    // vertices whose distance dropped, by distance
+} SSSPRepair;
+
+/* Returns newly created scratch space for repairing distance trees of
+ * graphs with 'numVertices' vertices, using the priority queue chosen by
+ * 'options' (NULL for the defaults). An SSSPRepair is reused from repair to
+ * repair and only resets what the last repair touched; each thread needs
+ * its own. A monotone queue, such as the radix heap, is rebuilt for every
+ * repair instead.
+ * Returns NULL if 'options' names no priority queue.
+ * Precondition: numVertices >= 0
+ */
+SSSPRepair* newSSSPRepair(int numVertices, AlgoOptions* options);
+
+/* Frees memory allocated for 'repair'.
+ */
+void deleteSSSPRepair(SSSPRepair* repair);
+
+/* Updates 'distTree', the distance tree getShortestPaths returned for some
+ * start vertex of Graph 'graph', after the edges in 'changes' changed:
+ * 'graph' already holds the new edges, and changes[i] names the endpoints
+ * (fromVertex -- toVertex) of an edge that was added, removed, or had its
+ * weight changed; the weight field of a change is not used. Afterwards
+ * 'distTree' holds the distances getShortestPaths would compute on 'graph'
+ * now; where several shortest paths tie, the predecessor kept may differ.
+ * Until the next repair, repair->touched lists the vertices whose tree edge
+ * may have changed: every vertex whose tree edge changed, and every vertex
+ * cut off in step 1 (see above) even if it got its old edge back.
+ * Returns the number of such vertices, or -1, changing nothing, if 'graph'
+ * does not have repair->numVertices vertices or some change names a vertex
+ * that is not valid in 'graph'.
+ * Precondition: 'graph' is undirected, i.e. every edge is in the adjacency
+ *               lists of both its endpoints, if some change makes an edge
+ *               of the tree heavier or removes it (the vertices below it
+ *               are reached through their own adjacency lists)
+ */
+int repairShortestPaths(SSSPRepair* repair, Graph* graph, Edge* distTree,
+                        Edge* changes, int numChanges);
+
+#endif
@@ -38,14 +38,72 @@ Graph* newGraph(int numVertices) {
   new->numVertices = numVertices;
   new->numEdges = 0;
   new->vertices = malloc(sizeof(Vertex) * numVertices);
+  new->arena = NULL;
   for (int i = 0; i < numVertices; i++) {
     new->vertices[i].id = i;
+    new->vertices[i].value = NULL;
     new->vertices[i].adjList = NULL;
   }
   return new;
 }
 
+/* An Edge and the AdjList node holding it, allocated together. */
+typedef struct adj_edge {
+  AdjList node;
+  Edge edge;
+} AdjEdge;
+
+/* Returns a newly created AdjList node pointing to 'next' and holding a new
+ * Edge from vertex 'fromVertex' to vertex 'toVertex' with weight 'weight'.
+ * Both are allocated together from 'arena'. Returns NULL if memory could not
+ * be allocated.
+ */
+AdjList* newArenaAdjList(Arena* arena, int fromVertex, int toVertex, int weight,
+                         AdjList* next) {
+  AdjEdge* new = arenaAlloc(arena, sizeof(AdjEdge));
+  if (new == NULL) return NULL;
+  new->edge.fromVertex = fromVertex;
+  new->edge.toVertex = toVertex;
+  new->edge.weight = weight;
+  new->node.edge = &new->edge;
+  new->node.next = next;
+  return &new->node;
+}
+
+/* Returns a newly created Graph with space for 'numVertices' vertices, whose
+ * Edges and AdjLists are allocated from an arena by prependEdge. Such a graph
+ * is released by deleteGraph with a handful of calls to free. Returns NULL
+ * if the arena could not be allocated.
+ * Precondition: numVertices >= 0
+ */
+Graph* newArenaGraph(int numVertices) {
+  Graph* new = newGraph(numVertices);
+  new->arena = newArena(sizeof(AdjEdge) * 1024);
+  if (new->arena == NULL) {
+    deleteGraph(new);
+    return NULL;
+  }
+  return new;
+}
+
+/* Prepends a new Edge from vertex 'fromVertex' to vertex 'toVertex' with
+ * weight 'weight' to the adjacency list 'head', and returns the new head.
+ * The Edge and its AdjList node come from 'graph''s arena if it has one, and
+ * from newEdge and newAdjList otherwise. Returns NULL if memory could not be
+ * allocated.
+ */
+AdjList* prependEdge(Graph* graph, AdjList* head, int fromVertex, int toVertex,
+                     int weight) {
+  if (graph->arena == NULL) {
+    Edge* edge = newEdge(fromVertex, toVertex, weight);
+    if (edge == NULL) return NULL;
+    return newAdjList(edge, head);
+  }
+  return newArenaAdjList(graph->arena, fromVertex, toVertex, weight, head);
+}
+
 /* Frees memory allocated for AdjList starting at 'head'.
+ * Precondition: the nodes of 'head' were not allocated from an arena.
  */
 void deleteAdjList(AdjList* head) {
   AdjList* next;
@@ -58,14 +116,19 @@ void deleteAdjList(AdjList* head) {
 }
 
 /* Frees memory allocated for 'vertex''s adjacency list.
+ * Precondition: the adjacency list was not allocated from an arena.
  */
 void deleteVertex(Vertex* vertex) { deleteAdjList(vertex->adjList); }
 
 /* Frees memory allocated for 'graph'.
  */
 void deleteGraph(Graph* graph) {
-  for (int i = 0; i < graph->numVertices; i++) {
-    deleteVertex(&(graph->vertices[i]));
+  if (graph->arena != NULL) {
+    deleteArena(graph->arena);
+  } else {
+    for (int i = 0; i < graph->numVertices; i++) {
+      deleteVertex(&(graph->vertices[i]));
+    }
   }
   free(graph->vertices);
   free(graph);
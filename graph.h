@@ -11,6 +11,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "arena.h"
+
 #ifndef __Graph_header
 #define __Graph_header
 
@@ -35,6 +37,8 @@ typedef struct graph {
   int numVertices;   // total number of vertices
   int numEdges;      // total number of edges
   Vertex* vertices;  // array of numVertices Vertex's; vertices[v.id] = v
+  Arena* arena;      // allocator for this graph's Edges and AdjLists, or
+                     //   NULL if each one is malloc'd on its own
 } Graph;
 
 /***** Displaying graph elements ********************************************/
@@ -65,16 +69,43 @@ Edge* newEdge(int fromVertex, int toVertex, int weight);
  */
 AdjList* newAdjList(Edge* edge, AdjList* next);
 
+/* Returns a newly created AdjList node pointing to 'next' and holding a new
+ * Edge from vertex 'fromVertex' to vertex 'toVertex' with weight 'weight'.
+ * Both are allocated together from 'arena'. Returns NULL if memory could not
+ * be allocated.
+ */
+AdjList* newArenaAdjList(Arena* arena, int fromVertex, int toVertex, int weight,
+                         AdjList* next);
+
 /* Returns a newly created Graph with space for 'numVertices' vertices.
  * Precondition: numVertices >= 0
  */
 Graph* newGraph(int numVertices);
 
+/* Returns a newly created Graph with space for 'numVertices' vertices, whose
+ * Edges and AdjLists are allocated from an arena by prependEdge. Such a graph
+ * is released by deleteGraph with a handful of calls to free. Returns NULL
+ * if the arena could not be allocated.
+ * Precondition: numVertices >= 0
+ */
+Graph* newArenaGraph(int numVertices);
+
+/* Prepends a new Edge from vertex 'fromVertex' to vertex 'toVertex' with
+ * weight 'weight' to the adjacency list 'head', and returns the new head.
+ * The Edge and its AdjList node come from 'graph''s arena if it has one, and
+ * from newEdge and newAdjList otherwise. Returns NULL if memory could not be
+ * allocated.
+ */
+AdjList* prependEdge(Graph* graph, AdjList* head, int fromVertex, int toVertex,
+                     int weight);
+
 /* Frees memory allocated for AdjList starting at 'head'.
+ * Precondition: the nodes of 'head' were not allocated from an arena.
  */
 void deleteAdjList(AdjList* head);
 
 /* Frees memory allocated for 'vertex''s adjacency list.
+ * Precondition: the adjacency list was not allocated from an arena.
  */
 void deleteVertex(Vertex* vertex);
 
@@ -5,56 +5,145 @@
  */
 
 #include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
+#include "csr.h"
 #include "graph.h"
+#include "graph_algos.h"
 #include "minheap.h"
+#include "parallel.h"
+#include "pq.h"
+#include "relax.h"
+#include "stats.h"
 
 #define NOTHING -1
+#define VECTOR_MIN_DEGREE 16  // fewest edges worth a filterRelaxations call
 
 typedef struct records {
   int numVertices;    // total number of vertices in the graph
                       // vertex IDs are 0, 1, ..., numVertices-1
-  MinHeap* heap;      // priority queue
+  PriorityQueue pq;   // priority queue
   bool* finished;     // finished[id] is true iff vertex id is finished
                       //   i.e. no longer in the PQ
   int* predecessors;  // predecessors[id] is the predecessor of vertex id
   Edge* tree;         // keeps edges for the resulting tree
   int numTreeEdges;   // current number of edges in mst
+  int alg;            // 0 for Prim's, 1 for Dijkstra's
+  bool lazy;          // true iff vertices enter the PQ when first reached
+  double phaseStart;  // when the current phase began, from statsNow
+  int* distances;     // dijkstraRunCSR only: distances[id] is the length
+                      //   of the shortest path to vertex id found so far,
+                      //   INT_MAX if none; NULL until needed
+  int* improved;      // scratch for filterRelaxations, NULL until needed
+  int improvedSize;   // number of ints 'improved' has room for
 } Records;
 
+typedef struct batch_job {
+  Graph* graph;          // graph to search, or NULL to use 'csr'
+  CSRGraph* csr;         // CSR graph to search if 'graph' is NULL
+  int numVertices;       // number of vertices in the graph
+  int* startVertices;    // start vertex of each search
+  int numSources;        // number of searches
+  AlgoOptions* options;  // queue configuration and number of workers
+  Edge* trees;           // numSources * numVertices result edges
+  _Atomic int next;      // index of the next unclaimed search
+} BatchJob;
+
+typedef struct meeting {
+  long long distance;  // length of the shortest start-target path found so
+                       //   far, LLONG_MAX if none
+  int vertices[2];     // its middle edge runs from vertices[0], reached by
+                       //   the forward search, to vertices[1], reached by
+                       //   the backward search
+  int weight;          // weight of the middle edge
+} Meeting;
+
 /*************************************************************************
  ** Suggested helper functions, to help with your program design
  *************************************************************************/
 
-/* Creates, populates, and returns a MinHeap to be used by Prim's and
- * Dijkstra's algorightms on Graph 'graph' starting from vertex with ID
- * 'startVertex'.
- * Precondition: 'startVertex' is valid in 'graph'
+/* Returns the operations of the priority queue chosen by 'options' (may be
+ * NULL), or NULL if it names no queue.
  */
-MinHeap* initHeap(Graph* graph, int startVertex) {
-  int numVertices = graph->numVertices;
-  MinHeap* heap = newHeap(numVertices);
-  insert(heap, 0, startVertex);
+const PQOps* chooseQueue(AlgoOptions* options) {
+  if (options == NULL) return pqOpsFor(PQ_DARY_HEAP);
+  if (options->queueOps != NULL) return options->queueOps;
+  return pqOpsFor(options->queue);
+}
+
+/* Creates the priority queue of 'records', implemented by 'ops', for Prim's
+ * and Dijkstra's algorithms starting from vertex with ID 'startVertex'. If
+ * 'records->lazy' is true, only 'startVertex' is inserted; other vertices
+ * are inserted when they are first reached. Otherwise every vertex goes in
+ * at once, 'startVertex' with priority 0 first and the others with INT_MAX,
+ * and initPriorityQueueFrom builds the queue in one pass.
+ * Precondition: 'startVertex' is valid in the graph
+ */
+void initQueue(Records* records, const PQOps* ops, int startVertex) {
+  int numVertices = records->numVertices;
+  if (records->lazy) {
+    initPriorityQueue(&records->pq, ops, numVertices);
+    pqInsert(&records->pq, 0, startVertex);
+    return;
+  }
+  int* ids = malloc(sizeof(int) * numVertices);
+  int* priorities = malloc(sizeof(int) * numVertices);
+  ids[0] = startVertex;
+  priorities[0] = 0;
+  int count = 1;
   for (int i = 0; i < numVertices; i++) {
-    if (graph->vertices[i].id != startVertex) {
-      insert(heap, INT_MAX, graph->vertices[i].id);
+    if (i != startVertex) {
+      ids[count] = i;
+      priorities[count] = INT_MAX;
+      count++;
     }
   }
-  return heap;
+  initPriorityQueueFrom(&records->pq, ops, numVertices, ids, priorities,
+                        numVertices);
+  free(ids);
+  free(priorities);
 }
 
-/* Creates, populates, and returns all records needed to run Prim's and
- * Dijkstra's algorithms on Graph 'graph' starting from vertex with ID
+/* Resets the distances of 'records', if kept, for a run from vertex with ID
  * 'startVertex'.
- * Precondition: 'startVertex' is valid in 'graph'
  */
+void resetDistances(Records* records, int startVertex) {
+  if (records->distances == NULL) return;
+  for (int i = 0; i < records->numVertices; i++) {
+    records->distances[i] = INT_MAX;
+  }
+  records->distances[startVertex] = 0;
+}
 
-Records* initRecords(Graph* graph, int startVertex, int alg) {
-  int numVertices = graph->numVertices;
+/* Makes 'records', set up for a run from vertex with ID 'startVertex' that
+ * has not relaxed any edge yet, keep the distances dijkstraRelaxMany
+ * filters against. Does nothing if they are kept already.
+ */
+void keepDistances(Records* records, int startVertex) {
+  if (records->distances != NULL) return;
+  records->distances = malloc(sizeof(int) * records->numVertices);
+  resetDistances(records, startVertex);
+}
+
+/* Creates, populates, and returns all records needed to run Prim's and
+ * Dijkstra's algorithms on a graph with 'numVertices' vertices starting from
+ * vertex with ID 'startVertex', configured by 'options' (may be NULL). The
+ * resulting tree is written to 'tree', or to a newly allocated array if
+ * 'tree' is NULL.
+ * Precondition: 'startVertex' is valid in the graph
+ *               'options' names a priority queue (see chooseQueue)
+ */
+
+Records* initRecords(int numVertices, int startVertex, int alg,
+                     AlgoOptions* options, Edge* tree) {
+  double start = statsNow();
+  STATS_ADD(runs, 1);
   Records* record = malloc(sizeof(Records));
   record->numVertices = numVertices;
   record->numTreeEdges = 0;
-  record->heap = initHeap(graph, startVertex);
+  record->alg = alg;
+  record->lazy = options != NULL && options->lazyFrontier;
   record->finished = malloc(sizeof(bool) * numVertices);
   for (int i = 0; i < numVertices; i++) {
     record->finished[i] = false;
@@ -63,18 +152,48 @@ Records* initRecords(Graph* graph, int startVertex, int alg) {
   for (int i = 0; i < numVertices; i++) {
     record->predecessors[i] = NOTHING;
   }
-  if (alg == 0) {  // prim get MST
+  initQueue(record, chooseQueue(options), startVertex);
+  record->distances = NULL;
+  record->improved = NULL;
+  record->improvedSize = 0;
+  record->tree = tree;
+  if (tree == NULL && alg == 0) {  // prim get MST
     record->tree = malloc(sizeof(Edge) * (numVertices - 1));
   }
-  if (alg == 1) {  // dijkstra
+  if (tree == NULL && alg == 1) {  // dijkstra
     record->tree = malloc(sizeof(Edge) * (numVertices));
   }
-
+  statsAddTime(STATS_INIT, start);
+  record->phaseStart = statsNow();
   return record;
 }
 
-/* Returns true iff 'heap' is NULL or is empty. */
-bool isEmpty(MinHeap* heap) { return (heap == NULL || heap->size == 0); }
+/* Prepares 'records', left with an empty queue by a finished run, for
+ * another run of the same algorithm starting from vertex with ID
+ * 'startVertex' that writes its tree to 'tree'.
+ * Precondition: 'startVertex' is valid in the graph
+ */
+void restartRecords(Records* records, int startVertex, Edge* tree) {
+  double start = statsNow();
+  STATS_ADD(runs, 1);
+  for (int i = 0; i < records->numVertices; i++) {
+    records->finished[i] = false;
+    records->predecessors[i] = NOTHING;
+  }
+  resetDistances(records, startVertex);
+  records->tree = tree;
+  records->numTreeEdges = 0;
+  if (records->lazy) {
+    pqInsert(&records->pq, 0, startVertex);
+  } else {
+    // a fresh queue built in one pass beats refilling the emptied one
+    const PQOps* ops = records->pq.ops;
+    freePriorityQueue(&records->pq);
+    initQueue(records, ops, startVertex);
+  }
+  statsAddTime(STATS_INIT, start);
+  records->phaseStart = statsNow();
+}
 
 /* Add a new edge to records at index ind. */
 void addTreeEdge(Records* records, int ind, int fromVertex, int toVertex,
@@ -91,26 +210,252 @@ void addTreeEdge(Records* records, int ind, int fromVertex, int toVertex,
   records->numTreeEdges++;
 }
 
-/* Creates and returns a path from 'vertex' to 'startVertex' from edges
- * in the distance tree 'distTree'.
+/* Gives every vertex that was never reached the tree edge the eager
+ * algorithms produce for it: (id -- NOTHING, INT_MAX).
  */
-AdjList* makePath(Edge* distTree, int vertex, int startVertex) {
-  if (vertex == startVertex) {
-    return NULL;
+void addUnreachedEdges(Records* records) {
+  for (int i = 0; i < records->numVertices; i++) {
+    if (records->finished[i]) continue;
+    if (records->alg == 0) {
+      addTreeEdge(records, records->numTreeEdges, i, NOTHING, INT_MAX);
+    } else {
+      addTreeEdge(records, i, i, NOTHING, INT_MAX);
+    }
   }
-  int nextVertexId;
-  if (distTree[vertex].fromVertex == vertex) {
-    nextVertexId = distTree[vertex].toVertex;
-  } else {
-    nextVertexId = distTree[vertex].fromVertex;
+}
+
+/* Ends the main loop of a run on 'records' for the phase timers. */
+void endMainLoop(Records* records) {
+  statsAddTime(STATS_MAIN_LOOP, records->phaseStart);
+  records->phaseStart = statsNow();
+}
+
+/* Completes the tree of 'records' after a run: in lazy mode, vertices that
+ * were never reached get their tree edges now.
+ */
+void completeTree(Records* records) {
+  endMainLoop(records);
+  if (records->lazy) {
+    addUnreachedEdges(records);
   }
-  AdjList* result = newAdjList(
-      newEdge(distTree[vertex].fromVertex, distTree[vertex].toVertex,
-              distTree[vertex].weight - distTree[nextVertexId].weight),
-      makePath(distTree, nextVertexId, startVertex));
+  statsAddTime(STATS_TEARDOWN, records->phaseStart);
+}
+
+/* Frees all records except the tree. */
+void freeRecords(Records* records) {
+  double start = statsNow();
+  freePriorityQueue(&records->pq);
+  free(records->finished);
+  free(records->predecessors);
+  free(records->distances);
+  free(records->improved);
+  free(records);
+  statsAddTime(STATS_TEARDOWN, start);
+  flushGraphStats();
+}
+
+/* Frees all records except the tree, and returns the tree. */
+Edge* finishRecords(Records* records) {
+  completeTree(records);
+  Edge* result = records->tree;
+  freeRecords(records);
   return result;
 }
 
+/* Returns true iff 'options' names a priority queue that can run Prim's
+ * algorithm, whose extracted priorities are not monotone.
+ */
+bool supportsPrim(AlgoOptions* options) {
+  const PQOps* ops = chooseQueue(options);
+  return ops != NULL && !ops->monotone;
+}
+
+/* Returns true iff 'options' names a priority queue. */
+bool supportsDijkstra(AlgoOptions* options) {
+  return chooseQueue(options) != NULL;
+}
+
+/* Returns the endpoint of 'edge' that is not 'currentId'. */
+int adjacentId(Edge* edge, int currentId) {
+  if (edge->fromVertex == currentId) {
+    return edge->toVertex;
+  }
+  return edge->fromVertex;
+}
+
+/* Records the extraction of 'currentNode' by Prim's algorithm. */
+void primVisit(Records* records, HeapNode currentNode, int startVertex) {
+  records->finished[currentNode.id] = true;
+  if (currentNode.id != startVertex) {
+    addTreeEdge(records, records->numTreeEdges, currentNode.id,
+                records->predecessors[currentNode.id], currentNode.priority);
+  }
+}
+
+/* Offers unfinished vertex 'adjId' the edge of weight 'weight' from vertex
+ * 'currentId', as Prim's algorithm does.
+ */
+void primRelax(Records* records, int currentId, int adjId, int weight) {
+  STATS_ADD(relaxations, 1);
+  if (records->finished[adjId]) {
+    return;
+  }
+  if (records->lazy && !pqContains(&records->pq, adjId)) {
+    pqInsert(&records->pq, weight, adjId);
+    records->predecessors[adjId] = currentId;
+  } else if (weight < pqGetPriority(&records->pq, adjId)) {
+    pqDecreasePriority(&records->pq, adjId, weight);
+    records->predecessors[adjId] = currentId;
+  } else {
+    STATS_ADD(rejectedDecreases, 1);
+  }
+}
+
+/* Records the extraction of 'currentNode' by Dijkstra's algorithm. */
+void dijkstraVisit(Records* records, HeapNode currentNode, int startVertex) {
+  int currentId = currentNode.id;
+  records->finished[currentId] = true;
+  if (currentId == startVertex) {
+    addTreeEdge(records, currentId, currentId, currentId, 0);
+  } else {
+    addTreeEdge(records, currentId, currentId,
+                records->predecessors[currentId], currentNode.priority);
+  }
+}
+
+/* Offers vertex 'adjId' the path through vertex 'currentId' at distance
+ * 'currentWeight' over an edge of weight 'weight', as Dijkstra's algorithm
+ * does. Paths of length INT_MAX or more are no better than none: the eager
+ * queue hands out unreached vertices at INT_MAX, and adding to that would
+ * wrap around. See typedgraph.h for distances wider than an int.
+ */
+void dijkstraRelax(Records* records, int currentId, int currentWeight,
+                   int adjId, int weight) {
+  STATS_ADD(relaxations, 1);
+  if ((long long)weight + currentWeight >= INT_MAX) {
+    STATS_ADD(rejectedDecreases, 1);
+    return;
+  }
+  int totalWeight = weight + currentWeight;
+  if (records->lazy && !pqContains(&records->pq, adjId)) {
+    if (!records->finished[adjId]) {
+      pqInsert(&records->pq, totalWeight, adjId);
+      records->predecessors[adjId] = currentId;
+      if (records->distances != NULL) records->distances[adjId] = totalWeight;
+    }
+  } else if (totalWeight < pqGetPriority(&records->pq, adjId)) {
+    pqDecreasePriority(&records->pq, adjId, totalWeight);
+    records->predecessors[adjId] = currentId;
+    if (records->distances != NULL) records->distances[adjId] = totalWeight;
+  } else {
+    STATS_ADD(rejectedDecreases, 1);
+  }
+}
+
+/* Runs Dijkstra's algorithm on Graph 'graph' from vertex with ID
+ * 'startVertex', using 'records' set up for that run.
+ */
+void dijkstraRun(Records* records, Graph* graph, int startVertex) {
+  AdjList* adjList;
+  while (!(pqIsEmpty(&records->pq))) {
+    HeapNode currentNode = pqExtractMin(&records->pq);
+    int currentId = currentNode.id;
+    dijkstraVisit(records, currentNode, startVertex);
+    adjList = graph->vertices[currentId].adjList;
+    while (adjList != NULL) {
+      dijkstraRelax(records, currentId, currentNode.priority,
+                    adjacentId(adjList->edge, currentId),
+                    adjList->edge->weight);
+      adjList = adjList->next;
+    }
+  }
+}
+
+/* Relaxes the 'count' >= VECTOR_MIN_DEGREE edges of CSRGraph 'graph' out
+ * of the just-settled 'currentNode', starting at adjacency slot 'first'.
+ * filterRelaxations picks out, from 'records->distances', the edges that
+ * shorten a path, and only those reach dijkstraRelax; the others would have
+ * been rejected there, and are counted as such.
+ */
+void dijkstraRelaxMany(Records* records, CSRGraph* graph, HeapNode currentNode,
+                       int first, int count) {
+  if (count > records->improvedSize) {
+    free(records->improved);
+    records->improved = malloc(sizeof(int) * count);
+    records->improvedSize = count;
+  }
+  int numImproved =
+      filterRelaxations(graph->targets + first, graph->weights + first, count,
+                        currentNode.priority, records->distances,
+                        records->improved);
+  STATS_ADD(relaxations, count - numImproved);
+  STATS_ADD(rejectedDecreases, count - numImproved);
+  for (int k = 0; k < numImproved; k++) {
+    int i = first + records->improved[k];
+    dijkstraRelax(records, currentNode.id, currentNode.priority,
+                  graph->targets[i], graph->weights[i]);
+  }
+}
+
+/* Runs Dijkstra's algorithm on CSRGraph 'graph' from vertex with ID
+ * 'startVertex', using 'records' set up for that run. High-degree vertices
+ * have their edges filtered by dijkstraRelaxMany.
+ */
+void dijkstraRunCSR(Records* records, CSRGraph* graph, int startVertex) {
+  keepDistances(records, startVertex);
+  while (!(pqIsEmpty(&records->pq))) {
+    HeapNode currentNode = pqExtractMin(&records->pq);
+    int currentId = currentNode.id;
+    dijkstraVisit(records, currentNode, startVertex);
+    int begin = graph->offsets[currentId];
+    int end = graph->offsets[currentId + 1];
+    if (end - begin >= VECTOR_MIN_DEGREE) {
+      dijkstraRelaxMany(records, graph, currentNode, begin, end - begin);
+      continue;
+    }
+    for (int i = begin; i < end; i++) {
+      dijkstraRelax(records, currentId, currentNode.priority,
+                    graph->targets[i], graph->weights[i]);
+    }
+  }
+}
+
+/* Creates and returns a path from 'vertex' to 'startVertex' from edges
+ * in the distance tree 'distTree'. Nodes are allocated from 'arena', or
+ * with newEdge and newAdjList if 'arena' is NULL. The tree is walked in a
+ * loop, so deep trees cannot overflow the stack. Returns NULL if 'vertex'
+ * is 'startVertex' or was never reached.
+ */
+AdjList* makePath(Edge* distTree, int vertex, int startVertex, Arena* arena) {
+  AdjList* head = NULL;
+  AdjList** tail = &head;
+  while (vertex != startVertex) {
+    int nextVertexId;
+    if (distTree[vertex].fromVertex == vertex) {
+      nextVertexId = distTree[vertex].toVertex;
+    } else {
+      nextVertexId = distTree[vertex].fromVertex;
+    }
+    if (nextVertexId == NOTHING) {
+      break;
+    }
+    int weight = distTree[vertex].weight - distTree[nextVertexId].weight;
+    AdjList* node;
+    if (arena != NULL) {
+      node = newArenaAdjList(arena, distTree[vertex].fromVertex,
+                             distTree[vertex].toVertex, weight, NULL);
+    } else {
+      node = newAdjList(newEdge(distTree[vertex].fromVertex,
+                                distTree[vertex].toVertex, weight),
+                        NULL);
+    }
+    *tail = node;
+    tail = &node->next;
+    vertex = nextVertexId;
+  }
+  return head;
+}
+
 /*************************************************************************
  ** Required functions.
  *************************************************************************/
@@ -121,91 +466,517 @@ AdjList* makePath(Edge* distTree, int vertex, int startVertex) {
  * Precondition: 'graph' is connected.
  */
 Edge* primGetMST(Graph* graph, int startVertex) {
+  return primGetMSTWithOptions(graph, startVertex, NULL);
+}
+
+/* Runs Dijkstra's algorithm on Graph 'graph' starting from vertex with ID
+ * 'startVertex', and return the resulting distance tree: an array of edges.
+ * Returns NULL is 'startVertex' is not valid in 'graph'.
+ * Precondition: 'graph' is connected.
+ */
+Edge* getShortestPaths(Graph* graph, int startVertex) {
+  return getShortestPathsWithOptions(graph, startVertex, NULL);
+}
+
+/* Like primGetMST, but configured by 'options' (NULL for the defaults).
+ * Returns NULL if 'options' asks for a queue that only supports Dijkstra's
+ * algorithm.
+ */
+Edge* primGetMSTWithOptions(Graph* graph, int startVertex,
+                            AlgoOptions* options) {
   int numVertices = graph->numVertices;
-  if (startVertex < 0 || startVertex >= numVertices) {
+  if (startVertex < 0 || startVertex >= numVertices ||
+      !supportsPrim(options)) {
     return NULL;
   }
   AdjList* adjList;
-  int adjId;
-  Records* records = initRecords(graph, startVertex, 0);
-  while (!(isEmpty(records->heap))) {
-    HeapNode currentNode = extractMin(records->heap);
+  Records* records = initRecords(numVertices, startVertex, 0, options, NULL);
+  while (!(pqIsEmpty(&records->pq))) {
+    HeapNode currentNode = pqExtractMin(&records->pq);
     int currentId = currentNode.id;
-    int currentWeight = currentNode.priority;
-    Vertex currentVertex = graph->vertices[currentId];
-    if (currentId != startVertex) {
-      addTreeEdge(records, records->numTreeEdges, currentId,
-                  records->predecessors[currentId], currentWeight);
-    }
-    adjList = currentVertex.adjList;
+    primVisit(records, currentNode, startVertex);
+    adjList = graph->vertices[currentId].adjList;
     while (adjList != NULL) {
-      if (adjList->edge->fromVertex == currentId) {
-        adjId = adjList->edge->toVertex;
-      } else {
-        adjId = adjList->edge->fromVertex;
-      }
-      if (records->finished[adjId] == false &&
-          adjList->edge->weight < getPriority(records->heap, adjId)) {
-        decreasePriority(records->heap, adjId, adjList->edge->weight);
-        records->predecessors[adjId] = currentId;
-      }
+      primRelax(records, currentId, adjacentId(adjList->edge, currentId),
+                adjList->edge->weight);
       adjList = adjList->next;
     }
   }
-  deleteHeap(records->heap);
-  free(records->finished);
-  free(records->predecessors);
-  Edge* result = records->tree;
-  free(records);
-  return result;
+  return finishRecords(records);
 }
 
-/* Runs Dijkstra's algorithm on Graph 'graph' starting from vertex with ID
- * 'startVertex', and return the resulting distance tree: an array of edges.
- * Returns NULL is 'startVertex' is not valid in 'graph'.
+/* Like getShortestPaths, but configured by 'options' (NULL for the
+ * defaults). Returns NULL if 'options' names no priority queue.
+ */
+Edge* getShortestPathsWithOptions(Graph* graph, int startVertex,
+                                  AlgoOptions* options) {
+  int numVertices = graph->numVertices;
+  if (startVertex < 0 || startVertex >= numVertices ||
+      !supportsDijkstra(options)) {
+    return NULL;
+  }
+  Records* records = initRecords(numVertices, startVertex, 1, options, NULL);
+  dijkstraRun(records, graph, startVertex);
+  return finishRecords(records);
+}
+
+/* Runs Prim's algorithm on CSRGraph 'graph' starting from vertex with ID
+ * 'startVertex', configured by 'options' (NULL for the defaults), and return
+ * the resulting MST: an array of Edges. Produces the same tree as
+ * primGetMSTWithOptions on the Graph 'graph' was built from.
+ * Returns NULL if 'startVertex' is not valid in 'graph', or if 'options'
+ * asks for a queue that only supports Dijkstra's algorithm.
  * Precondition: 'graph' is connected.
  */
-Edge* getShortestPaths(Graph* graph, int startVertex) {
+Edge* primGetMSTCSR(CSRGraph* graph, int startVertex, AlgoOptions* options) {
   int numVertices = graph->numVertices;
-  if (startVertex < 0 || startVertex >= numVertices) {
+  if (startVertex < 0 || startVertex >= numVertices ||
+      !supportsPrim(options)) {
     return NULL;
   }
-  AdjList* adjList;
-  int adjId;
-  int totalWeight;
-  Records* records = initRecords(graph, startVertex, 1);
-  while (!(isEmpty(records->heap))) {
-    HeapNode currentNode = extractMin(records->heap);
+  Records* records = initRecords(numVertices, startVertex, 0, options, NULL);
+  while (!(pqIsEmpty(&records->pq))) {
+    HeapNode currentNode = pqExtractMin(&records->pq);
     int currentId = currentNode.id;
-    int currentWeight = currentNode.priority;
-    Vertex currentVertex = graph->vertices[currentId];
-    if (currentId == startVertex) {
-      addTreeEdge(records, currentId, currentId, currentId, 0);
+    primVisit(records, currentNode, startVertex);
+    int end = graph->offsets[currentId + 1];
+    for (int i = graph->offsets[currentId]; i < end; i++) {
+      primRelax(records, currentId, graph->targets[i], graph->weights[i]);
+    }
+  }
+  return finishRecords(records);
+}
+
+/* Runs Dijkstra's algorithm on CSRGraph 'graph' starting from vertex with ID
+ * 'startVertex', configured by 'options' (NULL for the defaults), and return
+ * the resulting distance tree: an array of edges. Produces the same tree as
+ * getShortestPathsWithOptions on the Graph 'graph' was built from.
+ * Returns NULL is 'startVertex' is not valid in 'graph'.
+ * Precondition: 'graph' is connected.
+ */
+Edge* getShortestPathsCSR(CSRGraph* graph, int startVertex,
+                          AlgoOptions* options) {
+  int numVertices = graph->numVertices;
+  if (startVertex < 0 || startVertex >= numVertices ||
+      !supportsDijkstra(options)) {
+    return NULL;
+  }
+  Records* records = initRecords(numVertices, startVertex, 1, options, NULL);
+  dijkstraRunCSR(records, graph, startVertex);
+  return finishRecords(records);
+}
+
+/* Returns true iff all 'numSources' IDs in 'startVertices' are valid in a
+ * graph with 'numVertices' vertices.
+ */
+bool validSources(int* startVertices, int numSources, int numVertices) {
+  for (int i = 0; i < numSources; i++) {
+    if (startVertices[i] < 0 || startVertices[i] >= numVertices) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Runs one worker of a batch: claims sources from 'job' until none are left
+ * and writes the distance tree of each into its slot of 'job->trees'. The
+ * worker's records are created for its first source and reused afterwards.
+ */
+void batchTask(void* arg, int thread, int numThreads) {
+  BatchJob* job = arg;
+  int numVertices = job->numVertices;
+  Records* records = NULL;
+  int i;
+  while ((i = atomic_fetch_add(&job->next, 1)) < job->numSources) {
+    int startVertex = job->startVertices[i];
+    Edge* tree = job->trees + (long)i * numVertices;
+    if (records == NULL) {
+      records = initRecords(numVertices, startVertex, 1, job->options, tree);
     } else {
-      addTreeEdge(records, currentId, currentId,
-                  records->predecessors[currentId], currentWeight);
+      restartRecords(records, startVertex, tree);
+    }
+    if (job->csr != NULL) {
+      dijkstraRunCSR(records, job->csr, startVertex);
+    } else {
+      dijkstraRun(records, job->graph, startVertex);
+    }
+    completeTree(records);
+  }
+  if (records != NULL) {
+    freeRecords(records);
+  }
+}
+
+/* Runs 'job' on a pool of workers and returns its block of trees. */
+Edge* runBatch(BatchJob* job) {
+  long size = (long)job->numSources * job->numVertices;
+  job->trees = malloc(sizeof(Edge) * (size > 0 ? size : 1));
+  atomic_init(&job->next, 0);
+  int numThreads = threadCount(job->options ? job->options->numThreads : 0);
+  if (numThreads > job->numSources) {
+    numThreads = job->numSources;
+  }
+  parallelRun(numThreads > 0 ? numThreads : 1, batchTask, job);
+  return job->trees;
+}
+
+/* Runs Dijkstra's algorithm on Graph 'graph' from each of the 'numSources'
+ * vertices in 'startVertices', on a pool of options->numThreads workers
+ * (all online CPUs if 'options' is NULL or numThreads <= 0) that share
+ * 'graph' and each keep their own records. Returns one block of
+ * numSources * graph->numVertices Edges: the distance tree from
+ * startVertices[i] starts at index i * graph->numVertices and is the tree
+ * getShortestPathsWithOptions returns for that source.
+ * Returns NULL if some start vertex is not valid in 'graph', or if 'options'
+ * names no priority queue.
+ */
+Edge* getShortestPathsBatch(Graph* graph, int* startVertices, int numSources,
+                            AlgoOptions* options) {
+  if (!validSources(startVertices, numSources, graph->numVertices) ||
+      !supportsDijkstra(options)) {
+    return NULL;
+  }
+  BatchJob job = {graph, NULL, graph->numVertices, startVertices, numSources,
+                  options};
+  return runBatch(&job);
+}
+
+/* Like getShortestPathsBatch, but on CSRGraph 'graph'. Each tree is the one
+ * getShortestPathsCSR returns for that source.
+ */
+Edge* getShortestPathsBatchCSR(CSRGraph* graph, int* startVertices,
+                               int numSources, AlgoOptions* options) {
+  if (!validSources(startVertices, numSources, graph->numVertices) ||
+      !supportsDijkstra(options)) {
+    return NULL;
+  }
+  BatchJob job = {NULL, graph, graph->numVertices, startVertices, numSources,
+                  options};
+  return runBatch(&job);
+}
+
+/*************************************************************************
+ ** Point-to-point queries
+ *************************************************************************/
+
+static pthread_key_t queryKey;  // each thread's PathQuery
+static pthread_once_t queryKeyOnce = PTHREAD_ONCE_INIT;
+
+/* Returns newly created scratch space for queries on graphs of up to
+ * 'capacity' vertices with the queue of 'ops'.
+ */
+static PathQuery* newPathQuery(int capacity, const PQOps* ops) {
+  PathQuery* query = malloc(sizeof(PathQuery));
+  query->capacity = capacity;
+  query->ops = ops;
+  for (int side = 0; side < 2; side++) {
+    query->distances[side] = malloc(sizeof(int) * capacity);
+    query->predecessors[side] = malloc(sizeof(int) * capacity);
+    query->finished[side] = calloc(capacity, sizeof(bool));
+    for (int v = 0; v < capacity; v++) {
+      query->distances[side][v] = INT_MAX;
     }
-    adjList = currentVertex.adjList;
+    initPriorityQueue(&query->pq[side], ops, capacity);
+  }
+  query->touched = malloc(sizeof(int) * capacity);
+  query->numTouched = 0;
+  return query;
+}
+
+/* Frees memory allocated for 'query'; a pthread key destructor. */
+static void deletePathQuery(void* arg) {
+  PathQuery* query = arg;
+  if (query == NULL) return;
+  for (int side = 0; side < 2; side++) {
+    free(query->distances[side]);
+    free(query->predecessors[side]);
+    free(query->finished[side]);
+    freePriorityQueue(&query->pq[side]);
+  }
+  free(query->touched);
+  free(query);
+}
+
+static void makeQueryKey(void) {
+  pthread_key_create(&queryKey, deletePathQuery);
+}
+
+/* Resets everything the last query on 'query' touched. */
+static void clearPathQuery(PathQuery* query) {
+  for (int i = 0; i < query->numTouched; i++) {
+    int v = query->touched[i];
+    for (int side = 0; side < 2; side++) {
+      query->distances[side][v] = INT_MAX;
+      query->finished[side][v] = false;
+    }
+  }
+  query->numTouched = 0;
+  for (int side = 0; side < 2; side++) {
+    while (!pqIsEmpty(&query->pq[side])) pqExtractMin(&query->pq[side]);
+  }
+}
+
+/* Returns the calling thread's scratch space for point-to-point queries on
+ * a graph of 'numVertices' vertices with the queue of 'ops', cleared of the
+ * last query. It is rebuilt when the graph is larger or the queue differs.
+ */
+PathQuery* threadPathQuery(int numVertices, const PQOps* ops) {
+  pthread_once(&queryKeyOnce, makeQueryKey);
+  PathQuery* query = pthread_getspecific(queryKey);
+  if (query != NULL && query->capacity >= numVertices && query->ops == ops) {
+    clearPathQuery(query);
+    return query;
+  }
+  deletePathQuery(query);
+  query = newPathQuery(numVertices, ops);
+  pthread_setspecific(queryKey, query);
+  return query;
+}
+
+/* Reaches vertex 'v' on 'side' of 'query' at distance 'distance' via vertex
+ * 'pred', queued with priority 'priority': inserts it, or lowers its
+ * priority if it is queued already.
+ * Precondition: 'distance' < query->distances[side][v]
+ *               'v' is not finished on 'side'
+ */
+void reachQueryVertex(PathQuery* query, int side, int v, int distance,
+                      int priority, int pred) {
+  if (query->distances[0][v] == INT_MAX && query->distances[1][v] == INT_MAX) {
+    query->touched[query->numTouched++] = v;
+  }
+  PriorityQueue* pq = &query->pq[side];
+  if (query->distances[side][v] == INT_MAX) {
+    pqInsert(pq, priority, v);
+  } else {
+    pqDecreasePriority(pq, v, priority);
+  }
+  query->distances[side][v] = distance;
+  query->predecessors[side][v] = pred;
+}
+
+/* Relaxes the edge of weight 'weight' from the just-settled 'currentNode' to
+ * vertex 'adjId' on 'side' of 'query', as dijkstraRelax does. If 'meeting'
+ * is not NULL, the other side searches from the other end, and 'meeting' is
+ * updated if the edge joins the two searches into a shorter path.
+ */
+void queryRelax(PathQuery* query, int side, HeapNode currentNode, int adjId,
+                int weight, Meeting* meeting) {
+  STATS_ADD(relaxations, 1);
+  long long reach = (long long)currentNode.priority + weight;
+  if (query->finished[side][adjId] || reach >= query->distances[side][adjId]) {
+    STATS_ADD(rejectedDecreases, 1);
+  } else {
+    // reach < INT_MAX: the distance it beats is at most INT_MAX
+    reachQueryVertex(query, side, adjId, reach, reach, currentNode.id);
+  }
+  if (meeting == NULL) {
+    return;
+  }
+  int rest = query->distances[1 - side][adjId];
+  if (rest == INT_MAX) {
+    return;
+  }
+  long long total = reach + rest;
+  if (total < meeting->distance) {
+    meeting->distance = total;
+    meeting->vertices[side] = currentNode.id;
+    meeting->vertices[1 - side] = adjId;
+    meeting->weight = weight;
+  }
+}
+
+/* Relaxes every edge out of the just-settled 'currentNode' of Graph 'graph',
+ * or of CSRGraph 'csr' if 'graph' is NULL, with queryRelax.
+ */
+void queryScan(Graph* graph, CSRGraph* csr, PathQuery* query, int side,
+               HeapNode currentNode, Meeting* meeting) {
+  int currentId = currentNode.id;
+  if (graph != NULL) {
+    AdjList* adjList = graph->vertices[currentId].adjList;
     while (adjList != NULL) {
-      if (adjList->edge->fromVertex == currentId) {
-        adjId = adjList->edge->toVertex;
-      } else {
-        adjId = adjList->edge->fromVertex;
-      }
-      totalWeight = adjList->edge->weight + currentWeight;
-      if (totalWeight < getPriority(records->heap, adjId)) {
-        decreasePriority(records->heap, adjId, totalWeight);
-        records->predecessors[adjId] = currentId;
-      }
+      queryRelax(query, side, currentNode,
+                 adjacentId(adjList->edge, currentId), adjList->edge->weight,
+                 meeting);
       adjList = adjList->next;
     }
+    return;
   }
-  deleteHeap(records->heap);
-  free(records->finished);
-  free(records->predecessors);
-  Edge* result = records->tree;
-  free(records);
-  return result;
+  int end = csr->offsets[currentId + 1];
+  for (int i = csr->offsets[currentId]; i < end; i++) {
+    queryRelax(query, side, currentNode, csr->targets[i], csr->weights[i],
+               meeting);
+  }
+}
+
+/* Adds the edge (fromVertex -- toVertex, weight) to the path from '*head' to
+ * '*tail', at the end if 'atEnd' is true and at the front otherwise.
+ */
+void linkPath(AdjList** head, AdjList** tail, int fromVertex, int toVertex,
+              int weight, bool atEnd) {
+  AdjList* node = newAdjList(newEdge(fromVertex, toVertex, weight), NULL);
+  if (*head == NULL) {
+    *head = node;
+    *tail = node;
+  } else if (atEnd) {
+    (*tail)->next = node;
+    *tail = node;
+  } else {
+    node->next = *head;
+    *head = node;
+  }
+}
+
+/* Adds to the path from '*head' to '*tail' the edges that lead from 'vertex'
+ * along the predecessors on 'side' of 'query' to the start vertex
+ * 'startVertex' of that side: at the end, walking away from 'vertex', if
+ * 'atEnd' is true, and at the front, walking towards 'vertex', otherwise.
+ */
+void linkChain(PathQuery* query, int side, int vertex, int startVertex,
+               AdjList** head, AdjList** tail, bool atEnd) {
+  int* distances = query->distances[side];
+  while (vertex != startVertex) {
+    int next = query->predecessors[side][vertex];
+    int weight = distances[vertex] - distances[next];
+    if (atEnd) {
+      linkPath(head, tail, vertex, next, weight, true);
+    } else {
+      linkPath(head, tail, next, vertex, weight, false);
+    }
+    vertex = next;
+  }
+}
+
+/* Runs a search from 'startVertex' on Graph 'graph' (or CSRGraph 'csr' if
+ * 'graph' is NULL) that stops once 'targetVertex' is settled, and returns
+ * the path to it as getShortestPath does.
+ */
+AdjList* forwardQuery(Graph* graph, CSRGraph* csr, PathQuery* query,
+                      int startVertex, int targetVertex, int* distance) {
+  STATS_ADD(runs, 1);
+  double start = statsNow();
+  reachQueryVertex(query, 0, startVertex, 0, 0, NOTHING);
+  while (!pqIsEmpty(&query->pq[0])) {
+    HeapNode currentNode = pqExtractMin(&query->pq[0]);
+    query->finished[0][currentNode.id] = true;
+    if (currentNode.id == targetVertex) {
+      break;
+    }
+    queryScan(graph, csr, query, 0, currentNode, NULL);
+  }
+  statsAddTime(STATS_MAIN_LOOP, start);
+  AdjList* head = NULL;
+  AdjList* tail = NULL;
+  if (query->finished[0][targetVertex]) {
+    *distance = query->distances[0][targetVertex];
+    linkChain(query, 0, targetVertex, startVertex, &head, &tail, true);
+  }
+  return head;
+}
+
+/* Runs alternating searches from 'startVertex' and 'targetVertex' on Graph
+ * 'graph' (or CSRGraph 'csr' if 'graph' is NULL) until the sum of their radii
+ * reaches the shortest path found through an edge between them, and returns
+ * that path as getShortestPath does.
+ */
+AdjList* bidirectionalQuery(Graph* graph, CSRGraph* csr, PathQuery* query,
+                            int startVertex, int targetVertex,
+                            int* distance) {
+  STATS_ADD(runs, 2);
+  double start = statsNow();
+  reachQueryVertex(query, 0, startVertex, 0, 0, NOTHING);
+  reachQueryVertex(query, 1, targetVertex, 0, 0, NOTHING);
+  Meeting meeting = {LLONG_MAX, {NOTHING, NOTHING}, 0};
+  long long radii[2] = {0, 0};
+  int side = 0;
+  while (!pqIsEmpty(&query->pq[0]) && !pqIsEmpty(&query->pq[1])) {
+    HeapNode currentNode = pqExtractMin(&query->pq[side]);
+    query->finished[side][currentNode.id] = true;
+    radii[side] = currentNode.priority;
+    if (radii[0] + radii[1] >= meeting.distance) {
+      break;
+    }
+    queryScan(graph, csr, query, side, currentNode, &meeting);
+    side = 1 - side;
+  }
+  statsAddTime(STATS_MAIN_LOOP, start);
+  AdjList* head = NULL;
+  AdjList* tail = NULL;
+  // as in dijkstraRelax, a path of INT_MAX or more is no path at all
+  if (meeting.distance < INT_MAX) {
+    *distance = (int)meeting.distance;
+    linkChain(query, 1, meeting.vertices[1], targetVertex, &head, &tail,
+              false);
+    linkPath(&head, &tail, meeting.vertices[1], meeting.vertices[0],
+             meeting.weight, true);
+    linkChain(query, 0, meeting.vertices[0], startVertex, &head, &tail,
+              true);
+  }
+  return head;
+}
+
+/* Runs the query of getShortestPath on Graph 'graph', or on CSRGraph 'csr'
+ * if 'graph' is NULL, with 'numVertices' vertices.
+ */
+AdjList* runQuery(Graph* graph, CSRGraph* csr, int numVertices,
+                  int startVertex, int targetVertex, AlgoOptions* options,
+                  int* distance) {
+  int ignored;
+  if (distance == NULL) {
+    distance = &ignored;
+  }
+  *distance = INT_MAX;
+  if (startVertex < 0 || startVertex >= numVertices || targetVertex < 0 ||
+      targetVertex >= numVertices || !supportsDijkstra(options)) {
+    return NULL;
+  }
+  if (startVertex == targetVertex) {
+    *distance = 0;
+    return NULL;
+  }
+  double start = statsNow();
+  PathQuery* query = threadPathQuery(numVertices, chooseQueue(options));
+  statsAddTime(STATS_INIT, start);
+  AdjList* path;
+  if (options != NULL && options->bidirectional) {
+    path = bidirectionalQuery(graph, csr, query, startVertex, targetVertex,
+                              distance);
+  } else {
+    path = forwardQuery(graph, csr, query, startVertex, targetVertex,
+                        distance);
+  }
+  flushGraphStats();
+  return path;
+}
+
+/* Returns a shortest path from vertex with ID 'targetVertex' to vertex with
+ * ID 'startVertex' in Graph 'graph', in the form getPaths uses:
+ *   [(target -- id_1, w_0), (id_1 -- id_2, w_1), ..., (id_n -- start, w_n)]
+ * and sets '*distance' (if 'distance' is not NULL) to its length. The search
+ * stops as soon as the target is settled, and vertices enter the priority
+ * queue only when first reached, so a query only visits vertices closer to
+ * the start than the target. If options->bidirectional is set, a second
+ * search runs backward from the target and the query stops once the two
+ * searches have met. 'options' may be NULL for the defaults; its
+ * lazyFrontier field is ignored.
+ * Returns NULL with '*distance' 0 if the two vertices are the same, and
+ * NULL with '*distance' INT_MAX if the target cannot be reached (paths
+ * of length INT_MAX or more do not count), either vertex is not valid in
+ * 'graph', or 'options' names no priority queue.
+ * Precondition: 'graph' is undirected, i.e. every edge is in the adjacency
+ *               lists of both its endpoints (needed for the backward search)
+ */
+AdjList* getShortestPath(Graph* graph, int startVertex, int targetVertex,
+                         AlgoOptions* options, int* distance) {
+  return runQuery(graph, NULL, graph->numVertices, startVertex, targetVertex,
+                  options, distance);
+}
+
+/* Like getShortestPath, but on CSRGraph 'graph'. */
+AdjList* getShortestPathCSR(CSRGraph* graph, int startVertex,
+                            int targetVertex, AlgoOptions* options,
+                            int* distance) {
+  return runQuery(NULL, graph, graph->numVertices, startVertex, targetVertex,
+                  options, distance);
 }
 
 /* Creates and returns an array 'paths' of shortest paths from every vertex
@@ -215,6 +986,8 @@ Edge* getShortestPaths(Graph* graph, int startVertex) {
  * is the array of Edges of the form
  *   [(id -- id_1, w_0), (id_1 -- id_2, w_1), ..., (id_n -- start, w_n)]
  *   where w_0 + w_1 + ... + w_n = distance(id)
+ * Each path is a list of its own, so the output grows with the total length
+ * of all paths; a PathTree (see pathtree.h) keeps the tree in linear space.
  * Returns NULL if 'startVertex' is not valid in 'distTree'.
  */
 AdjList* getPaths(Edge* distTree, int numVertices, int startVertex) {
@@ -224,7 +997,7 @@ AdjList* getPaths(Edge* distTree, int numVertices, int startVertex) {
   AdjList* temp;
   AdjList* result = malloc(sizeof(AdjList) * numVertices);
   for (int i = 0; i < numVertices; i++) {
-    temp = makePath(distTree, i, startVertex);
+    temp = makePath(distTree, i, startVertex, NULL);
     if (temp == NULL) {
       result[i].edge = NULL;
       result[i].next = NULL;
@@ -237,6 +1010,45 @@ AdjList* getPaths(Edge* distTree, int numVertices, int startVertex) {
   return result;
 }
 
+/* Frees the 'numVertices' paths getPaths returned in 'paths'.
+ */
+void deletePaths(AdjList* paths, int numVertices) {
+  if (paths == NULL) return;
+  for (int v = 0; v < numVertices; v++) {
+    free(paths[v].edge);
+    AdjList* next;
+    for (AdjList* node = paths[v].next; node != NULL; node = next) {
+      next = node->next;
+      free(node->edge);
+      free(node);
+    }
+  }
+  free(paths);
+}
+
+/* Like getPaths, but allocates the returned array and every path node from
+ * 'arena', so all paths are released together by deleteArena.
+ * Returns NULL if 'startVertex' is not valid in 'distTree'.
+ */
+AdjList* getPathsInArena(Edge* distTree, int numVertices, int startVertex,
+                         Arena* arena) {
+  if (startVertex < 0 || startVertex >= numVertices) {
+    return NULL;
+  }
+  AdjList* temp;
+  AdjList* result = arenaAlloc(arena, sizeof(AdjList) * numVertices);
+  for (int i = 0; i < numVertices; i++) {
+    temp = makePath(distTree, i, startVertex, arena);
+    if (temp == NULL) {
+      result[i].edge = NULL;
+      result[i].next = NULL;
+    } else {
+      result[i] = *temp;
+    }
+  }
+  return result;
+}
+
 /*************************************************************************
  ** Provided helper functions -- part of starter code to help you debug!
  *************************************************************************/
@@ -247,7 +1059,9 @@ void printRecords(Records* records) {
   printf("Reporting on algorithm's records on %d vertices...\n", numVertices);
 
   printf("The PQ is:\n");
-  printHeap(records->heap);
+  if (records->pq.ops->print != NULL) {
+    records->pq.ops->print(records->pq.impl);
+  }
 
   printf("The finished array is:\n");
   for (int i = 0; i < numVertices; i++)
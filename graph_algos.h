@@ -11,11 +11,38 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "csr.h"
 #include "graph.h"
+#include "pq.h"
 
 #ifndef __Graph_Algos_header
 #define __Graph_Algos_header
 
+typedef struct algo_options {
+  PQKind queue;       // built-in priority queue used by the algorithm
+  bool lazyFrontier;  // if true, a vertex enters the priority queue only when
+                      //   it is first reached, instead of every vertex being
+                      //   inserted at INT_MAX up front; the heap then holds
+                      //   just the active frontier. Trees have the same
+                      //   weights, but ties may be broken differently.
+  const PQOps* queueOps;  // if not NULL, the priority queue used instead of
+                          //   'queue'; see pq.h
+  int numThreads;         // threads used by the parallel algorithms (see
+                          //   mst.h and sssp.h); 0 for one per online CPU
+  int delta;              // bucket width of delta-stepping (see sssp.h); 0
+                          //   to choose it from the weights
+  bool bidirectional;     // if true, getShortestPath searches from both ends
+                          //   and stops when the searches meet
+} AlgoOptions;
+
+/* Returns the operations of the priority queue chosen by 'options' (may be
+ * NULL), or NULL if it names no queue.
+ */
+const PQOps* chooseQueue(AlgoOptions* options);
+
+/* Returns the endpoint of 'edge' that is not 'currentId'. */
+int adjacentId(Edge* edge, int currentId);
+
 /* Runs Prim's algorithm on Graph 'graph' starting from vertex with ID
  * 'startVertex', and return the resulting MST: an array of Edges.
  * Returns NULL if 'startVertex' is not valid in 'graph'.
@@ -30,6 +57,114 @@ Edge* primGetMST(Graph* graph, int startVertex);
  */
 Edge* getShortestPaths(Graph* graph, int startVertex);
 
+/* Like primGetMST, but configured by 'options' (NULL for the defaults).
+ * Returns NULL if 'options' asks for a queue that only supports Dijkstra's
+ * algorithm.
+ */
+Edge* primGetMSTWithOptions(Graph* graph, int startVertex,
+                            AlgoOptions* options);
+
+/* Like getShortestPaths, but configured by 'options' (NULL for the
+ * defaults). Returns NULL if 'options' names no priority queue.
+ */
+Edge* getShortestPathsWithOptions(Graph* graph, int startVertex,
+                                  AlgoOptions* options);
+
+/* Runs Prim's algorithm on CSRGraph 'graph' starting from vertex with ID
+ * 'startVertex', configured by 'options' (NULL for the defaults), and return
+ * the resulting MST: an array of Edges. Produces the same tree as
+ * primGetMSTWithOptions on the Graph 'graph' was built from.
+ * Returns NULL if 'startVertex' is not valid in 'graph', or if 'options'
+ * asks for a queue that only supports Dijkstra's algorithm.
+ * Precondition: 'graph' is connected.
+ */
+Edge* primGetMSTCSR(CSRGraph* graph, int startVertex, AlgoOptions* options);
+
+/* Runs Dijkstra's algorithm on CSRGraph 'graph' starting from vertex with ID
+ * 'startVertex', configured by 'options' (NULL for the defaults), and return
+ * the resulting distance tree: an array of edges. Produces the same tree as
+ * getShortestPathsWithOptions on the Graph 'graph' was built from.
+ * Returns NULL is 'startVertex' is not valid in 'graph'.
+ * Precondition: 'graph' is connected.
+ */
+Edge* getShortestPathsCSR(CSRGraph* graph, int startVertex,
+                          AlgoOptions* options);
+
+/* Runs Dijkstra's algorithm on Graph 'graph' from each of the 'numSources'
+ * vertices in 'startVertices', on a pool of options->numThreads workers
+ * (all online CPUs if 'options' is NULL or numThreads <= 0) that share
+ * 'graph' and each keep their own records. Returns one block of
+ * numSources * graph->numVertices Edges: the distance tree from
+ * startVertices[i] starts at index i * graph->numVertices and is the tree
+ * getShortestPathsWithOptions returns for that source.
+ * Returns NULL if some start vertex is not valid in 'graph', or if 'options'
+ * names no priority queue.
+ */
+Edge* getShortestPathsBatch(Graph* graph, int* startVertices, int numSources,
+                            AlgoOptions* options);
+
+/* Like getShortestPathsBatch, but on CSRGraph 'graph'. Each tree is the one
+ * getShortestPathsCSR returns for that source.
+ */
+Edge* getShortestPathsBatchCSR(CSRGraph* graph, int* startVertices,
+                               int numSources, AlgoOptions* options);
+
+/* Returns a shortest path from vertex with ID 'targetVertex' to vertex with
+ * ID 'startVertex' in Graph 'graph', in the form getPaths uses:
+ *   [(target -- id_1, w_0), (id_1 -- id_2, w_1), ..., (id_n -- start, w_n)]
+ * and sets '*distance' (if 'distance' is not NULL) to its length. The search
+ * stops as soon as the target is settled, and vertices enter the priority
+ * queue only when first reached, so a query only visits vertices closer to
+ * the start than the target. If options->bidirectional is set, a second
+ * search runs backward from the target and the query stops once the two
+ * searches have met. 'options' may be NULL for the defaults; its
+ * lazyFrontier field is ignored.
+ * Returns NULL with '*distance' 0 if the two vertices are the same, and
+ * NULL with '*distance' INT_MAX if the target cannot be reached (paths
+ * of length INT_MAX or more do not count), either vertex is not valid in
+ * 'graph', or 'options' names no priority queue.
+ * Precondition: 'graph' is undirected, i.e. every edge is in the adjacency
+ *               lists of both its endpoints (needed for the backward search)
+ */
+AdjList* getShortestPath(Graph* graph, int startVertex, int targetVertex,
+                         AlgoOptions* options, int* distance);
+
+/* Like getShortestPath, but on CSRGraph 'graph'. */
+AdjList* getShortestPathCSR(CSRGraph* graph, int startVertex,
+                            int targetVertex, AlgoOptions* options,
+                            int* distance);
+
+typedef struct path_query {
+  int capacity;          // number of vertex IDs the arrays have room for
+  const PQOps* ops;      // implementation of both queues
+  int* distances[2];     // distances[side][id]: length of the shortest path
+                         //   found so far from the start (side 0) or the
+                         //   target (side 1) to vertex id, INT_MAX if none
+  int* predecessors[2];  // predecessors[side][id]: previous vertex on that
+                         //   path, valid if distances[side][id] < INT_MAX
+  bool* finished[2];     // finished[side][id]: true iff id is settled
+  PriorityQueue pq[2];   // frontier of each side
+  int* touched;          // vertices reached by the current query
+  int numTouched;        // number of vertices in 'touched'
+} PathQuery;
+
+/* Returns the calling thread's scratch space for point-to-point queries on
+ * a graph of 'numVertices' vertices with the queue of 'ops', with both sides
+ * cleared of the last query. Only the vertices that query reached are
+ * reset, so a query costs time in the part of the graph it searches, not in
+ * the size of the graph. The scratch is freed when the thread exits.
+ */
+PathQuery* threadPathQuery(int numVertices, const PQOps* ops);
+
+/* Reaches vertex 'v' on 'side' of 'query' at distance 'distance' via vertex
+ * 'pred', queued with priority 'priority': inserts it, or lowers its
+ * priority if it is queued already.
+ * Precondition: 'distance' < query->distances[side][v]
+ *               'v' is not finished on 'side'
+ */
+void reachQueryVertex(PathQuery* query, int side, int v, int distance,
+                      int priority, int pred);
+
 /* Creates and returns an array 'paths' of shortest paths from every vertex
  * in the graph to vertex 'startVertex', based on the information in the
  * distance tree 'distTree' produced by Dijkstra's algorithm on a graph with
@@ -37,8 +172,21 @@ Edge* getShortestPaths(Graph* graph, int startVertex);
  * is the array of Edges of the form
  *   [(id -- id_1, w_0), (id_1 -- id_2, w_1), ..., (id_n -- start, w_n)]
  *   where w_0 + w_1 + ... + w_n = distance(id)
+ * Each path is a list of its own, so the output grows with the total length
+ * of all paths; a PathTree (see pathtree.h) keeps the tree in linear space.
  * Returns NULL if 'startVertex' is not valid in 'distTree'.
  */
 AdjList* getPaths(Edge* distTree, int numVertices, int startVertex);
 
+/* Frees the 'numVertices' paths getPaths returned in 'paths'.
+ */
+void deletePaths(AdjList* paths, int numVertices);
+
+/* Like getPaths, but allocates the returned array and every path node from
+ * 'arena', so all paths are released together by deleteArena.
+ * Returns NULL if 'startVertex' is not valid in 'distTree'.
+ */
+AdjList* getPathsInArena(Edge* distTree, int numVertices, int startVertex,
+                         Arena* arena);
+
 #endif
@@ -0,0 +1,584 @@
+/*
+ *  Benchmarks for the priority queues behind our shortest path algorithms
+ *  and for our minimum spanning tree engines.
+ *
+ *  ---------------------------------------------------------------------------
+ *   Compile:
+ *   make bench
+ *
+ *   Run:
+ *   ./bench [numVertices] [averageDegree] [repetitions] [maxThreads]
+ *  ---------------------------------------------------------------------------
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "alt.h"
+#include "ch.h"
+#include "csr.h"
+#include "dynmst.h"
+#include "dynsssp.h"
+#include "graph.h"
+#include "graph_algos.h"
+#include "graph_gen.h"
+#include "mst.h"
+#include "parallel.h"
+#include "pathtree.h"
+#include "relax.h"
+#include "reorder.h"
+#include "sssp.h"
+#include "stats.h"
+#include "typedgraph.h"
+
+#define DEFAULT_VERTICES 1000000
+#define DEFAULT_DEGREE 8
+#define DEFAULT_REPETITIONS 5
+#define BATCH_SOURCES 16
+#define NUM_LANDMARKS 16
+#define NUM_QUERIES 1000
+#define MAX_GRID_VERTICES 250000
+#define NUM_UPDATES 1000
+#define NUM_TREE_DELETIONS 10
+#define MAX_PATHS_SIDE 150
+
+/* Returns a newly created CSRGraph of 'family' (see graph_gen.h) with about
+ * 'numVertices' vertices and 'averageDegree' neighbours per vertex, weights
+ * 1 .. 'maxWeight', generated from 'seed'.
+ */
+CSRGraph* generateCSR(GraphFamily family, int numVertices, int averageDegree,
+                      int maxWeight, uint64_t seed) {
+  EdgeList* list =
+      generateGraph(family, numVertices, averageDegree, maxWeight, seed);
+  CSRGraph* graph = csrFromEdgeList(list);
+  deleteEdgeList(list);
+  return graph;
+}
+
+/* Returns a newly created arena-backed grid of weights 1 .. 1000, generated
+ * from 'seed', with about 'numVertices' vertices but at most 'maxVertices',
+ * and sets '*side' to its side.
+ */
+Graph* cappedGrid(int numVertices, int maxVertices, uint64_t seed,
+                  int* side) {
+  if (numVertices > maxVertices) numVertices = maxVertices;
+  EdgeList* list = generateGraph(GEN_GRID, numVertices, 4, 1000, seed);
+  Graph* graph = graphFromEdgeList(list);
+  deleteEdgeList(list);
+  *side = 1;
+  while ((*side + 1) * (*side + 1) <= graph->numVertices) (*side)++;
+  return graph;
+}
+
+/* An algorithm under test: returns a tree of 'graph' computed with
+ * 'options'.
+ */
+typedef Edge* (*TreeAlgorithm)(CSRGraph* graph, AlgoOptions* options);
+
+/* Runs Dijkstra's algorithm on 'graph' from vertex 0. */
+Edge* dijkstraFromZero(CSRGraph* graph, AlgoOptions* options) {
+  return getShortestPathsCSR(graph, 0, options);
+}
+
+/* Runs delta-stepping on 'graph' from vertex 0. */
+Edge* deltaFromZero(CSRGraph* graph, AlgoOptions* options) {
+  return deltaSteppingCSR(graph, 0, options);
+}
+
+/* Runs Prim's algorithm on 'graph' from vertex 0. */
+Edge* primFromZero(CSRGraph* graph, AlgoOptions* options) {
+  return primGetMSTCSR(graph, 0, options);
+}
+
+/* Runs 'algorithm' on 'graph' 'repetitions' times with 'options' and prints
+ * the fastest and the median time under 'label'.
+ */
+void timeAlgorithm(TreeAlgorithm algorithm, CSRGraph* graph,
+                   AlgoOptions* options, const char* label, int repetitions) {
+  double* times = malloc(sizeof(double) * repetitions);
+  for (int r = 0; r < repetitions; r++) {
+    double start = clockNow();
+    Edge* tree = algorithm(graph, options);
+    times[r] = clockNow() - start;
+    free(tree);
+  }
+  qsort(times, repetitions, sizeof(double), compareDoubles);
+  printf("  %-24s min %8.3f ms   median %8.3f ms\n", label, times[0] * 1e3,
+         times[repetitions / 2] * 1e3);
+  free(times);
+}
+
+/* Runs Dijkstra's algorithm on 'graph' from each of the 'numSources' vertices
+ * in 'startVertices', one call after another if 'options' is NULL and as one
+ * batch with 'options' otherwise, and prints the time taken under 'label'.
+ */
+void timeSources(CSRGraph* graph, int* startVertices, int numSources,
+                 AlgoOptions* options, const char* label) {
+  double start = clockNow();
+  if (options == NULL) {
+    for (int i = 0; i < numSources; i++) {
+      free(getShortestPathsCSR(graph, startVertices[i], NULL));
+    }
+  } else {
+    free(getShortestPathsBatchCSR(graph, startVertices, numSources, options));
+  }
+  double elapsed = clockNow() - start;
+  printf("  %-24s total %8.3f ms   per source %8.3f ms\n", label,
+         elapsed * 1e3, elapsed * 1e3 / numSources);
+}
+
+/* Answers the 'numQueries' shortest path queries from startVertices[i] to
+ * targetVertices[i] on 'graph', with altGetShortestPath if 'landmarks' is
+ * not NULL, with getShortestPathCSR and 'options' otherwise or, if
+ * 'options' is NULL too, by computing the whole distance tree, and prints
+ * the time taken under 'label'.
+ */
+void timeQueries(CSRGraph* graph, int* startVertices, int* targetVertices,
+                 int numQueries, AlgoOptions* options, Landmarks* landmarks,
+                 const char* label) {
+  double start = clockNow();
+  for (int i = 0; i < numQueries; i++) {
+    if (landmarks != NULL) {
+      deleteAdjList(altGetShortestPath(graph, landmarks, startVertices[i],
+                                       targetVertices[i], options, NULL));
+    } else if (options == NULL) {
+      free(getShortestPathsCSR(graph, startVertices[i], NULL));
+    } else {
+      deleteAdjList(getShortestPathCSR(graph, startVertices[i],
+                                       targetVertices[i], options, NULL));
+    }
+  }
+  double elapsed = clockNow() - start;
+  printf("  %-24s total %8.3f ms   per query  %8.3f ms\n", label,
+         elapsed * 1e3, elapsed * 1e3 / numQueries);
+}
+
+/* Builds a contraction hierarchy of a grid of about 'numVertices' vertices,
+ * but at most MAX_GRID_VERTICES, and times random queries against it and
+ * against bidirectional Dijkstra.
+ */
+void benchHierarchy(int numVertices) {
+  int side;
+  Graph* graph = cappedGrid(numVertices, MAX_GRID_VERTICES, 99, &side);
+  printf("Contraction hierarchy, %d x %d grid, weights 1..1000:\n", side,
+         side);
+  double start = clockNow();
+  ContractionHierarchy* hierarchy = newContractionHierarchy(graph);
+  printf("  %-24s total %8.3f ms   %d arcs, %d shortcuts\n", "preprocessing",
+         (clockNow() - start) * 1e3, hierarchy->numArcs,
+         hierarchy->numShortcuts);
+
+  int* ends = malloc(sizeof(int) * 2 * NUM_QUERIES);
+  uint64_t state = 11;
+  for (int i = 0; i < 2 * NUM_QUERIES; i++) {
+    ends[i] = nextRandom(&state) % graph->numVertices;
+  }
+  CHQuery* query = newCHQuery(hierarchy);
+  const char* labels[] = {"bidirectional", "CH distance", "CH unpacked path"};
+  AlgoOptions bidirectional = {PQ_DARY_HEAP, .bidirectional = true};
+  for (int mode = 0; mode < 3; mode++) {
+    // bidirectional Dijkstra is much slower; a tenth of the queries will do
+    int numQueries = mode == 0 ? NUM_QUERIES / 10 : NUM_QUERIES;
+    start = clockNow();
+    for (int i = 0; i < numQueries; i++) {
+      int s = ends[2 * i];
+      int t = ends[2 * i + 1];
+      if (mode == 0) {
+        deleteAdjList(getShortestPath(graph, s, t, &bidirectional, NULL));
+      } else if (mode == 1) {
+        chGetDistance(query, s, t);
+      } else {
+        deleteAdjList(chGetShortestPath(query, s, t, NULL));
+      }
+    }
+    double elapsed = clockNow() - start;
+    printf("  %-24s total %8.3f ms   per query  %8.3f ms\n", labels[mode],
+           elapsed * 1e3, elapsed * 1e3 / numQueries);
+  }
+  free(ends);
+  deleteCHQuery(query);
+  deleteContractionHierarchy(hierarchy);
+  deleteGraph(graph);
+  printf("\n");
+}
+
+/* Keeps the MST of a grid of about 'numVertices' vertices, but at most
+ * MAX_GRID_VERTICES, up to date under random updates and times them against
+ * recomputing the MST with primGetMST.
+ */
+void benchDynamicMST(int numVertices) {
+  int side;
+  Graph* graph = cappedGrid(numVertices, MAX_GRID_VERTICES, 123, &side);
+  printf("Dynamic MST, %d x %d grid, weights 1..1000:\n", side, side);
+  double start = clockNow();
+  Edge* mst = primGetMST(graph, 0);
+  printf("  %-24s total %8.3f ms\n", "prim recomputation",
+         (clockNow() - start) * 1e3);
+  start = clockNow();
+  DynamicMST* dynamic = newDynamicMST(graph, mst);
+  printf("  %-24s total %8.3f ms\n", "setup from prim's tree",
+         (clockNow() - start) * 1e3);
+
+  uint64_t state = 17;
+  start = clockNow();
+  for (int i = 0; i < NUM_UPDATES; i++) {
+    int u = nextRandom(&state) % graph->numVertices;
+    int v = nextRandom(&state) % graph->numVertices;
+    dmstInsertEdge(dynamic, u, v, 1 + nextRandom(&state) % 1000);
+  }
+  double elapsed = clockNow() - start;
+  printf("  %-24s total %8.3f ms   per update %8.3f ms\n", "insert edge",
+         elapsed * 1e3, elapsed * 1e3 / NUM_UPDATES);
+  // deleting a tree edge scans every other edge for a replacement
+  start = clockNow();
+  for (int i = 0; i < NUM_TREE_DELETIONS; i++) {
+    Edge edge = mst[nextRandom(&state) % (graph->numVertices - 1)];
+    dmstDeleteEdge(dynamic, edge.fromVertex, edge.toVertex);
+  }
+  elapsed = clockNow() - start;
+  printf("  %-24s total %8.3f ms   per update %8.3f ms\n",
+         "delete tree edge", elapsed * 1e3, elapsed * 1e3 / NUM_TREE_DELETIONS);
+  free(mst);
+  deleteDynamicMST(dynamic);
+  deleteGraph(graph);
+  printf("\n");
+}
+
+/* Keeps a distance tree of a grid of about 'numVertices' vertices, but at
+ * most MAX_GRID_VERTICES, up to date while random edges change weight, and
+ * times the repairs against recomputing the tree with getShortestPaths.
+ */
+void benchTreeRepair(int numVertices) {
+  int side;
+  Graph* graph = cappedGrid(numVertices, MAX_GRID_VERTICES, 321, &side);
+  printf("Distance tree repair, %d x %d grid, weights 1..1000:\n", side,
+         side);
+  double start = clockNow();
+  Edge* tree = getShortestPaths(graph, 0);
+  printf("  %-24s total %8.3f ms\n", "dijkstra recomputation",
+         (clockNow() - start) * 1e3);
+
+  SSSPRepair* repair = newSSSPRepair(graph->numVertices, NULL);
+  uint64_t state = 23;
+  long numTouched = 0;
+  start = clockNow();
+  for (int i = 0; i < NUM_UPDATES; i++) {
+    // reweigh the first edge of a random vertex, in both adjacency lists
+    int v = nextRandom(&state) % graph->numVertices;
+    Edge* edge = graph->vertices[v].adjList->edge;
+    int u = edge->toVertex;
+    edge->weight = 1 + nextRandom(&state) % 1000;
+    for (AdjList* adjList = graph->vertices[u].adjList; adjList != NULL;
+         adjList = adjList->next) {
+      if (adjList->edge->toVertex == v) adjList->edge->weight = edge->weight;
+    }
+    Edge change = {v, u, 0};
+    numTouched += repairShortestPaths(repair, graph, tree, &change, 1);
+  }
+  double elapsed = clockNow() - start;
+  printf("  %-24s total %8.3f ms   per update %8.3f ms   %ld vertices\n",
+         "repair one edge", elapsed * 1e3, elapsed * 1e3 / NUM_UPDATES,
+         numTouched / NUM_UPDATES);
+  free(tree);
+  deleteSSSPRepair(repair);
+  deleteGraph(graph);
+  printf("\n");
+}
+
+/* Writes out the paths from all vertices of a grid of about 'numVertices'
+ * vertices, but at most MAX_PATHS_SIDE on a side, to the corner, with
+ * getPaths and with a PathTree.
+ */
+void benchPaths(int numVertices) {
+  int side;
+  Graph* graph =
+      cappedGrid(numVertices, MAX_PATHS_SIDE * MAX_PATHS_SIDE, 77, &side);
+  numVertices = graph->numVertices;
+  Edge* tree = getShortestPaths(graph, 0);
+  printf("All paths to one vertex, %d x %d grid:\n", side, side);
+
+  double start = clockNow();
+  AdjList* paths = getPaths(tree, numVertices, 0);
+  double elapsed = clockNow() - start;
+  deletePaths(paths, numVertices);
+  start = clockNow();
+  PathTree* pathTree = newPathTree(tree, numVertices, 0);
+  PathBuffer* buffer = materializePaths(pathTree);
+  double bulk = clockNow() - start;
+  long numEdges = buffer->numEdges;
+  printf("  %-24s total %8.3f ms   %ld bytes\n", "getPaths", elapsed * 1e3,
+         numEdges * (long)(sizeof(Edge) + sizeof(AdjList)) +
+             numVertices * (long)sizeof(AdjList));
+  printf("  %-24s total %8.3f ms   %ld bytes\n", "path tree, one buffer",
+         bulk * 1e3,
+         numEdges * (long)sizeof(Edge) +
+             (numVertices + 1) * (long)sizeof(long));
+  deletePathBuffer(buffer);
+
+  start = clockNow();
+  long long sum = 0;
+  for (int v = 0; v < numVertices; v++) {
+    PathIterator iterator = pathTreeIterate(pathTree, v);
+    Edge edge;
+    while (pathNext(&iterator, &edge)) sum += edge.weight;
+  }
+  elapsed = clockNow() - start;
+  printf("  %-24s total %8.3f ms   %ld bytes\n", "path tree, iterators",
+         elapsed * 1e3, 2 * numVertices * (long)sizeof(int));
+  if (sum < 0) printf("overflow\n");  // keeps the loop from being dropped
+  deletePathTree(pathTree);
+  free(tree);
+  deleteGraph(graph);
+  printf("\n");
+}
+
+/* Times Dijkstra's and Prim's algorithms on a random graph of
+ * 'numVertices' vertices with weights 1 .. 1000, with int weights and with
+ * each TypedGraph weight type.
+ */
+void benchWeightTypes(int numVertices, int averageDegree, int repetitions) {
+  CSRGraph* graph =
+      generateCSR(GEN_RANDOM, numVertices, averageDegree, 1000, 99);
+  printf("Weight types, %d vertices, weights 1..1000 (narrowest %s):\n",
+         numVertices, weightTypeName(narrowestWeightType(graph)));
+  AlgoOptions lazy = {PQ_DARY_HEAP, true, NULL};
+  timeAlgorithm(dijkstraFromZero, graph, &lazy, "dijkstra, int", repetitions);
+  timeAlgorithm(primFromZero, graph, &lazy, "prim, int", repetitions);
+  double* times = malloc(sizeof(double) * 2 * repetitions);
+  for (WeightType type = 0; type < WEIGHT_NUM_TYPES; type++) {
+    TypedGraph* typed = typedGraphFromCSR(graph, type);
+    for (int r = 0; r < repetitions; r++) {
+      double start = clockNow();
+      deleteTypedTree(typedShortestPaths(typed, 0));
+      times[r] = clockNow() - start;
+      start = clockNow();
+      deleteTypedTree(typedPrimMST(typed, 0));
+      times[repetitions + r] = clockNow() - start;
+    }
+    for (int alg = 0; alg < 2; alg++) {
+      double* algTimes = times + alg * repetitions;
+      qsort(algTimes, repetitions, sizeof(double), compareDoubles);
+      char label[64];
+      snprintf(label, sizeof(label), "%s, %s", alg ? "prim" : "dijkstra",
+               weightTypeName(type));
+      printf("  %-24s min %8.3f ms   median %8.3f ms\n", label,
+             algTimes[0] * 1e3, algTimes[repetitions / 2] * 1e3);
+    }
+    deleteTypedGraph(typed);
+  }
+  free(times);
+  deleteCSRGraph(graph);
+  printf("\n");
+}
+
+/* Returns the median of 'repetitions' runs of Dijkstra's algorithm (if
+ * 'prim' is false) or Prim's algorithm on 'graph' from 'startVertex', in
+ * seconds.
+ */
+double medianRun(Graph* graph, int startVertex, bool prim, int repetitions) {
+  double* times = malloc(sizeof(double) * repetitions);
+  for (int r = 0; r < repetitions; r++) {
+    double start = clockNow();
+    free(prim ? primGetMST(graph, startVertex)
+              : getShortestPaths(graph, startVertex));
+    times[r] = clockNow() - start;
+  }
+  qsort(times, repetitions, sizeof(double), compareDoubles);
+  double median = times[repetitions / 2];
+  free(times);
+  return median;
+}
+
+/* Times Dijkstra's and Prim's algorithms on a road network of about
+ * 'numVertices' vertices whose IDs were shuffled, as they might come from a
+ * file, and again after each vertex reordering.
+ */
+void benchReordering(int numVertices, int repetitions) {
+  EdgeList* list = generateGraph(GEN_ROAD, numVertices, 4, 1000, 5);
+  Graph* road = graphFromEdgeList(list);
+  deleteEdgeList(list);
+  numVertices = road->numVertices;
+  // a random permutation, shuffled by Fisher-Yates
+  Permutation* shuffle = malloc(sizeof(Permutation));
+  shuffle->numVertices = numVertices;
+  shuffle->oldIds = malloc(sizeof(int) * numVertices);
+  shuffle->newIds = malloc(sizeof(int) * numVertices);
+  uint64_t state = 11;
+  for (int v = 0; v < numVertices; v++) {
+    int other = nextRandom(&state) % (v + 1);
+    shuffle->oldIds[v] = shuffle->oldIds[other];
+    shuffle->oldIds[other] = v;
+  }
+  for (int v = 0; v < numVertices; v++) {
+    shuffle->newIds[shuffle->oldIds[v]] = v;
+  }
+  Graph* input = permuteGraph(road, shuffle);
+  deletePermutation(shuffle);
+  deleteGraph(road);
+  CSRGraph* csr = csrFromGraph(input);
+  printf("Vertex orders, road network of %d vertices, shuffled IDs:\n",
+         numVertices);
+  printf("  %-24s gap %10.1f   dijkstra %8.3f ms   prim %8.3f ms\n",
+         "input order", meanNeighbourGap(csr),
+         medianRun(input, 0, false, repetitions) * 1e3,
+         medianRun(input, 0, true, repetitions) * 1e3);
+  for (VertexOrder order = 0; order < ORDER_NUM_KINDS; order++) {
+    double start = clockNow();
+    Permutation* permutation = vertexOrder(csr, order);
+    Graph* graph = permuteGraph(input, permutation);
+    double elapsed = clockNow() - start;
+    CSRGraph* permuted = permuteCSRGraph(csr, permutation);
+    int startVertex = permutation->newIds[0];
+    char label[64];
+    snprintf(label, sizeof(label), "%s (%.0f ms)", vertexOrderName(order),
+             elapsed * 1e3);
+    printf("  %-24s gap %10.1f   dijkstra %8.3f ms   prim %8.3f ms\n",
+           label, meanNeighbourGap(permuted),
+           medianRun(graph, startVertex, false, repetitions) * 1e3,
+           medianRun(graph, startVertex, true, repetitions) * 1e3);
+    deleteCSRGraph(permuted);
+    deleteGraph(graph);
+    deletePermutation(permutation);
+  }
+  deleteCSRGraph(csr);
+  deleteGraph(input);
+  printf("\n");
+}
+
+/* Times Dijkstra's algorithm on CSR graphs of high degree, where most of
+ * the time goes to relaxing edges, with each edge relaxation kernel this
+ * CPU supports: a random graph of 'numVertices' / 4 vertices and average
+ * degree 64, and a power-law graph of 'numVertices' vertices and average
+ * degree 32.
+ */
+void benchRelaxKernels(int numVertices, int repetitions) {
+  int sizes[2] = {numVertices / 4 > 1 ? numVertices / 4 : 2, numVertices};
+  const char* names[2] = {"random, degree 64", "power-law, degree 32"};
+  AlgoOptions lazy = {PQ_DARY_HEAP, true, NULL};
+  for (int g = 0; g < 2; g++) {
+    CSRGraph* graph;
+    if (g == 0) {
+      graph = generateCSR(GEN_RANDOM, sizes[g], 64, 1000, 17);
+    } else {
+      graph = generateCSR(GEN_POWER_LAW, sizes[g], 32, 1000, 17);
+    }
+    printf("Relaxation kernels, %s, %d vertices:\n", names[g],
+           graph->numVertices);
+    for (RelaxKernel kernel = 0; kernel < RELAX_NUM_KERNELS; kernel++) {
+      if (!setRelaxKernel(kernel)) continue;
+      char label[64];
+      snprintf(label, sizeof(label), "dijkstra, %s", relaxKernelName(kernel));
+      timeAlgorithm(dijkstraFromZero, graph, &lazy, label, repetitions);
+    }
+    deleteCSRGraph(graph);
+    printf("\n");
+  }
+  setRelaxKernel(bestRelaxKernel());
+}
+
+int main(int argc, char* argv[]) {
+  int numVertices = argc > 1 ? atoi(argv[1]) : DEFAULT_VERTICES;
+  int averageDegree = argc > 2 ? atoi(argv[2]) : DEFAULT_DEGREE;
+  int repetitions = argc > 3 ? atoi(argv[3]) : DEFAULT_REPETITIONS;
+  int maxThreads = threadCount(argc > 4 ? atoi(argv[4]) : 0);
+  if (numVertices < 1 || averageDegree < 1 || repetitions < 1) {
+    printf(
+        "Usage: %s [numVertices] [averageDegree] [repetitions] "
+        "[maxThreads]\n",
+        argv[0]);
+    return 1;
+  }
+
+  int maxWeights[] = {16, 1000000};
+  const char* names[] = {"narrow (1..16)", "wide (1..10^6)"};
+  for (int w = 0; w < 2; w++) {
+    CSRGraph* graph = generateCSR(GEN_RANDOM, numVertices, averageDegree,
+                                  maxWeights[w], 42 + w);
+    printf("Shortest paths, %d vertices, %d slots, weights %s (delta %d):\n",
+           numVertices, graph->numEdges, names[w], chooseDelta(graph));
+
+    for (PQKind kind = 0; kind < PQ_NUM_KINDS; kind++) {
+      for (int lazy = 0; lazy <= 1; lazy++) {
+        AlgoOptions options = {kind, lazy, NULL};
+        char label[64];
+        snprintf(label, sizeof(label), "%s%s", pqOpsFor(kind)->name,
+                 lazy ? ", lazy" : "");
+        timeAlgorithm(dijkstraFromZero, graph, &options, label,
+                      repetitions);
+      }
+    }
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+      AlgoOptions options = {PQ_DARY_HEAP, false, NULL, threads};
+      char label[64];
+      snprintf(label, sizeof(label), "delta-stepping, %d thr", threads);
+      timeAlgorithm(deltaFromZero, graph, &options, label, repetitions);
+    }
+    printf("\n");
+
+    printf("Shortest paths from %d sources, same graph:\n", BATCH_SOURCES);
+    int startVertices[BATCH_SOURCES];
+    uint64_t state = 7 + w;
+    for (int i = 0; i < BATCH_SOURCES; i++) {
+      startVertices[i] = nextRandom(&state) % numVertices;
+    }
+    timeSources(graph, startVertices, BATCH_SOURCES, NULL, "one call each");
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+      AlgoOptions options = {PQ_DARY_HEAP, false, NULL, threads};
+      char label[64];
+      snprintf(label, sizeof(label), "batch, %d thread%s", threads,
+               threads > 1 ? "s" : "");
+      timeSources(graph, startVertices, BATCH_SOURCES, &options, label);
+    }
+    printf("\n");
+
+    printf("Point-to-point queries, same graph:\n");
+    int targetVertices[BATCH_SOURCES];
+    for (int i = 0; i < BATCH_SOURCES; i++) {
+      targetVertices[i] = nextRandom(&state) % numVertices;
+    }
+    AlgoOptions forward = {PQ_DARY_HEAP};
+    AlgoOptions bidirectional = {PQ_DARY_HEAP, .bidirectional = true};
+    timeQueries(graph, startVertices, targetVertices, BATCH_SOURCES, NULL,
+                NULL, "whole tree");
+    timeQueries(graph, startVertices, targetVertices, BATCH_SOURCES, &forward,
+                NULL, "early exit");
+    timeQueries(graph, startVertices, targetVertices, BATCH_SOURCES,
+                &bidirectional, NULL, "bidirectional");
+    double start = clockNow();
+    Landmarks* landmarks = newLandmarks(graph, NUM_LANDMARKS, NULL);
+    printf("  %-24s total %8.3f ms\n", "ALT preprocessing",
+           (clockNow() - start) * 1e3);
+    timeQueries(graph, startVertices, targetVertices, BATCH_SOURCES, &forward,
+                landmarks, "ALT (A*)");
+    deleteLandmarks(landmarks);
+    printf("\n");
+
+    printf("MST, same graph:\n");
+    AlgoOptions defaults = {PQ_DARY_HEAP, false, NULL};
+    timeAlgorithm(primFromZero, graph, &defaults, "prim (d-ary heap)",
+                  repetitions);
+    timeAlgorithm(filterKruskalGetMSTCSR, graph, &defaults, "filter-kruskal",
+                  repetitions);
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+      AlgoOptions options = {PQ_DARY_HEAP, false, NULL, threads};
+      char label[64];
+      snprintf(label, sizeof(label), "kruskal, %d thread%s", threads,
+               threads > 1 ? "s" : "");
+      timeAlgorithm(kruskalGetMSTCSR, graph, &options, label, repetitions);
+      snprintf(label, sizeof(label), "boruvka, %d thread%s", threads,
+               threads > 1 ? "s" : "");
+      timeAlgorithm(boruvkaGetMSTCSR, graph, &options, label, repetitions);
+    }
+    printf("\n");
+    deleteCSRGraph(graph);
+  }
+  benchHierarchy(numVertices);
+  benchDynamicMST(numVertices);
+  benchTreeRepair(numVertices);
+  benchPaths(numVertices);
+  benchWeightTypes(numVertices, averageDegree, repetitions);
+  benchReordering(numVertices, repetitions);
+  benchRelaxKernels(numVertices, repetitions);
+  return 0;
+}
@@ -0,0 +1,328 @@
+/*
+ * Our synthetic graph generators.
+ */
+
+#include "graph_gen.h"
+
+#include <limits.h>
+#include <string.h>
+
+// distance between neighbouring intersections of a road network
+#define ROAD_SPACING 100
+// intersections move up to this far from their grid position, each way
+#define ROAD_JITTER 30
+// every this many rows and columns, the street is a faster arterial
+#define ROAD_ARTERIAL_SPACING 16
+// chance, in percent, that a north-south side street is missing
+#define ROAD_MISSING_PERCENT 25
+
+static const char* familyNames[GEN_NUM_FAMILIES] = {"grid", "random",
+                                                    "powerlaw", "road"};
+
+/*************************************************************************
+ ** Helpers
+ *************************************************************************/
+
+/* Returns the next number from the xorshift64 generator with state
+ * 'state'.
+ */
+uint64_t nextRandom(uint64_t* state) {
+  uint64_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *state = x;
+  return x;
+}
+
+/* Returns a uniformly random number in 0 .. bound - 1 from 'state'. */
+static int randomBelow(uint64_t* state, long bound) {
+  return (int)(nextRandom(state) % (uint64_t)bound);
+}
+
+/* Returns the initial generator state for 'seed': a splitmix64 step, so
+ * that nearby seeds give unrelated streams and seed 0 still works.
+ */
+static uint64_t initialState(uint64_t seed) {
+  uint64_t z = seed + 0x9e3779b97f4a7c15ull;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  z ^= z >> 31;
+  return z != 0 ? z : 1;
+}
+
+/* Returns the largest integer whose square is at most 'x'. */
+static long squareRoot(long x) {
+  long low = 0;
+  long high = 3037000499L;  // floor(sqrt(LONG_MAX))
+  while (low < high) {
+    long middle = low + (high - low + 1) / 2;
+    if (middle <= x / middle) {
+      low = middle;
+    } else {
+      high = middle - 1;
+    }
+  }
+  return low;
+}
+
+/* Returns a newly created EdgeList on 'numVertices' vertices with room for
+ * 'capacity' edges.
+ */
+static EdgeList* newEdgeList(int numVertices, long capacity) {
+  EdgeList* list = malloc(sizeof(EdgeList));
+  list->numVertices = numVertices;
+  list->numEdges = 0;
+  list->edges = malloc(sizeof(Edge) * (capacity > 0 ? capacity : 1));
+  return list;
+}
+
+/* Appends the edge (u -- v, weight) to 'list'. */
+static void addEdge(EdgeList* list, int u, int v, int weight) {
+  list->edges[list->numEdges++] = (Edge){u, v, weight};
+}
+
+/*************************************************************************
+ ** Families
+ *************************************************************************/
+
+/* Returns a 'side' x 'side' grid with weights in 1 .. 'maxWeight'. */
+static EdgeList* gridEdges(int side, int maxWeight, uint64_t* state) {
+  EdgeList* list = newEdgeList(side * side, 2L * side * (side - 1));
+  for (int v = 0; v < side * side; v++) {
+    if (v % side + 1 < side) {
+      addEdge(list, v, v + 1, 1 + randomBelow(state, maxWeight));
+    }
+    if (v + side < side * side) {
+      addEdge(list, v, v + side, 1 + randomBelow(state, maxWeight));
+    }
+  }
+  return list;
+}
+
+/* Returns 'numEdges' edges on 'numVertices' vertices: a random spanning
+ * tree, each vertex joined to a random earlier one, and then edges between
+ * random pairs of distinct vertices, with weights in 1 .. 'maxWeight'.
+ */
+static EdgeList* randomEdges(int numVertices, long numEdges, int maxWeight,
+                             uint64_t* state) {
+  if (numVertices == 1) numEdges = 0;
+  EdgeList* list = newEdgeList(numVertices, numEdges);
+  for (int v = 1; v < numVertices; v++) {
+    addEdge(list, v, randomBelow(state, v), 1 + randomBelow(state, maxWeight));
+  }
+  while (list->numEdges < numEdges) {
+    int u = randomBelow(state, numVertices);
+    int v = randomBelow(state, numVertices);
+    if (u != v) addEdge(list, u, v, 1 + randomBelow(state, maxWeight));
+  }
+  return list;
+}
+
+/* Returns a preferential attachment graph on 'numVertices' vertices in
+ * which each new vertex joins up to 'perVertex' distinct earlier vertices,
+ * with weights in 1 .. 'maxWeight'.
+ */
+static EdgeList* powerLawEdges(int numVertices, int perVertex, int maxWeight,
+                               uint64_t* state) {
+  long capacity = (long)(numVertices - 1) * perVertex;
+  EdgeList* list = newEdgeList(numVertices, capacity);
+  // every endpoint of every edge so far: a vertex appears once per unit of
+  // degree, so a uniform pick from here is proportional to degree
+  int* endpoints = malloc(sizeof(int) * (2 * capacity > 0 ? 2 * capacity : 1));
+  long numEndpoints = 0;
+  int* picked = malloc(sizeof(int) * perVertex);
+  for (int v = 1; v < numVertices; v++) {
+    int count = v < perVertex ? v : perVertex;
+    int numPicked = 0;
+    for (int attempt = 0; numPicked < count && attempt < 4 * count;
+         attempt++) {
+      int u = numEndpoints > 0 ? endpoints[randomBelow(state, numEndpoints)]
+                               : randomBelow(state, v);
+      bool repeated = false;
+      for (int i = 0; i < numPicked; i++) {
+        repeated = repeated || picked[i] == u;
+      }
+      if (repeated) continue;
+      picked[numPicked++] = u;
+      addEdge(list, v, u, 1 + randomBelow(state, maxWeight));
+    }
+    // only now may later vertices pick v, so it never picks itself
+    for (int i = 0; i < numPicked; i++) {
+      endpoints[numEndpoints++] = v;
+      endpoints[numEndpoints++] = picked[i];
+    }
+  }
+  free(picked);
+  free(endpoints);
+  return list;
+}
+
+/* Returns the travel time of the street from (x1, y1) to (x2, y2), at
+ * 'speed' times the speed of a side street, scaled so that a side street
+ * of length ROAD_SPACING takes 'maxWeight'.
+ */
+static int travelTime(int x1, int y1, int x2, int y2, int speed,
+                      int maxWeight) {
+  long dx = x2 - x1;
+  long dy = y2 - y1;
+  long time = squareRoot(dx * dx + dy * dy) * maxWeight /
+              ((long)ROAD_SPACING * speed);
+  return time > 0 ? (int)time : 1;
+}
+
+/* Returns a 'side' x 'side' road network: every row is a connected east-
+ * west street, the first column and every arterial column run north-south,
+ * and ROAD_MISSING_PERCENT of the other north-south blocks are missing.
+ */
+static EdgeList* roadEdges(int side, int maxWeight, uint64_t* state) {
+  int numVertices = side * side;
+  int* x = malloc(sizeof(int) * numVertices);
+  int* y = malloc(sizeof(int) * numVertices);
+  for (int v = 0; v < numVertices; v++) {
+    x[v] = v % side * ROAD_SPACING - ROAD_JITTER +
+           randomBelow(state, 2 * ROAD_JITTER + 1);
+    y[v] = v / side * ROAD_SPACING - ROAD_JITTER +
+           randomBelow(state, 2 * ROAD_JITTER + 1);
+  }
+  EdgeList* list = newEdgeList(numVertices, 2L * side * (side - 1));
+  for (int v = 0; v < numVertices; v++) {
+    int row = v / side;
+    int column = v % side;
+    if (column + 1 < side) {
+      int speed = row % ROAD_ARTERIAL_SPACING == 0 ? 2 : 1;
+      addEdge(list, v, v + 1,
+              travelTime(x[v], y[v], x[v + 1], y[v + 1], speed, maxWeight));
+    }
+    if (row + 1 < side) {
+      bool arterial = column % ROAD_ARTERIAL_SPACING == 0;
+      if (!arterial && randomBelow(state, 100) < ROAD_MISSING_PERCENT) {
+        continue;
+      }
+      addEdge(list, v, v + side,
+              travelTime(x[v], y[v], x[v + side], y[v + side],
+                         arterial ? 2 : 1, maxWeight));
+    }
+  }
+  free(x);
+  free(y);
+  return list;
+}
+
+/*************************************************************************
+ ** Interface
+ *************************************************************************/
+
+/* Returns the family whose name (see graph_gen.h) is 'name', or
+ * GEN_NUM_FAMILIES if there is none.
+ */
+GraphFamily graphFamilyNamed(const char* name) {
+  for (int family = 0; family < GEN_NUM_FAMILIES; family++) {
+    if (strcmp(name, familyNames[family]) == 0) return family;
+  }
+  return GEN_NUM_FAMILIES;
+}
+
+/* Returns the name of 'family', or NULL if there is no such family. */
+const char* graphFamilyName(GraphFamily family) {
+  if (family < 0 || family >= GEN_NUM_FAMILIES) return NULL;
+  return familyNames[family];
+}
+
+/* Returns a newly created graph of 'family' with about 'numVertices'
+ * vertices and 'averageDegree' neighbours per vertex, weights up to
+ * 'maxWeight', generated from 'seed'. Grids and road networks round
+ * 'numVertices' down to a square and ignore 'averageDegree'; the other
+ * families may round the number of edges to keep the graph connected.
+ * Returns NULL if 'family' is not a family, a parameter is less than 1, or
+ * the graph would have more than INT_MAX / 2 edges.
+ */
+EdgeList* generateGraph(GraphFamily family, int numVertices,
+                        int averageDegree, int maxWeight, uint64_t seed) {
+  if (family < 0 || family >= GEN_NUM_FAMILIES || numVertices < 1 ||
+      averageDegree < 1 || maxWeight < 1) {
+    return NULL;
+  }
+  int side = (int)squareRoot(numVertices);
+  long numEdges = (long)numVertices * averageDegree / 2;
+  if (numEdges < numVertices - 1) numEdges = numVertices - 1;
+  int perVertex = averageDegree / 2 > 0 ? averageDegree / 2 : 1;
+  long maxEdges = family == GEN_GRID || family == GEN_ROAD
+                      ? 2L * side * side
+                  : family == GEN_POWER_LAW ? (long)numVertices * perVertex
+                                            : numEdges;
+  if (maxEdges > INT_MAX / 2) return NULL;
+
+  uint64_t state = initialState(seed);
+  switch (family) {
+    case GEN_GRID:
+      return gridEdges(side, maxWeight, &state);
+    case GEN_RANDOM:
+      return randomEdges(numVertices, numEdges, maxWeight, &state);
+    case GEN_POWER_LAW:
+      return powerLawEdges(numVertices, perVertex, maxWeight, &state);
+    case GEN_ROAD:
+      return roadEdges(side, maxWeight, &state);
+    default:
+      return NULL;
+  }
+}
+
+/* Frees memory allocated for 'list'.
+ */
+void deleteEdgeList(EdgeList* list) {
+  if (list == NULL) return;
+  free(list->edges);
+  free(list);
+}
+
+/* Returns a newly created CSRGraph of 'list', each edge stored in the
+ * adjacency of both its endpoints.
+ */
+CSRGraph* csrFromEdgeList(EdgeList* list) {
+  int numVertices = list->numVertices;
+  CSRGraph* csr = newCSRGraph(numVertices, (int)(2 * list->numEdges));
+  // counting sort on the endpoints: count, prefix-sum, then place
+  for (long i = 0; i < list->numEdges; i++) {
+    csr->offsets[list->edges[i].fromVertex + 1]++;
+    csr->offsets[list->edges[i].toVertex + 1]++;
+  }
+  for (int v = 0; v < numVertices; v++) {
+    csr->offsets[v + 1] += csr->offsets[v];
+  }
+  int* cursor = malloc(sizeof(int) * numVertices);
+  memcpy(cursor, csr->offsets, sizeof(int) * numVertices);
+  for (long i = 0; i < list->numEdges; i++) {
+    Edge edge = list->edges[i];
+    int slot = cursor[edge.fromVertex]++;
+    csr->targets[slot] = edge.toVertex;
+    csr->weights[slot] = edge.weight;
+    slot = cursor[edge.toVertex]++;
+    csr->targets[slot] = edge.fromVertex;
+    csr->weights[slot] = edge.weight;
+  }
+  free(cursor);
+  return csr;
+}
+
+/* Returns a newly created arena-backed Graph of 'list', each edge in the
+ * adjacency lists of both its endpoints.
+ */
+Graph* graphFromEdgeList(EdgeList* list) {
+  Graph* graph = newArenaGraph(list->numVertices);
+  for (int v = 0; v < list->numVertices; v++) {
+    graph->vertices[v].id = v;
+    graph->vertices[v].value = NULL;
+  }
+  for (long i = 0; i < list->numEdges; i++) {
+    Edge edge = list->edges[i];
+    Vertex* from = &graph->vertices[edge.fromVertex];
+    Vertex* to = &graph->vertices[edge.toVertex];
+    from->adjList = prependEdge(graph, from->adjList, edge.fromVertex,
+                                edge.toVertex, edge.weight);
+    to->adjList = prependEdge(graph, to->adjList, edge.toVertex,
+                              edge.fromVertex, edge.weight);
+    graph->numEdges += 2;
+  }
+  return graph;
+}
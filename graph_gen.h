@@ -0,0 +1,83 @@
+/*
+ * Header file for our synthetic graph generators.
+ *
+ * Every generator is driven by a seeded xorshift64 generator, so the same
+ * family, size and seed always give the same graph. All graphs are
+ * undirected and connected, with non-negative weights:
+ *   grid      a side x side grid, each vertex joined to its horizontal and
+ *             vertical neighbours; weights uniform in 1 .. maxWeight
+ *   random    G(n, m): a random spanning tree plus edges between uniformly
+ *             random vertex pairs; weights uniform in 1 .. maxWeight
+ *   powerlaw  preferential attachment (Barabasi-Albert): each new vertex
+ *             joins vertices picked with probability proportional to their
+ *             degree, giving a few hubs of very high degree
+ *   road      a jittered grid with some streets missing and a faster
+ *             arterial every ROAD_ARTERIAL_SPACING blocks (see graph_gen.c);
+ *             weights are travel times from the Euclidean lengths, scaled
+ *             so the slowest street of unit length costs maxWeight
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "csr.h"
+#include "graph.h"
+
+#ifndef __Graph_Gen_header
+#define __Graph_Gen_header
+
+typedef enum graph_family {
+  GEN_GRID = 0,   // grid
+  GEN_RANDOM,     // G(n, m) around a random spanning tree
+  GEN_POWER_LAW,  // preferential attachment
+  GEN_ROAD,       // jittered grid with arterials
+  GEN_NUM_FAMILIES
+} GraphFamily;
+
+typedef struct edge_list {
+  int numVertices;  // vertices are 0, 1, ..., numVertices-1
+  long numEdges;    // number of undirected edges
+  Edge* edges;      // edges[i] is undirected edge i, stored once
+} EdgeList;
+
+/* Returns the family whose name (see above) is 'name', or
+ * GEN_NUM_FAMILIES if there is none.
+ */
+GraphFamily graphFamilyNamed(const char* name);
+
+/* Returns the name of 'family', or NULL if there is no such family. */
+const char* graphFamilyName(GraphFamily family);
+
+/* Returns a newly created graph of 'family' with about 'numVertices'
+ * vertices and 'averageDegree' neighbours per vertex, weights up to
+ * 'maxWeight', generated from 'seed'. Grids and road networks round
+ * 'numVertices' down to a square and ignore 'averageDegree'; the other
+ * families may round the number of edges to keep the graph connected.
+ * Returns NULL if 'family' is not a family, a parameter is less than 1, or
+ * the graph would have more than INT_MAX / 2 edges.
+ */
+EdgeList* generateGraph(GraphFamily family, int numVertices,
+                        int averageDegree, int maxWeight, uint64_t seed);
+
+/* Frees memory allocated for 'list'.
+ */
+void deleteEdgeList(EdgeList* list);
+
+/* Returns the next number from the xorshift64 generator with state
+ * 'state'.
+ */
+uint64_t nextRandom(uint64_t* state);
+
+/* Returns a newly created CSRGraph of 'list', each edge stored in the
+ * adjacency of both its endpoints.
+ */
+CSRGraph* csrFromEdgeList(EdgeList* list);
+
+/* Returns a newly created arena-backed Graph of 'list', each edge in the
+ * adjacency lists of both its endpoints.
+ */
+Graph* graphFromEdgeList(EdgeList* list);
+
+#endif
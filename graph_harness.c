@@ -0,0 +1,237 @@
+/*
+ *  Reproducible benchmark harness: generates a seeded graph, then times
+ *  loading it and running primGetMST, getShortestPaths and getPaths on it,
+ *  each phase separately, after warmup runs.
+ *
+ *  ---------------------------------------------------------------------------
+ *   Compile:
+ *   make harness
+ *
+ *   Run:
+ *   ./harness family numVertices [averageDegree] [repetitions] [warmups]
+ *             [seed] [resultsFile]
+ *
+ *   'family' is grid, random, powerlaw or road (see graph_gen.h). The
+ *   snapshot is memory mapped, so its load time covers only the mapping. If
+ *   'resultsFile' is given, one CSV row per phase is appended to it:
+ *     family,vertices,edges,seed,phase,repetitions,min_ms,median_ms,p99_ms,
+ *     max_ms
+ *  ---------------------------------------------------------------------------
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "csr.h"
+#include "graph.h"
+#include "graph_algos.h"
+#include "graph_gen.h"
+#include "graph_io.h"
+#include "pathtree.h"
+#include "snapshot.h"
+#include "stats.h"
+
+#define DEFAULT_DEGREE 8
+#define DEFAULT_REPETITIONS 5
+#define DEFAULT_WARMUPS 1
+#define DEFAULT_SEED 1
+#define MAX_WEIGHT 1000
+// getPaths and materializePaths allocate memory per hop of every path; past
+// this many hops in total they are skipped
+#define MAX_PATH_HOPS 50000000L
+
+typedef struct harness {
+  const char* family;     // name of the graph family
+  int numVertices;        // number of vertices of the graph
+  long numEdges;          // number of undirected edges of the graph
+  uint64_t seed;          // seed the graph was generated from
+  int repetitions;        // number of timed runs of each phase
+  int warmups;            // number of untimed runs before them
+  FILE* results;          // CSV output, or NULL
+  char textPath[32];      // the graph as a text file
+  char snapshotPath[40];  // the graph as a snapshot
+  Graph* graph;           // the graph, loaded from the text file
+  Edge* tree;             // distance tree of 'graph' from vertex 0
+} Harness;
+
+/* A phase under test: returns what it built from 'harness'. */
+typedef void* (*PhaseRun)(Harness* harness);
+
+/* Frees 'result', built by the matching PhaseRun. */
+typedef void (*PhaseFree)(Harness* harness, void* result);
+
+/* Runs 'run' harness->warmups times untimed and harness->repetitions times
+ * timed, freeing each result with 'release' outside the timing, and
+ * reports the times under 'name'.
+ */
+void timePhase(Harness* harness, const char* name, PhaseRun run,
+               PhaseFree release) {
+  int repetitions = harness->repetitions;
+  double* times = malloc(sizeof(double) * repetitions);
+  for (int r = 0; r < harness->warmups; r++) {
+    release(harness, run(harness));
+  }
+  for (int r = 0; r < repetitions; r++) {
+    double start = clockNow();
+    void* result = run(harness);
+    times[r] = clockNow() - start;
+    release(harness, result);
+  }
+  qsort(times, repetitions, sizeof(double), compareDoubles);
+  // nearest-rank percentile: the smallest time at least 99% of runs reach
+  int p99 = (99 * repetitions + 99) / 100 - 1;
+  double min = times[0] * 1e3;
+  double median = times[repetitions / 2] * 1e3;
+  double high = times[p99] * 1e3;
+  double max = times[repetitions - 1] * 1e3;
+  printf("  %-16s min %9.3f ms   median %9.3f ms   p99 %9.3f ms\n", name,
+         min, median, high);
+  if (harness->results != NULL) {
+    fprintf(harness->results, "%s,%d,%ld,%llu,%s,%d,%.3f,%.3f,%.3f,%.3f\n",
+            harness->family, harness->numVertices, harness->numEdges,
+            (unsigned long long)harness->seed, name, repetitions, min,
+            median, high, max);
+  }
+  free(times);
+}
+
+/***** Phases ***************************************************************/
+
+void* loadText(Harness* harness) { return loadGraph(harness->textPath, NULL); }
+
+void freeGraph(Harness* harness, void* graph) { deleteGraph(graph); }
+
+void* loadSnapshot(Harness* harness) {
+  return loadCSRSnapshot(harness->snapshotPath, false, NULL);
+}
+
+void freeCSRGraph(Harness* harness, void* graph) { deleteCSRGraph(graph); }
+
+void* runPrim(Harness* harness) { return primGetMST(harness->graph, 0); }
+
+void* runDijkstra(Harness* harness) {
+  return getShortestPaths(harness->graph, 0);
+}
+
+void freeTree(Harness* harness, void* tree) { free(tree); }
+
+void* runGetPaths(Harness* harness) {
+  return getPaths(harness->tree, harness->numVertices, 0);
+}
+
+void freePaths(Harness* harness, void* paths) {
+  deletePaths(paths, harness->numVertices);
+}
+
+void* runPathTree(Harness* harness) {
+  PathTree* tree = newPathTree(harness->tree, harness->numVertices, 0);
+  PathBuffer* buffer = materializePaths(tree);
+  deletePathTree(tree);
+  return buffer;
+}
+
+void freePathBuffer(Harness* harness, void* buffer) {
+  deletePathBuffer(buffer);
+}
+
+/* Returns the total number of edges on all paths of 'tree'. */
+long totalHops(Edge* tree, int numVertices) {
+  PathTree* paths = newPathTree(tree, numVertices, 0);
+  int* hops = pathTreeHopCounts(paths);
+  long total = 0;
+  for (int v = 0; v < numVertices; v++) total += hops[v];
+  free(hops);
+  deletePathTree(paths);
+  return total;
+}
+
+/***** Driver ***************************************************************/
+
+/* Writes the graph of 'list' to temporary text and snapshot files named in
+ * 'harness'. Returns false if that fails.
+ */
+bool writeInputs(Harness* harness, EdgeList* list) {
+  snprintf(harness->textPath, sizeof(harness->textPath),
+           "/tmp/harness-XXXXXX");
+  int fd = mkstemp(harness->textPath);
+  if (fd < 0) return false;
+  close(fd);
+  snprintf(harness->snapshotPath, sizeof(harness->snapshotPath), "%s.csr",
+           harness->textPath);
+  CSRGraph* csr = csrFromEdgeList(list);
+  LoadError error;
+  bool written = writeCSRGraphText(csr, harness->textPath, &error) &&
+                 writeCSRSnapshot(csr, harness->snapshotPath, &error);
+  if (!written) printLoadError(stderr, "harness", &error);
+  deleteCSRGraph(csr);
+  return written;
+}
+
+int main(int argc, char* argv[]) {
+  GraphFamily family =
+      argc > 1 ? graphFamilyNamed(argv[1]) : GEN_NUM_FAMILIES;
+  int numVertices = argc > 2 ? atoi(argv[2]) : 0;
+  int averageDegree = argc > 3 ? atoi(argv[3]) : DEFAULT_DEGREE;
+  Harness harness = {graphFamilyName(family)};
+  harness.repetitions = argc > 4 ? atoi(argv[4]) : DEFAULT_REPETITIONS;
+  harness.warmups = argc > 5 ? atoi(argv[5]) : DEFAULT_WARMUPS;
+  harness.seed = argc > 6 ? strtoull(argv[6], NULL, 10) : DEFAULT_SEED;
+  if (family == GEN_NUM_FAMILIES || numVertices < 1 || averageDegree < 1 ||
+      harness.repetitions < 1 || harness.warmups < 0) {
+    printf(
+        "Usage: %s grid|random|powerlaw|road numVertices [averageDegree] "
+        "[repetitions] [warmups] [seed] [resultsFile]\n",
+        argv[0]);
+    return 1;
+  }
+
+  double start = clockNow();
+  EdgeList* list = generateGraph(family, numVertices, averageDegree,
+                                 MAX_WEIGHT, harness.seed);
+  if (list == NULL) {
+    printf("Graph too large\n");
+    return 1;
+  }
+  harness.numVertices = list->numVertices;
+  harness.numEdges = list->numEdges;
+  printf("%s graph, %d vertices, %ld edges, seed %llu: generated in %.3f ms\n",
+         harness.family, harness.numVertices, harness.numEdges,
+         (unsigned long long)harness.seed, (clockNow() - start) * 1e3);
+  bool written = writeInputs(&harness, list);
+  deleteEdgeList(list);
+  if (!written) return 1;
+
+  if (argc > 7) {
+    harness.results = fopen(argv[7], "a");
+    if (harness.results == NULL) {
+      perror(argv[7]);
+    } else if (ftell(harness.results) == 0) {
+      fprintf(harness.results,
+              "family,vertices,edges,seed,phase,repetitions,min_ms,"
+              "median_ms,p99_ms,max_ms\n");
+    }
+  }
+
+  timePhase(&harness, "load (text)", loadText, freeGraph);
+  timePhase(&harness, "load (snapshot)", loadSnapshot, freeCSRGraph);
+  harness.graph = loadGraph(harness.textPath, NULL);
+  timePhase(&harness, "primGetMST", runPrim, freeTree);
+  timePhase(&harness, "getShortestPaths", runDijkstra, freeTree);
+  harness.tree = getShortestPaths(harness.graph, 0);
+  long hops = totalHops(harness.tree, harness.numVertices);
+  if (hops <= MAX_PATH_HOPS) {
+    timePhase(&harness, "getPaths", runGetPaths, freePaths);
+    timePhase(&harness, "PathTree", runPathTree, freePathBuffer);
+  } else {
+    printf("  getPaths, PathTree skipped: %ld hops in all paths\n", hops);
+  }
+
+  free(harness.tree);
+  deleteGraph(harness.graph);
+  if (harness.results != NULL) fclose(harness.results);
+  unlink(harness.textPath);
+  unlink(harness.snapshotPath);
+  return 0;
+}
@@ -0,0 +1,570 @@
+/*
+ * Our graph file loaders.
+ *
+ * The whole input is mapped into memory and scanned once with a hand-rolled
+ * integer scanner; there is no line buffer, so adjacency lines may be
+ * arbitrarily long. The scanner reports what it read to a LoadSink, which
+ * builds either a Graph or a CSRGraph.
+ */
+
+#include "graph_io.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define READ_CHUNK (1 << 20)
+
+/*************************************************************************
+ ** Input buffers
+ *************************************************************************/
+
+typedef struct input_buffer {
+  const char* data;    // the file contents
+  size_t size;         // number of bytes in 'data'
+  void* mapping;       // start of the mmap'd region, or NULL
+  size_t mappingSize;  // length of the mmap'd region
+  char* owned;         // malloc'd copy of the contents, or NULL
+} InputBuffer;
+
+/* Records the failure described by 'format' in 'error', if not NULL, at
+ * 'line', 'column' and 'offset'.
+ */
+void setLoadError(LoadError* error, long line, long column, size_t offset,
+                  const char* format, ...) {
+  if (error == NULL) return;
+  error->failed = true;
+  error->line = line;
+  error->column = column;
+  error->offset = offset;
+  va_list args;
+  va_start(args, format);
+  vsnprintf(error->message, LOAD_ERROR_MESSAGE_LIMIT, format, args);
+  va_end(args);
+}
+
+/* Reads all of 'fd' into a malloc'd buffer in 'input'. Returns false and
+ * fills in 'error' on failure.
+ */
+static bool readInput(int fd, InputBuffer* input, LoadError* error) {
+  size_t capacity = READ_CHUNK;
+  size_t size = 0;
+  char* buffer = malloc(capacity);
+  while (buffer != NULL) {
+    if (size == capacity) {
+      capacity *= 2;
+      char* bigger = realloc(buffer, capacity);
+      if (bigger == NULL) break;
+      buffer = bigger;
+    }
+    ssize_t got = read(fd, buffer + size, capacity - size);
+    if (got < 0 && errno == EINTR) continue;
+    if (got < 0) {
+      setLoadError(error, 0, 0, size, "Could not read input: %s",
+                   strerror(errno));
+      free(buffer);
+      return false;
+    }
+    if (got == 0) {
+      input->data = buffer;
+      input->size = size;
+      input->owned = buffer;
+      return true;
+    }
+    size += got;
+  }
+  free(buffer);
+  setLoadError(error, 0, 0, size, "Could not allocate memory for the input");
+  return false;
+}
+
+/* Makes the contents of the file open as 'fd' available in 'input', by
+ * mapping it if possible and by reading it otherwise. Returns false and
+ * fills in 'error' on failure.
+ */
+static bool openInput(int fd, InputBuffer* input, LoadError* error) {
+  struct stat info;
+  input->data = NULL;
+  input->size = 0;
+  input->mapping = NULL;
+  input->mappingSize = 0;
+  input->owned = NULL;
+  if (fstat(fd, &info) != 0) {
+    setLoadError(error, 0, 0, 0, "Could not stat input: %s",
+                 strerror(errno));
+    return false;
+  }
+  if (!S_ISREG(info.st_mode)) {
+    return readInput(fd, input, error);
+  }
+  if (info.st_size == 0) {
+    input->data = "";
+    return true;
+  }
+  void* mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (mapping == MAP_FAILED) {
+    if (lseek(fd, 0, SEEK_SET) != 0) {
+      setLoadError(error, 0, 0, 0, "Could not map input: %s",
+                   strerror(errno));
+      return false;
+    }
+    return readInput(fd, input, error);
+  }
+  madvise(mapping, info.st_size, MADV_SEQUENTIAL);
+  input->data = mapping;
+  input->size = info.st_size;
+  input->mapping = mapping;
+  input->mappingSize = info.st_size;
+  return true;
+}
+
+/* Releases the contents held by 'input'. */
+static void closeInput(InputBuffer* input) {
+  if (input->mapping != NULL) munmap(input->mapping, input->mappingSize);
+  free(input->owned);
+}
+
+/*************************************************************************
+ ** Scanning
+ *************************************************************************/
+
+typedef struct scanner {
+  const char* base;       // first byte of the input
+  const char* pos;        // next byte to scan
+  const char* end;        // one past the last byte of the input
+  const char* lineStart;  // first byte of the current line
+  long line;              // 1-based number of the current line
+  LoadError* error;       // where to report failures; may be NULL
+} Scanner;
+
+typedef struct load_sink {
+  void* context;
+  bool (*start)(void* context, int numVertices);
+  void (*beginVertex)(void* context, int id);
+  bool (*addEdge)(void* context, int fromVertex, int toVertex, int weight);
+  void (*endVertex)(void* context, int id);
+} LoadSink;
+
+/* Records the failure described by 'format' at position 'at' of scanner
+ * 's'. Always returns false.
+ */
+static bool scanError(Scanner* s, const char* at, const char* format, ...) {
+  char message[LOAD_ERROR_MESSAGE_LIMIT];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(message, LOAD_ERROR_MESSAGE_LIMIT, format, args);
+  va_end(args);
+  setLoadError(s->error, s->line, (long)(at - s->lineStart) + 1,
+               (size_t)(at - s->base), "%s", message);
+  return false;
+}
+
+/* Advances 's' past spaces, tabs and carriage returns. */
+static inline void skipBlanks(Scanner* s) {
+  while (s->pos < s->end &&
+         (*s->pos == ' ' || *s->pos == '\t' || *s->pos == '\r')) {
+    s->pos++;
+  }
+}
+
+/* Returns true iff 's' is at the end of a line or of the input. */
+static inline bool atLineEnd(Scanner* s) {
+  return s->pos == s->end || *s->pos == '\n';
+}
+
+/* Advances 's' to the start of the next line. */
+static inline void nextLine(Scanner* s) {
+  if (s->pos < s->end) s->pos++;  // the '\n'
+  s->lineStart = s->pos;
+  s->line++;
+}
+
+/* Scans an optionally negative decimal integer described as 'what' from 's'
+ * into 'value'. Returns false and reports an error if there is none or it
+ * does not fit in an int.
+ */
+static inline bool scanInt(Scanner* s, const char* what, int* value) {
+  const char* start = s->pos;
+  const char* p = s->pos;
+  bool negative = false;
+  if (p < s->end && *p == '-') {
+    negative = true;
+    p++;
+  }
+  if (p == s->end || (unsigned)(*p - '0') > 9) {
+    if (start == s->end || *start == '\n') {
+      return scanError(s, start, "Could not read %s: unexpected end of line",
+                       what);
+    }
+    return scanError(s, start, "Could not read %s: unexpected character '%c'",
+                     what, *start);
+  }
+  long long result = 0;
+  while (p < s->end && (unsigned)(*p - '0') <= 9) {
+    result = result * 10 + (*p - '0');
+    if (result > (long long)INT_MAX + 1) {
+      return scanError(s, start, "Could not read %s: number out of range",
+                       what);
+    }
+    p++;
+  }
+  if (negative) result = -result;
+  if (result > INT_MAX || result < INT_MIN) {
+    return scanError(s, start, "Could not read %s: number out of range", what);
+  }
+  if (p < s->end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') {
+    return scanError(s, p, "Could not read %s: unexpected character '%c'",
+                     what, *p);
+  }
+  s->pos = p;
+  *value = (int)result;
+  return true;
+}
+
+/* Scans a vertex ID for a graph with 'numVertices' vertices from 's' into
+ * 'id'. Returns false and reports an error if it is missing or invalid.
+ */
+static inline bool scanVertexID(Scanner* s, int numVertices, int* id) {
+  const char* start = s->pos;
+  if (!scanInt(s, "vertex ID", id)) return false;
+  if (*id < 0 || *id >= numVertices) {
+    return scanError(s, start, "Invalid vertex ID: %d", *id);
+  }
+  return true;
+}
+
+/* Scans the whole input of 's' in the text graph format and reports its
+ * contents to 'sink'. Returns false and reports an error on failure.
+ */
+static bool scanGraph(Scanner* s, LoadSink* sink) {
+  int numVertices;
+  skipBlanks(s);
+  if (s->pos == s->end) {
+    return scanError(s, s->pos, "Could not read number of vertices");
+  }
+  const char* start = s->pos;
+  if (!scanInt(s, "number of vertices", &numVertices)) return false;
+  if (numVertices < 0) {
+    return scanError(s, start, "Number of vertices must be positive. Read: %d",
+                     numVertices);
+  }
+  skipBlanks(s);
+  if (!atLineEnd(s)) {
+    return scanError(s, s->pos, "Unexpected text after number of vertices");
+  }
+  if (!sink->start(sink->context, numVertices)) {
+    return scanError(s, start, "Could not create a new graph");
+  }
+
+  int id, toVertex, weight;
+  while (s->pos < s->end) {
+    nextLine(s);
+    skipBlanks(s);
+    if (atLineEnd(s)) continue;  // blank line
+
+    if (!scanVertexID(s, numVertices, &id)) return false;
+    sink->beginVertex(sink->context, id);
+    skipBlanks(s);
+    while (!atLineEnd(s)) {
+      if (!scanVertexID(s, numVertices, &toVertex)) return false;
+      skipBlanks(s);
+      start = s->pos;
+      if (!scanInt(s, "edge weight", &weight)) return false;
+      if (weight < 0) {
+        return scanError(s, start, "Invalid edge weight: %d", weight);
+      }
+      if (!sink->addEdge(sink->context, id, toVertex, weight)) {
+        return scanError(s, start, "Could not allocate a new Edge");
+      }
+      skipBlanks(s);
+    }
+    sink->endVertex(sink->context, id);
+  }
+  return true;
+}
+
+/* Scans the file open as 'fd' into 'sink'. Returns false and fills in
+ * 'error' on failure.
+ */
+static bool loadFromFd(int fd, LoadSink* sink, LoadError* error) {
+  InputBuffer input;
+  if (!openInput(fd, &input, error)) return false;
+  Scanner s;
+  s.base = input.data;
+  s.pos = input.data;
+  s.end = input.data + input.size;
+  s.lineStart = input.data;
+  s.line = 1;
+  s.error = error;
+  bool result = scanGraph(&s, sink);
+  closeInput(&input);
+  return result;
+}
+
+/* Scans the file at 'path' into 'sink'. Returns false and fills in 'error'
+ * on failure.
+ */
+static bool loadFromPath(const char* path, LoadSink* sink, LoadError* error) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    setLoadError(error, 0, 0, 0, "Unable to open input file: %s",
+                 strerror(errno));
+    return false;
+  }
+  bool result = loadFromFd(fd, sink, error);
+  close(fd);
+  return result;
+}
+
+/*************************************************************************
+ ** Building a Graph
+ *************************************************************************/
+
+typedef struct graph_builder {
+  Graph* graph;   // the graph being built
+  AdjList* head;  // adjacency list of the current vertex
+  int count;      // number of edges on the current line
+} GraphBuilder;
+
+static bool graphStart(void* context, int numVertices) {
+  GraphBuilder* builder = context;
+  builder->graph = newArenaGraph(numVertices);
+  return builder->graph != NULL;
+}
+
+static void graphBeginVertex(void* context, int id) {
+  GraphBuilder* builder = context;
+  builder->head = NULL;
+  builder->count = 0;
+}
+
+static bool graphAddEdge(void* context, int fromVertex, int toVertex,
+                         int weight) {
+  GraphBuilder* builder = context;
+  AdjList* head =
+      prependEdge(builder->graph, builder->head, fromVertex, toVertex, weight);
+  if (head == NULL) return false;
+  builder->head = head;
+  builder->count++;
+  return true;
+}
+
+static void graphEndVertex(void* context, int id) {
+  GraphBuilder* builder = context;
+  builder->graph->vertices[id].adjList = builder->head;
+  builder->graph->numEdges += builder->count;
+}
+
+/* Returns a newly created arena-backed Graph read from the text file at
+ * 'path'. As with the original line-by-line reader, each vertex's adjacency
+ * list holds its edges in reverse file order, and a repeated vertex line
+ * replaces the earlier one.
+ * Returns NULL and fills in 'error' (if not NULL) on failure.
+ */
+Graph* loadGraph(const char* path, LoadError* error) {
+  if (error != NULL) error->failed = false;
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    setLoadError(error, 0, 0, 0, "Unable to open input file: %s",
+                 strerror(errno));
+    return NULL;
+  }
+  Graph* graph = loadGraphFromFd(fd, error);
+  close(fd);
+  return graph;
+}
+
+/* Like loadGraph, but reads from the open file descriptor 'fd', starting at
+ * the beginning of the file. Pipes and other unmappable inputs are read into
+ * memory instead.
+ */
+Graph* loadGraphFromFd(int fd, LoadError* error) {
+  if (error != NULL) error->failed = false;
+  GraphBuilder builder = {NULL, NULL, 0};
+  LoadSink sink = {&builder, graphStart, graphBeginVertex, graphAddEdge,
+                   graphEndVertex};
+  if (!loadFromFd(fd, &sink, error)) {
+    if (builder.graph != NULL) deleteGraph(builder.graph);
+    return NULL;
+  }
+  return builder.graph;
+}
+
+/*************************************************************************
+ ** Building a CSRGraph
+ *************************************************************************/
+
+typedef struct csr_builder {
+  int numVertices;
+  int* first;       // first[v] is v's first slot in targets/weights, or -1
+  int* last;        // last[v] is one past v's last slot
+  int* targets;     // targets of all edges read so far
+  int* weights;     // weights of all edges read so far
+  size_t size;      // number of edges read so far
+  size_t capacity;  // number of edges targets/weights have room for
+  size_t lineStart; // first slot of the current line
+  bool tooLarge;    // true iff the input has more than INT_MAX slots
+} CSRBuilder;
+
+static bool csrStart(void* context, int numVertices) {
+  CSRBuilder* builder = context;
+  builder->numVertices = numVertices;
+  builder->first = malloc(sizeof(int) * (numVertices + 1));
+  builder->last = malloc(sizeof(int) * (numVertices + 1));
+  builder->capacity = 1024;
+  builder->targets = malloc(sizeof(int) * builder->capacity);
+  builder->weights = malloc(sizeof(int) * builder->capacity);
+  if (builder->first == NULL || builder->last == NULL ||
+      builder->targets == NULL || builder->weights == NULL) {
+    return false;
+  }
+  for (int i = 0; i < numVertices; i++) {
+    builder->first[i] = -1;
+    builder->last[i] = -1;
+  }
+  return true;
+}
+
+static void csrBeginVertex(void* context, int id) {
+  CSRBuilder* builder = context;
+  builder->lineStart = builder->size;
+}
+
+static bool csrAddEdge(void* context, int fromVertex, int toVertex,
+                       int weight) {
+  CSRBuilder* builder = context;
+  if (builder->size == builder->capacity) {
+    // slots are counted in int, in the builder and in the CSRGraph
+    if (builder->capacity >= INT_MAX) {
+      builder->tooLarge = true;
+      return false;
+    }
+    size_t capacity = builder->capacity > INT_MAX / 2 ? INT_MAX
+                                                      : builder->capacity * 2;
+    int* targets = realloc(builder->targets, sizeof(int) * capacity);
+    if (targets == NULL) return false;
+    builder->targets = targets;
+    int* weights = realloc(builder->weights, sizeof(int) * capacity);
+    if (weights == NULL) return false;
+    builder->weights = weights;
+    builder->capacity = capacity;
+  }
+  builder->targets[builder->size] = toVertex;
+  builder->weights[builder->size] = weight;
+  builder->size++;
+  return true;
+}
+
+static void csrEndVertex(void* context, int id) {
+  CSRBuilder* builder = context;
+  // the Graph loader prepends, so store each line back to front to match
+  size_t lo = builder->lineStart;
+  size_t hi = builder->size;
+  while (hi > lo + 1) {
+    hi--;
+    int target = builder->targets[lo];
+    int weight = builder->weights[lo];
+    builder->targets[lo] = builder->targets[hi];
+    builder->weights[lo] = builder->weights[hi];
+    builder->targets[hi] = target;
+    builder->weights[hi] = weight;
+    lo++;
+  }
+  builder->first[id] = builder->lineStart;
+  builder->last[id] = builder->size;
+}
+
+/* Returns a newly created CSRGraph read from the text file at 'path',
+ * without building an intermediate Graph. Its adjacency order matches
+ * csrFromGraph(loadGraph(path)).
+ * Returns NULL and fills in 'error' (if not NULL) on failure.
+ */
+CSRGraph* loadCSRGraph(const char* path, LoadError* error) {
+  if (error != NULL) error->failed = false;
+  CSRBuilder builder;
+  memset(&builder, 0, sizeof(CSRBuilder));
+  LoadSink sink = {&builder, csrStart, csrBeginVertex, csrAddEdge,
+                   csrEndVertex};
+  CSRGraph* csr = NULL;
+  if (loadFromPath(path, &sink, error)) {
+    // a repeated vertex line replaces the earlier one, so count live slots
+    size_t numEdges = 0;
+    for (int v = 0; v < builder.numVertices; v++) {
+      if (builder.first[v] >= 0) numEdges += builder.last[v] - builder.first[v];
+    }
+    csr = newCSRGraph(builder.numVertices, (int)numEdges);
+    int slot = 0;
+    for (int v = 0; v < builder.numVertices; v++) {
+      csr->offsets[v] = slot;
+      if (builder.first[v] < 0) continue;
+      int length = builder.last[v] - builder.first[v];
+      memcpy(csr->targets + slot, builder.targets + builder.first[v],
+             sizeof(int) * length);
+      memcpy(csr->weights + slot, builder.weights + builder.first[v],
+             sizeof(int) * length);
+      slot += length;
+    }
+    csr->offsets[builder.numVertices] = slot;
+  } else if (builder.tooLarge && error != NULL) {
+    // the scanner blames memory; keep its position but say what went wrong
+    setLoadError(error, error->line, error->column, error->offset,
+                 "Too many edges: more than %d adjacency entries", INT_MAX);
+  }
+  free(builder.first);
+  free(builder.last);
+  free(builder.targets);
+  free(builder.weights);
+  return csr;
+}
+
+/* Prints 'error' for the input named 'name' to 'stream'. */
+void printLoadError(FILE* stream, const char* name, LoadError* error) {
+  if (error == NULL || !error->failed) return;
+  if (error->line > 0) {
+    fprintf(stream, "%s:%ld:%ld: %s (byte %zu)\n", name, error->line,
+            error->column, error->message, error->offset);
+  } else {
+    fprintf(stream, "%s: %s\n", name, error->message);
+  }
+}
+
+/*************************************************************************
+ ** Writing
+ *************************************************************************/
+
+/* Writes 'graph' to the file at 'path' in the text format loadGraph
+ * reads: one line per vertex that has neighbours, listing them in slot
+ * order. Returns false and fills in 'error' (if not NULL) on failure.
+ */
+bool writeCSRGraphText(CSRGraph* graph, const char* path, LoadError* error) {
+  if (error != NULL) error->failed = false;
+  FILE* f = fopen(path, "w");
+  if (f == NULL) {
+    setLoadError(error, 0, 0, 0, "Unable to create %s: %s", path,
+                 strerror(errno));
+    return false;
+  }
+  setvbuf(f, NULL, _IOFBF, READ_CHUNK);
+  bool written = fprintf(f, "%d\n", graph->numVertices) > 0;
+  for (int v = 0; written && v < graph->numVertices; v++) {
+    int end = graph->offsets[v + 1];
+    if (graph->offsets[v] == end) continue;
+    written = fprintf(f, "%d", v) > 0;
+    for (int i = graph->offsets[v]; written && i < end; i++) {
+      written = fprintf(f, " %d %d", graph->targets[i], graph->weights[i]) > 0;
+    }
+    written = written && fputc('\n', f) != EOF;
+  }
+  if (fclose(f) != 0) written = false;
+  if (!written) {
+    setLoadError(error, 0, 0, 0, "Could not write %s: %s", path,
+                 strerror(errno));
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,67 @@
+/*
+ * Header file for our graph file loaders.
+ *
+ * The text format is the one sample_input.txt uses: the first line holds the
+ * number of vertices, and every further line holds a vertex ID followed by
+ * (neighbour ID, weight) pairs, all separated by blanks. Lines may be of any
+ * length. Files are memory-mapped and scanned in place.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "csr.h"
+#include "graph.h"
+
+#ifndef __Graph_IO_header
+#define __Graph_IO_header
+
+#define LOAD_ERROR_MESSAGE_LIMIT 128
+
+typedef struct load_error {
+  bool failed;     // true iff loading failed
+  long line;       // 1-based line of the error, 0 if it has no position
+  long column;     // 1-based column of the error, 0 if it has no position
+  size_t offset;   // byte offset of the error in the file
+  char message[LOAD_ERROR_MESSAGE_LIMIT];  // what went wrong
+} LoadError;
+
+/* Returns a newly created arena-backed Graph read from the text file at
+ * 'path'. As with the original line-by-line reader, each vertex's adjacency
+ * list holds its edges in reverse file order, and a repeated vertex line
+ * replaces the earlier one.
+ * Returns NULL and fills in 'error' (if not NULL) on failure.
+ */
+Graph* loadGraph(const char* path, LoadError* error);
+
+/* Like loadGraph, but reads from the open file descriptor 'fd', starting at
+ * the beginning of the file. Pipes and other unmappable inputs are read into
+ * memory instead.
+ */
+Graph* loadGraphFromFd(int fd, LoadError* error);
+
+/* Returns a newly created CSRGraph read from the text file at 'path',
+ * without building an intermediate Graph. Its adjacency order matches
+ * csrFromGraph(loadGraph(path)).
+ * Returns NULL and fills in 'error' (if not NULL) on failure.
+ */
+CSRGraph* loadCSRGraph(const char* path, LoadError* error);
+
+/* Writes 'graph' to the file at 'path' in the text format loadGraph
+ * reads: one line per vertex that has neighbours, listing them in slot
+ * order. Returns false and fills in 'error' (if not NULL) on failure.
+ */
+bool writeCSRGraphText(CSRGraph* graph, const char* path, LoadError* error);
+
+/* Records the failure described by the printf-style 'format' in 'error', if
+ * not NULL, at 'line', 'column' and 'offset'.
+ */
+void setLoadError(LoadError* error, long line, long column, size_t offset,
+                  const char* format, ...);
+
+/* Prints 'error' for the input named 'name' to 'stream'. */
+void printLoadError(FILE* stream, const char* name, LoadError* error);
+
+#endif
@@ -0,0 +1,220 @@
+/*
+ * Our link-cut tree implementation.
+ */
+
+#include "linkcut.h"
+
+#include <limits.h>
+
+#define NOTHING -1
+
+/* Returns true iff 'x' is the root of its splay tree in 'forest'. */
+static bool isSplayRoot(LinkCutTree* forest, int x) {
+  int p = forest->parent[x];
+  return p == NOTHING || (forest->left[p] != x && forest->right[p] != x);
+}
+
+/* Recomputes maxNodes[x] of 'forest' from x and its children. */
+static void pullUp(LinkCutTree* forest, int x) {
+  int best = x;
+  int children[2] = {forest->left[x], forest->right[x]};
+  for (int i = 0; i < 2; i++) {
+    int child = children[i];
+    if (child != NOTHING &&
+        forest->values[forest->maxNodes[child]] > forest->values[best]) {
+      best = forest->maxNodes[child];
+    }
+  }
+  forest->maxNodes[x] = best;
+}
+
+/* Applies a pending reversal at 'x' of 'forest' to its children. */
+static void pushDown(LinkCutTree* forest, int x) {
+  if (!forest->flipped[x]) return;
+  int t = forest->left[x];
+  forest->left[x] = forest->right[x];
+  forest->right[x] = t;
+  if (forest->left[x] != NOTHING) forest->flipped[forest->left[x]] ^= true;
+  if (forest->right[x] != NOTHING) forest->flipped[forest->right[x]] ^= true;
+  forest->flipped[x] = false;
+}
+
+/* Rotates 'x' of 'forest' above its splay tree parent. */
+static void rotate(LinkCutTree* forest, int x) {
+  int p = forest->parent[x];
+  int g = forest->parent[p];
+  bool parentWasRoot = isSplayRoot(forest, p);
+  if (forest->left[p] == x) {
+    forest->left[p] = forest->right[x];
+    if (forest->right[x] != NOTHING) forest->parent[forest->right[x]] = p;
+    forest->right[x] = p;
+  } else {
+    forest->right[p] = forest->left[x];
+    if (forest->left[x] != NOTHING) forest->parent[forest->left[x]] = p;
+    forest->left[x] = p;
+  }
+  forest->parent[p] = x;
+  forest->parent[x] = g;
+  if (!parentWasRoot) {
+    if (forest->left[g] == p) {
+      forest->left[g] = x;
+    } else {
+      forest->right[g] = x;
+    }
+  }
+  pullUp(forest, p);
+  pullUp(forest, x);
+}
+
+/* Makes 'x' the root of its splay tree in 'forest'. */
+static void splay(LinkCutTree* forest, int x) {
+  // pending reversals must reach x before the rotations look at children
+  int size = 0;
+  forest->stack[size++] = x;
+  for (int y = x; !isSplayRoot(forest, y); y = forest->parent[y]) {
+    forest->stack[size++] = forest->parent[y];
+  }
+  while (size > 0) {
+    pushDown(forest, forest->stack[--size]);
+  }
+  while (!isSplayRoot(forest, x)) {
+    int p = forest->parent[x];
+    if (!isSplayRoot(forest, p)) {
+      int g = forest->parent[p];
+      bool zigZig = (forest->left[g] == p) == (forest->left[p] == x);
+      rotate(forest, zigZig ? p : x);
+    }
+    rotate(forest, x);
+  }
+}
+
+/* Makes the path from the root of x's tree to 'x' preferred in 'forest',
+ * with x at the root of its splay tree and nothing deeper on the path.
+ */
+static void access(LinkCutTree* forest, int x) {
+  int last = NOTHING;
+  for (int y = x; y != NOTHING; y = forest->parent[y]) {
+    splay(forest, y);
+    forest->right[y] = last;
+    pullUp(forest, y);
+    last = y;
+  }
+  splay(forest, x);
+}
+
+/* Makes 'x' the root of its tree in 'forest'. */
+static void makeRoot(LinkCutTree* forest, int x) {
+  access(forest, x);
+  forest->flipped[x] ^= true;
+}
+
+/* Returns the root of the tree containing node 'x' in 'forest'. Only lctLink,
+ * lctCut and lctPathMax change which node is a tree's root, so between calls
+ * to those, nodes are connected iff their roots are the same. Like every
+ * operation, this one reshapes the splay trees: the left, right and parent
+ * arrays do not stay the same across it.
+ * Precondition: 0 <= x < forest->numNodes
+ */
+int lctFindRoot(LinkCutTree* forest, int x) {
+  access(forest, x);
+  for (;;) {
+    pushDown(forest, x);
+    if (forest->left[x] == NOTHING) break;
+    x = forest->left[x];
+  }
+  splay(forest, x);
+  return x;
+}
+
+/* Returns true iff nodes 'x' and 'y' are in the same tree of 'forest'.
+ * Precondition: 0 <= x, y < forest->numNodes
+ */
+bool lctConnected(LinkCutTree* forest, int x, int y) {
+  return x == y || lctFindRoot(forest, x) == lctFindRoot(forest, y);
+}
+
+/* Joins nodes 'x' and 'y' of 'forest' by an edge.
+ * Precondition: 0 <= x, y < forest->numNodes and x, y are not connected
+ */
+void lctLink(LinkCutTree* forest, int x, int y) {
+  makeRoot(forest, x);
+  forest->parent[x] = y;
+}
+
+/* Removes the edge between nodes 'x' and 'y' of 'forest'.
+ * Precondition: 0 <= x, y < forest->numNodes and x, y are joined by an edge
+ */
+void lctCut(LinkCutTree* forest, int x, int y) {
+  makeRoot(forest, x);
+  access(forest, y);
+  // the path is x, y: x is y's whole left subtree
+  forest->left[y] = NOTHING;
+  forest->parent[x] = NOTHING;
+  pullUp(forest, y);
+}
+
+/* Returns the node of largest value on the path between nodes 'x' and 'y'
+ * of 'forest', including both ends.
+ * Precondition: 0 <= x, y < forest->numNodes and x, y are connected
+ */
+int lctPathMax(LinkCutTree* forest, int x, int y) {
+  makeRoot(forest, x);
+  access(forest, y);
+  return forest->maxNodes[y];
+}
+
+/* Sets the value of node 'x' of 'forest' to 'value'.
+ * Precondition: 0 <= x < forest->numNodes
+ */
+void lctSetValue(LinkCutTree* forest, int x, int value) {
+  access(forest, x);  // x is now the root of its splay tree
+  forest->values[x] = value;
+  pullUp(forest, x);
+}
+
+/* Adds nodes to 'forest' until it has 'numNodes' nodes. New nodes have
+ * value INT_MIN and no edges.
+ */
+void lctGrow(LinkCutTree* forest, int numNodes) {
+  if (numNodes <= forest->numNodes) return;
+  forest->left = realloc(forest->left, sizeof(int) * numNodes);
+  forest->right = realloc(forest->right, sizeof(int) * numNodes);
+  forest->parent = realloc(forest->parent, sizeof(int) * numNodes);
+  forest->flipped = realloc(forest->flipped, sizeof(bool) * numNodes);
+  forest->values = realloc(forest->values, sizeof(int) * numNodes);
+  forest->maxNodes = realloc(forest->maxNodes, sizeof(int) * numNodes);
+  forest->stack = realloc(forest->stack, sizeof(int) * numNodes);
+  for (int x = forest->numNodes; x < numNodes; x++) {
+    forest->left[x] = NOTHING;
+    forest->right[x] = NOTHING;
+    forest->parent[x] = NOTHING;
+    forest->flipped[x] = false;
+    forest->values[x] = INT_MIN;
+    forest->maxNodes[x] = x;
+  }
+  forest->numNodes = numNodes;
+}
+
+/* Returns a newly created LinkCutTree of 'numNodes' nodes with value
+ * INT_MIN and no edges.
+ * Precondition: numNodes >= 0
+ */
+LinkCutTree* newLinkCutTree(int numNodes) {
+  LinkCutTree* forest = calloc(1, sizeof(LinkCutTree));
+  lctGrow(forest, numNodes);
+  return forest;
+}
+
+/* Frees all memory allocated for 'forest'.
+ */
+void deleteLinkCutTree(LinkCutTree* forest) {
+  if (forest == NULL) return;
+  free(forest->left);
+  free(forest->right);
+  free(forest->parent);
+  free(forest->flipped);
+  free(forest->values);
+  free(forest->maxNodes);
+  free(forest->stack);
+  free(forest);
+}
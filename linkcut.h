@@ -0,0 +1,80 @@
+/*
+ * Header file for our link-cut tree implementation.
+ *
+ * A LinkCutTree maintains a forest of unrooted trees on the nodes
+ * 0 .. numNodes - 1 under linking and cutting of edges, with a value on each
+ * node. Each tree is kept as a set of preferred paths, each stored in a
+ * splay tree, so every operation below runs in O(log numNodes) amortized
+ * time.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef __LinkCut_header
+#define __LinkCut_header
+
+typedef struct link_cut_tree {
+  int numNodes;    // nodes are 0, 1, ..., numNodes-1
+  int* left;       // left[x] is x's left child in its splay tree, or -1
+  int* right;      // right[x] is x's right child in its splay tree, or -1
+  int* parent;     // parent[x] is x's splay tree parent or, at the root of a
+                   //   splay tree, the node its path hangs from; -1 if none
+  bool* flipped;   // flipped[x] is true iff x's subtree is pending reversal
+  int* values;     // values[x] is the value of node x
+  int* maxNodes;   // maxNodes[x] is the node of largest value in x's subtree
+  int* stack;      // scratch space for splaying
+} LinkCutTree;
+
+/* Returns the root of the tree containing node 'x' in 'forest'. Only lctLink,
+ * lctCut and lctPathMax change which node is a tree's root, so between calls
+ * to those, nodes are connected iff their roots are the same. Like every
+ * operation, this one reshapes the splay trees: the left, right and parent
+ * arrays do not stay the same across it.
+ * Precondition: 0 <= x < forest->numNodes
+ */
+int lctFindRoot(LinkCutTree* forest, int x);
+
+/* Returns true iff nodes 'x' and 'y' are in the same tree of 'forest'.
+ * Precondition: 0 <= x, y < forest->numNodes
+ */
+bool lctConnected(LinkCutTree* forest, int x, int y);
+
+/* Joins nodes 'x' and 'y' of 'forest' by an edge.
+ * Precondition: 0 <= x, y < forest->numNodes and x, y are not connected
+ */
+void lctLink(LinkCutTree* forest, int x, int y);
+
+/* Removes the edge between nodes 'x' and 'y' of 'forest'.
+ * Precondition: 0 <= x, y < forest->numNodes and x, y are joined by an edge
+ */
+void lctCut(LinkCutTree* forest, int x, int y);
+
+/* Returns the node of largest value on the path between nodes 'x' and 'y'
+ * of 'forest', including both ends.
+ * Precondition: 0 <= x, y < forest->numNodes and x, y are connected
+ */
+int lctPathMax(LinkCutTree* forest, int x, int y);
+
+/* Sets the value of node 'x' of 'forest' to 'value'.
+ * Precondition: 0 <= x < forest->numNodes
+ */
+void lctSetValue(LinkCutTree* forest, int x, int value);
+
+/* Adds nodes to 'forest' until it has 'numNodes' nodes. New nodes have
+ * value INT_MIN and no edges.
+ */
+void lctGrow(LinkCutTree* forest, int numNodes);
+
+/* Returns a newly created LinkCutTree of 'numNodes' nodes with value
+ * INT_MIN and no edges.
+ * Precondition: numNodes >= 0
+ */
+LinkCutTree* newLinkCutTree(int numNodes);
+
+/* Frees all memory allocated for 'forest'.
+ */
+void deleteLinkCutTree(LinkCutTree* forest);
+
+#endif
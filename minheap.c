@@ -6,6 +6,8 @@
 
 #include "minheap.h"
 
+#include "stats.h"
+
 #define ROOT_INDEX 1
 #define NOTHING -1
 
@@ -84,27 +86,28 @@ void swap(MinHeap* heap, int index1, int index2) {
  */
 void bubbleUp(MinHeap* heap, int nodeIndex) {
   int parentIdx;
+  int depth = 0;
   while (nodeIndex > ROOT_INDEX && nodeIndex <= heap->size) {
     parentIdx = nodeIndex / 2;
     if (heap->arr[parentIdx].priority > heap->arr[nodeIndex].priority) {
       swap(heap, parentIdx, nodeIndex);
       nodeIndex = parentIdx;
+      depth++;
     } else {
       break;
     }
   }
+  STATS_SIFT(depth);
 }
 
-/* Bubbles down the element newly inserted into minheap 'heap' at the root,
- * if it exists. Has no effect otherwise.
+/* Bubbles down the element at index 'nodeIndex' of minheap 'heap' until
+ * neither child has a smaller priority.
  */
-void bubbleDown(MinHeap* heap) {
-  if (heap->size <= ROOT_INDEX) {
-    return;
-  }
+void bubbleDownFrom(MinHeap* heap, int nodeIndex) {
   int parent, left, right;
   int minIdx;
-  parent = ROOT_INDEX;
+  int depth = 0;
+  parent = nodeIndex;
   while (parent <= heap->size) {
     left = leftIdx(heap, parent);
     right = rightIdx(heap, parent);
@@ -120,10 +123,22 @@ void bubbleDown(MinHeap* heap) {
     if (minIdx != parent) {
       swap(heap, parent, minIdx);
       parent = minIdx;
+      depth++;
     } else {
       break;
     }
   }
+  STATS_SIFT(depth);
+}
+
+/* Bubbles down the element newly inserted into minheap 'heap' at the root,
+ * if it exists. Has no effect otherwise.
+ */
+void bubbleDown(MinHeap* heap) {
+  if (heap->size <= ROOT_INDEX) {
+    return;
+  }
+  bubbleDownFrom(heap, ROOT_INDEX);
 }
 
 /* Returns node at index 'nodeIndex' in minheap 'heap'.
@@ -242,6 +257,29 @@ MinHeap* newHeap(int capacity) {
   return new;
 }
 
+/* Returns a newly created minheap with capacity 'capacity' holding the
+ * 'count' nodes with IDs ids[i] and priorities priorities[i]. The array is
+ * filled in order and then heapified bottom-up, which takes O(count) time
+ * rather than the O(count log count) of 'count' inserts. Nodes that are
+ * already in heap order stay where they are.
+ * Precondition: 0 <= count <= capacity
+ *               the IDs are unique and 0 <= ids[i] < capacity
+ */
+MinHeap* newHeapFromArrays(int capacity, int* ids, int* priorities,
+                           int count) {
+  MinHeap* heap = newHeap(capacity);
+  for (int i = 0; i < count; i++) {
+    heap->arr[ROOT_INDEX + i].id = ids[i];
+    heap->arr[ROOT_INDEX + i].priority = priorities[i];
+    heap->indexMap[ids[i]] = ROOT_INDEX + i;
+  }
+  heap->size = count;
+  for (int i = count / 2; i >= ROOT_INDEX; i--) {
+    bubbleDownFrom(heap, i);
+  }
+  return heap;
+}
+
 /* Frees all memory allocated for minheap 'heap'.
  */
 void deleteHeap(MinHeap* heap) {
@@ -65,6 +65,17 @@ void printHeap(MinHeap* heap);
  */
 MinHeap* newHeap(int capacity);
 
+/* Returns a newly created minheap with capacity 'capacity' holding the
+ * 'count' nodes with IDs ids[i] and priorities priorities[i]. The array is
+ * filled in order and then heapified bottom-up, which takes O(count) time
+ * rather than the O(count log count) of 'count' inserts. Nodes that are
+ * already in heap order stay where they are.
+ * Precondition: 0 <= count <= capacity
+ *               the IDs are unique and 0 <= ids[i] < capacity
+ */
+MinHeap* newHeapFromArrays(int capacity, int* ids, int* priorities,
+                           int count);
+
 /* Frees all memory allocated for minheap 'heap'.
  */
 void deleteHeap(MinHeap* heap);
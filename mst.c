@@ -0,0 +1,726 @@
+/*
+ * Our minimum spanning tree engines.
+ */
+
+#include "mst.h"
+
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "parallel.h"
+#include "unionfind.h"
+
+#define NOTHING -1
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+// fewest items worth handing to a thread of its own
+#define PARALLEL_GRAIN 65536
+
+// Boruvka key of a component with no outgoing edge
+#define NO_EDGE UINT64_MAX
+
+// Filter-Kruskal sorts outright below this many edges; override with e.g.
+// -DFILTER_BASE_CASE=1024
+#ifndef FILTER_BASE_CASE
+#define FILTER_BASE_CASE 4096
+#endif
+
+/*************************************************************************
+ ** Collecting edges
+ *************************************************************************/
+
+typedef struct work_edge {
+  int u;       // one endpoint, or its component in Boruvka's algorithm
+  int v;       // the other endpoint, or its component
+  int weight;  // weight of the edge
+  int id;      // increases with collection order; the index of the edge in
+               //   the collected edges in Boruvka's algorithm
+} WorkEdge;
+
+typedef struct collect_job {
+  Graph* graph;     // graph to collect from, or NULL if 'csr' is used
+  CSRGraph* csr;    // graph to collect from, if 'graph' is NULL
+  int numVertices;  // number of vertices in the graph
+  int numDirected;  // number of adjacency entries in the graph
+  int* counts;      // counts[t] is the number of edges thread t collects,
+                    //   then the index of its first edge
+  int* ends;        // ends[t] is one past the index of thread t's last edge
+  Edge* edges;      // destination of the collected edges, or NULL
+  WorkEdge* work;   // destination of the collected edges if 'edges' is
+                    //   NULL, or NULL to count them
+} CollectJob;
+
+/* Stores edge (u -- v, weight) as edge 'index' of 'job'. */
+static inline void storeEdge(CollectJob* job, int index, int u, int v,
+                             int weight) {
+  if (job->edges != NULL) {
+    job->edges[index] = (Edge){u, v, weight};
+  } else {
+    job->work[index] = (WorkEdge){u, v, weight, index};
+  }
+}
+
+/* Counts, or stores, the undirected edges (u -- v, w) with u < v whose u is
+ * in the chunk of vertices of thread 'thread'.
+ */
+static void collectTask(void* arg, int thread, int numThreads) {
+  CollectJob* job = arg;
+  long begin, end;
+  chunkRange(job->numVertices, thread, numThreads, &begin, &end);
+  bool store = job->edges != NULL || job->work != NULL;
+  int next = store ? job->counts[thread] : 0;
+  for (int u = begin; u < end; u++) {
+    if (job->graph != NULL) {
+      for (AdjList* adjList = job->graph->vertices[u].adjList; adjList != NULL;
+           adjList = adjList->next) {
+        Edge* edge = adjList->edge;
+        int v = edge->fromVertex == u ? edge->toVertex : edge->fromVertex;
+        if (u < v) {
+          if (store) storeEdge(job, next, u, v, edge->weight);
+          next++;
+        }
+      }
+    } else {
+      CSRGraph* csr = job->csr;
+      for (int i = csr->offsets[u]; i < csr->offsets[u + 1]; i++) {
+        int v = csr->targets[i];
+        if (u < v) {
+          if (store) storeEdge(job, next, u, v, csr->weights[i]);
+          next++;
+        }
+      }
+    }
+  }
+  if (store) {
+    job->ends[thread] = next;
+  } else {
+    job->counts[thread] = next;
+  }
+}
+
+/* Collects every undirected edge of the graph in 'job' into a newly
+ * allocated array, 'job->work' if 'asWork' is true and 'job->edges'
+ * otherwise, on up to 'numThreads' threads, and returns their number. Each
+ * edge appears once, as (u -- v, w) with u < v, ordered by u and then by
+ * position in u's adjacency list. Self-loops are dropped.
+ */
+static int collectEdges(CollectJob* job, int numThreads, bool asWork) {
+  numThreads = threadsFor(job->numDirected, PARALLEL_GRAIN, numThreads);
+  job->counts = malloc(sizeof(int) * numThreads);
+  job->ends = malloc(sizeof(int) * numThreads);
+  job->edges = NULL;
+  job->work = NULL;
+  int capacity = 0;
+  if (job->csr != NULL) {
+    // a vertex keeps at most one edge per adjacency slot, so each thread can
+    // start at its first vertex's slot; the gaps are closed up below
+    capacity = job->numDirected;
+    for (int t = 0; t < numThreads; t++) {
+      long begin, end;
+      chunkRange(job->numVertices, t, numThreads, &begin, &end);
+      job->counts[t] = job->csr->offsets[begin];
+    }
+  } else {
+    parallelRun(numThreads, collectTask, job);
+    for (int t = 0; t < numThreads; t++) {
+      int count = job->counts[t];
+      job->counts[t] = capacity;
+      capacity += count;
+    }
+  }
+  size_t size = asWork ? sizeof(WorkEdge) : sizeof(Edge);
+  char* array = malloc(size * (capacity > 0 ? capacity : 1));
+  if (asWork) {
+    job->work = (WorkEdge*)array;
+  } else {
+    job->edges = (Edge*)array;
+  }
+  parallelRun(numThreads, collectTask, job);
+  int total = 0;
+  for (int t = 0; t < numThreads; t++) {
+    int count = job->ends[t] - job->counts[t];
+    if (job->counts[t] != total) {
+      memmove(array + size * total, array + size * job->counts[t],
+              size * count);
+    }
+    total += count;
+  }
+  free(job->counts);
+  free(job->ends);
+  return total;
+}
+
+/*************************************************************************
+ ** Sorting edges
+ *************************************************************************/
+
+typedef struct sort_job {
+  Edge* source;     // edges to distribute
+  Edge* target;     // where the distributed edges go
+  long count;       // number of edges
+  int shift;        // position of the digit of this pass
+  long* histogram;  // numThreads rows of RADIX_BUCKETS counters: thread t's
+                    //   digit counts, then its first slot for each digit
+} SortJob;
+
+/* Returns the digit of 'edge' that the pass of 'job' sorts on. */
+static inline int digitOf(SortJob* job, Edge* edge) {
+  return ((unsigned)edge->weight >> job->shift) & (RADIX_BUCKETS - 1);
+}
+
+/* Counts the digits of the edges in thread 'thread''s chunk. */
+static void histogramTask(void* arg, int thread, int numThreads) {
+  SortJob* job = arg;
+  long* row = job->histogram + (long)thread * RADIX_BUCKETS;
+  for (int d = 0; d < RADIX_BUCKETS; d++) {
+    row[d] = 0;
+  }
+  long begin, end;
+  chunkRange(job->count, thread, numThreads, &begin, &end);
+  for (long i = begin; i < end; i++) {
+    row[digitOf(job, &job->source[i])]++;
+  }
+}
+
+/* Moves the edges in thread 'thread''s chunk to their slots in the target. */
+static void scatterTask(void* arg, int thread, int numThreads) {
+  SortJob* job = arg;
+  long* row = job->histogram + (long)thread * RADIX_BUCKETS;
+  long begin, end;
+  chunkRange(job->count, thread, numThreads, &begin, &end);
+  for (long i = begin; i < end; i++) {
+    job->target[row[digitOf(job, &job->source[i])]++] = job->source[i];
+  }
+}
+
+/* Sorts the 'count' edges at 'edges' by weight with a stable LSD radix sort
+ * on up to 'numThreads' threads, using 'scratch' (room for 'count' edges) as
+ * work space. Returns whichever of 'edges' and 'scratch' holds the result.
+ * Precondition: every weight is >= 0
+ */
+static Edge* sortEdgesByWeight(Edge* edges, Edge* scratch, long count,
+                               int numThreads) {
+  numThreads = threadsFor(count, PARALLEL_GRAIN, numThreads);
+  SortJob job = {edges, scratch, count, 0, NULL};
+  job.histogram = malloc(sizeof(long) * RADIX_BUCKETS * numThreads);
+  for (job.shift = 0; job.shift < 32; job.shift += RADIX_BITS) {
+    parallelRun(numThreads, histogramTask, &job);
+    // turn the counts into first slots, digit-major so the sort is stable
+    long slot = 0;
+    bool trivial = false;
+    for (int d = 0; d < RADIX_BUCKETS; d++) {
+      long first = slot;
+      for (int t = 0; t < numThreads; t++) {
+        long n = job.histogram[(long)t * RADIX_BUCKETS + d];
+        job.histogram[(long)t * RADIX_BUCKETS + d] = slot;
+        slot += n;
+      }
+      if (slot - first == count) trivial = true;
+    }
+    if (trivial) continue;  // every edge has the same digit
+    parallelRun(numThreads, scatterTask, &job);
+    Edge* sorted = job.target;
+    job.target = job.source;
+    job.source = sorted;
+  }
+  free(job.histogram);
+  return job.source;
+}
+
+/*************************************************************************
+ ** Building trees
+ *************************************************************************/
+
+/* Fills slots 'numTreeEdges' .. numVertices-2 of 'tree', the spanning
+ * forest found with the components in 'sets', with (r -- NOTHING, INT_MAX)
+ * for one vertex r of every component that does not contain vertex 0. Has
+ * no effect if the graph was connected.
+ */
+static void addForestEdges(UnionFind* sets, Edge* tree, int numTreeEdges) {
+  int rootOfZero = ufFind(sets, 0);
+  for (int v = 0; v < sets->numElements && sets->numSets > 1; v++) {
+    int root = ufFind(sets, v);
+    if (root == v && root != rootOfZero) {
+      tree[numTreeEdges++] = (Edge){v, NOTHING, INT_MAX};
+    }
+  }
+}
+
+/* Runs Kruskal's algorithm on the graph in 'job', on up to 'numThreads'
+ * threads, and returns the resulting MST.
+ */
+static Edge* kruskalEngine(CollectJob* job, int numThreads) {
+  int numVertices = job->numVertices;
+  int numEdges = collectEdges(job, numThreads, false);
+  Edge* edges = job->edges;
+  Edge* scratch = malloc(sizeof(Edge) * (numEdges > 0 ? numEdges : 1));
+  Edge* sorted = sortEdgesByWeight(edges, scratch, numEdges, numThreads);
+  Edge* tree = malloc(sizeof(Edge) * (numVertices > 1 ? numVertices - 1 : 1));
+  UnionFind* sets = newUnionFind(numVertices);
+  int numTreeEdges = 0;
+  for (int i = 0; i < numEdges && sets->numSets > 1; i++) {
+    if (ufUnion(sets, sorted[i].fromVertex, sorted[i].toVertex)) {
+      tree[numTreeEdges++] = sorted[i];
+    }
+  }
+  addForestEdges(sets, tree, numTreeEdges);
+  deleteUnionFind(sets);
+  free(edges);
+  free(scratch);
+  return tree;
+}
+
+/*************************************************************************
+ ** Boruvka's algorithm
+ *************************************************************************/
+
+typedef struct boruvka_job {
+  WorkEdge* work;          // edges between different components
+  WorkEdge* next;          // work space for the next round's 'work'
+  int numWork;             // number of edges in 'work'
+  int* comps;              // IDs of the current components
+  int numComps;            // number of components in 'comps'
+  _Atomic uint64_t* best;  // best[c] is (weight << 32 | index in 'work') of
+                           //   component c's lightest outgoing edge
+  int* parent;             // parent[c] is the component c merges into
+  int* jumped;             // work space for pointer jumping
+  int* counts;             // per-thread counters
+} BoruvkaJob;
+
+/* Returns the key under which 'job' ranks its work edge 'i'. Ties on weight
+ * go to the lower index; 'work' stays in collection order, so the choice
+ * never depends on the number of threads.
+ */
+static inline uint64_t edgeKey(BoruvkaJob* job, int i) {
+  return (uint64_t)job->work[i].weight << 32 | (uint32_t)i;
+}
+
+/* Lowers '*best' to 'key' if that is smaller. */
+static inline void atomicMin(_Atomic uint64_t* best, uint64_t key) {
+  uint64_t current = atomic_load_explicit(best, memory_order_relaxed);
+  while (key < current &&
+         !atomic_compare_exchange_weak_explicit(
+             best, &current, key, memory_order_relaxed, memory_order_relaxed)) {
+  }
+}
+
+/* Forgets the lightest edges of thread 'thread''s components. */
+static void resetBestTask(void* arg, int thread, int numThreads) {
+  BoruvkaJob* job = arg;
+  long begin, end;
+  chunkRange(job->numComps, thread, numThreads, &begin, &end);
+  for (long i = begin; i < end; i++) {
+    atomic_store_explicit(&job->best[job->comps[i]], NO_EDGE,
+                          memory_order_relaxed);
+  }
+}
+
+/* Offers thread 'thread''s edges to the components at both of their ends.
+ */
+static void findBestTask(void* arg, int thread, int numThreads) {
+  BoruvkaJob* job = arg;
+  long begin, end;
+  chunkRange(job->numWork, thread, numThreads, &begin, &end);
+  for (long i = begin; i < end; i++) {
+    uint64_t key = edgeKey(job, i);
+    atomicMin(&job->best[job->work[i].u], key);
+    atomicMin(&job->best[job->work[i].v], key);
+  }
+}
+
+/* Points each of thread 'thread''s components at the component across its
+ * lightest edge. Two components that chose the same edge would point at
+ * each other; the one with the smaller ID becomes the root instead.
+ */
+static void hookTask(void* arg, int thread, int numThreads) {
+  BoruvkaJob* job = arg;
+  long begin, end;
+  chunkRange(job->numComps, thread, numThreads, &begin, &end);
+  for (long i = begin; i < end; i++) {
+    int c = job->comps[i];
+    uint64_t key = atomic_load_explicit(&job->best[c], memory_order_relaxed);
+    if (key == NO_EDGE) {
+      job->parent[c] = c;
+      continue;
+    }
+    WorkEdge* edge = &job->work[(uint32_t)key];
+    int other = edge->u == c ? edge->v : edge->u;
+    bool mutual =
+        atomic_load_explicit(&job->best[other], memory_order_relaxed) == key;
+    job->parent[c] = mutual && c < other ? c : other;
+  }
+}
+
+/* Replaces each parent of thread 'thread''s components by its grandparent,
+ * and counts how many changed.
+ */
+static void jumpTask(void* arg, int thread, int numThreads) {
+  BoruvkaJob* job = arg;
+  long begin, end;
+  chunkRange(job->numComps, thread, numThreads, &begin, &end);
+  int changed = 0;
+  for (long i = begin; i < end; i++) {
+    int c = job->comps[i];
+    int grandparent = job->parent[job->parent[c]];
+    if (grandparent != job->parent[c]) changed++;
+    job->jumped[c] = grandparent;
+  }
+  job->counts[thread] = changed;
+}
+
+/* Counts, or moves to 'job->next', the edges in thread 'thread''s chunk
+ * that still join different components, relabelled with their new
+ * components. Counting happens iff 'job->counts[thread]' is negative.
+ */
+static void contractTask(void* arg, int thread, int numThreads) {
+  BoruvkaJob* job = arg;
+  long begin, end;
+  chunkRange(job->numWork, thread, numThreads, &begin, &end);
+  bool counting = job->counts[thread] < 0;
+  WorkEdge* out = job->next + (counting ? 0 : job->counts[thread]);
+  int count = 0;
+  for (long i = begin; i < end; i++) {
+    int u = job->parent[job->work[i].u];
+    int v = job->parent[job->work[i].v];
+    if (u != v) {
+      if (!counting) {
+        out[count] = (WorkEdge){u, v, job->work[i].weight, job->work[i].id};
+      }
+      count++;
+    }
+  }
+  if (counting) job->counts[thread] = count;
+}
+
+/* Runs one round of Boruvka's algorithm on 'job': every component joins the
+ * component across its lightest edge, whose original is appended from
+ * 'edges' to 'tree' at '*numTreeEdges'. Components left without edges are
+ * appended to 'finished' at '*numFinished'. Returns the new ID of the
+ * component 'zeroComp'.
+ */
+static int boruvkaRound(BoruvkaJob* job, Edge* edges, Edge* tree,
+                        int* numTreeEdges, int* finished, int* numFinished,
+                        int zeroComp, int numThreads) {
+  int compThreads = threadsFor(job->numComps, PARALLEL_GRAIN, numThreads);
+  int edgeThreads = threadsFor(job->numWork, PARALLEL_GRAIN, numThreads);
+  parallelRun(compThreads, resetBestTask, job);
+  parallelRun(edgeThreads, findBestTask, job);
+  parallelRun(compThreads, hookTask, job);
+
+  for (int i = 0; i < job->numComps; i++) {
+    int c = job->comps[i];
+    if (job->parent[c] != c) {
+      uint64_t key = atomic_load_explicit(&job->best[c], memory_order_relaxed);
+      tree[(*numTreeEdges)++] = edges[job->work[(uint32_t)key].id];
+    }
+  }
+  int changed;
+  do {
+    parallelRun(compThreads, jumpTask, job);
+    changed = 0;
+    for (int t = 0; t < compThreads; t++) {
+      changed += job->counts[t];
+    }
+    int* swap = job->parent;
+    job->parent = job->jumped;
+    job->jumped = swap;
+  } while (changed > 0);
+
+  int numComps = 0;
+  for (int i = 0; i < job->numComps; i++) {
+    int c = job->comps[i];
+    if (job->parent[c] != c) continue;
+    if (atomic_load_explicit(&job->best[c], memory_order_relaxed) == NO_EDGE) {
+      finished[(*numFinished)++] = c;
+    } else {
+      job->comps[numComps++] = c;
+    }
+  }
+  job->numComps = numComps;
+  zeroComp = job->parent[zeroComp];
+
+  for (int t = 0; t < edgeThreads; t++) {
+    job->counts[t] = -1;
+  }
+  parallelRun(edgeThreads, contractTask, job);
+  int numWork = 0;
+  for (int t = 0; t < edgeThreads; t++) {
+    int count = job->counts[t];
+    job->counts[t] = numWork;
+    numWork += count;
+  }
+  parallelRun(edgeThreads, contractTask, job);
+  WorkEdge* swap = job->work;
+  job->work = job->next;
+  job->next = swap;
+  job->numWork = numWork;
+  return zeroComp;
+}
+
+/* Runs Boruvka's algorithm on the graph in 'job', on up to 'numThreads'
+ * threads, and returns the resulting MST.
+ */
+static Edge* boruvkaEngine(CollectJob* collect, int numThreads) {
+  int numVertices = collect->numVertices;
+  int numEdges = collectEdges(collect, numThreads, false);
+  Edge* edges = collect->edges;
+  BoruvkaJob job;
+  job.work = malloc(sizeof(WorkEdge) * (numEdges > 0 ? numEdges : 1));
+  job.next = malloc(sizeof(WorkEdge) * (numEdges > 0 ? numEdges : 1));
+  job.numWork = numEdges;
+  for (int i = 0; i < numEdges; i++) {
+    job.work[i] = (WorkEdge){edges[i].fromVertex, edges[i].toVertex,
+                             edges[i].weight, i};
+  }
+  job.comps = malloc(sizeof(int) * numVertices);
+  job.numComps = numVertices;
+  for (int v = 0; v < numVertices; v++) {
+    job.comps[v] = v;
+  }
+  job.best = malloc(sizeof(_Atomic uint64_t) * numVertices);
+  job.parent = malloc(sizeof(int) * numVertices);
+  job.jumped = malloc(sizeof(int) * numVertices);
+  job.counts = malloc(sizeof(int) * numThreads);
+
+  Edge* tree = malloc(sizeof(Edge) * (numVertices > 1 ? numVertices - 1 : 1));
+  int* finished = malloc(sizeof(int) * numVertices);
+  int numTreeEdges = 0;
+  int numFinished = 0;
+  int zeroComp = 0;
+  while (job.numWork > 0) {
+    zeroComp = boruvkaRound(&job, edges, tree, &numTreeEdges, finished,
+                            &numFinished, zeroComp, numThreads);
+  }
+  for (int i = 0; i < job.numComps; i++) {
+    finished[numFinished++] = job.comps[i];
+  }
+  for (int i = 0; i < numFinished; i++) {
+    if (finished[i] != zeroComp) {
+      tree[numTreeEdges++] = (Edge){finished[i], NOTHING, INT_MAX};
+    }
+  }
+
+  free(finished);
+  free(job.work);
+  free(job.next);
+  free(job.comps);
+  free(job.best);
+  free(job.parent);
+  free(job.jumped);
+  free(job.counts);
+  free(edges);
+  return tree;
+}
+
+/*************************************************************************
+ ** Filter-Kruskal
+ *************************************************************************/
+
+/* Returns the rank of work edge 'edge': by weight, then by index in the
+ * collected edges, exactly the order in which kruskalGetMST considers them.
+ */
+static inline uint64_t rankOf(WorkEdge* edge) {
+  return (uint64_t)edge->weight << 32 | (uint32_t)edge->id;
+}
+
+/* Comparison function for qsort on work edges by rank. */
+static int compareWorkEdges(const void* a, const void* b) {
+  uint64_t x = rankOf((WorkEdge*)a);
+  uint64_t y = rankOf((WorkEdge*)b);
+  return (x > y) - (x < y);
+}
+
+/* Returns the median of the ranks of three edges among the 'count' at
+ * 'edges', picked with the xorshift state '*state'.
+ * Precondition: count >= 3
+ */
+static uint64_t pickPivot(WorkEdge* edges, int count, uint64_t* state) {
+  uint64_t sample[3];
+  for (int i = 0; i < 3; i++) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    sample[i] = rankOf(&edges[*state % count]);
+  }
+  if (sample[0] > sample[1]) {
+    uint64_t t = sample[0];
+    sample[0] = sample[1];
+    sample[1] = t;
+  }
+  if (sample[1] > sample[2]) sample[1] = sample[2];
+  return sample[0] > sample[1] ? sample[0] : sample[1];
+}
+
+/* Reorders the 'count' edges at 'edges' so those with rank at most 'pivot'
+ * come first, and returns their number.
+ */
+static int partitionEdges(WorkEdge* edges, int count, uint64_t pivot) {
+  int left = 0;
+  int right = count - 1;
+  while (true) {
+    while (left <= right && rankOf(&edges[left]) <= pivot) left++;
+    while (left <= right && rankOf(&edges[right]) > pivot) right--;
+    if (left > right) return left;
+    WorkEdge t = edges[left];
+    edges[left] = edges[right];
+    edges[right] = t;
+  }
+}
+
+/* Drops the edges among the 'count' at 'edges' whose endpoints are already
+ * connected in 'sets', keeping the rest in order, and returns their number.
+ */
+static int filterEdges(UnionFind* sets, WorkEdge* edges, int count) {
+  int kept = 0;
+  for (int i = 0; i < count; i++) {
+    if (!ufConnected(sets, edges[i].u, edges[i].v)) {
+      edges[kept++] = edges[i];
+    }
+  }
+  return kept;
+}
+
+/* Adds to 'tree', at '*numTreeEdges', the edges among the 'count' at
+ * 'edges' that Kruskal's algorithm would take after the lighter ones
+ * already merged in 'sets'. Pivots are sampled with the xorshift state
+ * '*state'.
+ */
+static void filterKruskal(UnionFind* sets, WorkEdge* edges, int count,
+                          Edge* tree, int* numTreeEdges, uint64_t* state) {
+  if (sets->numSets == 1) {
+    return;
+  }
+  if (count <= FILTER_BASE_CASE) {
+    qsort(edges, count, sizeof(WorkEdge), compareWorkEdges);
+    for (int i = 0; i < count && sets->numSets > 1; i++) {
+      if (ufUnion(sets, edges[i].u, edges[i].v)) {
+        tree[(*numTreeEdges)++] =
+            (Edge){edges[i].u, edges[i].v, edges[i].weight};
+      }
+    }
+    return;
+  }
+  // the pivot is the rank of one of the edges, so the light half holds at
+  // least that edge; if it is the heaviest, the light half is everything,
+  // and since ranks are distinct, moving the pivot down by one leaves it
+  // alone in the heavy half; either way both halves are smaller than 'count'
+  uint64_t pivot = pickPivot(edges, count, state);
+  int light = partitionEdges(edges, count, pivot);
+  if (light == count) light = partitionEdges(edges, count, pivot - 1);
+  filterKruskal(sets, edges, light, tree, numTreeEdges, state);
+  int heavy = filterEdges(sets, edges + light, count - light);
+  filterKruskal(sets, edges + light, heavy, tree, numTreeEdges, state);
+}
+
+/* Runs Filter-Kruskal on the graph in 'job', collecting its edges on up to
+ * 'numThreads' threads, and returns the resulting MST.
+ */
+static Edge* filterKruskalEngine(CollectJob* job, int numThreads) {
+  int numVertices = job->numVertices;
+  int numEdges = collectEdges(job, numThreads, true);
+  Edge* tree = malloc(sizeof(Edge) * (numVertices > 1 ? numVertices - 1 : 1));
+  UnionFind* sets = newUnionFind(numVertices);
+  int numTreeEdges = 0;
+  uint64_t state = 0x9e3779b97f4a7c15ull;
+  filterKruskal(sets, job->work, numEdges, tree, &numTreeEdges, &state);
+  addForestEdges(sets, tree, numTreeEdges);
+  deleteUnionFind(sets);
+  free(job->work);
+  return tree;
+}
+
+/*************************************************************************
+ ** Engines
+ *************************************************************************/
+
+/* Computes an MST of the graph in a CollectJob on up to the given number of
+ * threads.
+ */
+typedef Edge* (*MSTEngine)(CollectJob* job, int numThreads);
+
+/* Returns the MST 'engine' computes for Graph 'graph' with 'options', or
+ * NULL if 'graph' has no vertices.
+ */
+static Edge* runOnGraph(MSTEngine engine, Graph* graph, AlgoOptions* options) {
+  if (graph == NULL || graph->numVertices < 1) {
+    return NULL;
+  }
+  CollectJob job = {graph, NULL, graph->numVertices, graph->numEdges};
+  return engine(&job, threadCount(options != NULL ? options->numThreads : 0));
+}
+
+/* Returns the MST 'engine' computes for CSRGraph 'graph' with 'options', or
+ * NULL if 'graph' has no vertices.
+ */
+static Edge* runOnCSR(MSTEngine engine, CSRGraph* graph, AlgoOptions* options) {
+  if (graph == NULL || graph->numVertices < 1) {
+    return NULL;
+  }
+  CollectJob job = {NULL, graph, graph->numVertices, graph->numEdges};
+  return engine(&job, threadCount(options != NULL ? options->numThreads : 0));
+}
+
+/* Runs Kruskal's algorithm on Graph 'graph', configured by 'options' (NULL
+ * for the defaults), and returns the resulting MST: an array of
+ * numVertices - 1 Edges. Each undirected edge is collected once and the
+ * edges are sorted by weight with a parallel radix sort on
+ * options->numThreads threads; ties keep the order in which the edges
+ * appear in 'graph' (by u, then by position in u's adjacency list),
+ * so the tree does not depend on the number of threads.
+ * Returns NULL if 'graph' has no vertices.
+ * Precondition: 'graph' is connected. Otherwise the MST of each component is
+ * returned, followed by (r -- -1, INT_MAX) for one vertex r of every
+ * component that does not contain vertex 0.
+ */
+Edge* kruskalGetMST(Graph* graph, AlgoOptions* options) {
+  return runOnGraph(kruskalEngine, graph, options);
+}
+
+/* Like kruskalGetMST, on CSRGraph 'graph'. */
+Edge* kruskalGetMSTCSR(CSRGraph* graph, AlgoOptions* options) {
+  return runOnCSR(kruskalEngine, graph, options);
+}
+
+/* Runs Boruvka's algorithm on Graph 'graph', configured by 'options' (NULL
+ * for the defaults), and returns the resulting MST: an array of
+ * numVertices - 1 Edges. Each round, every component finds its lightest
+ * outgoing edge and merges across it, so at most log2(numVertices) rounds
+ * are needed; the edge scans, merging and contraction of a round run on
+ * options->numThreads threads. Ties are broken as in kruskalGetMST, so the
+ * tree does not depend on the number of threads.
+ * Returns NULL if 'graph' has no vertices.
+ * Precondition: 'graph' is connected. Otherwise the result is as described
+ * for kruskalGetMST.
+ */
+Edge* boruvkaGetMST(Graph* graph, AlgoOptions* options) {
+  return runOnGraph(boruvkaEngine, graph, options);
+}
+
+/* Like boruvkaGetMST, on CSRGraph 'graph'. */
+Edge* boruvkaGetMSTCSR(CSRGraph* graph, AlgoOptions* options) {
+  return runOnCSR(boruvkaEngine, graph, options);
+}
+
+/* Runs Filter-Kruskal on Graph 'graph', configured by 'options' (NULL for
+ * the defaults), and returns the resulting MST: an array of
+ * numVertices - 1 Edges. Edges are split around a pivot weight; the light
+ * half is solved first, then heavy edges whose endpoints it already
+ * connected are dropped before they are ever sorted. Returns the same tree
+ * as kruskalGetMST, in the same order. Only the edge collection uses
+ * options->numThreads threads.
+ * Returns NULL if 'graph' has no vertices.
+ * Precondition: 'graph' is connected. Otherwise the result is as described
+ * for kruskalGetMST.
+ */
+Edge* filterKruskalGetMST(Graph* graph, AlgoOptions* options) {
+  return runOnGraph(filterKruskalEngine, graph, options);
+}
+
+/* Like filterKruskalGetMST, on CSRGraph 'graph'. */
+Edge* filterKruskalGetMSTCSR(CSRGraph* graph, AlgoOptions* options) {
+  return runOnCSR(filterKruskalEngine, graph, options);
+}
@@ -0,0 +1,72 @@
+/*
+ * Header file for our minimum spanning tree engines.
+ *
+ * These compute the same trees as primGetMST by other means, for graphs on
+ * which a single heap is the bottleneck. Every engine returns an array of
+ * numVertices - 1 Edges that printTree and friends accept; Edges are listed
+ * in the order the engine adds them to the tree, not in Prim's order, and
+ * each is reported as (u -- v, w) with u < v. The total weight always
+ * equals that of primGetMST.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "csr.h"
+#include "graph.h"
+#include "graph_algos.h"
+
+#ifndef __MST_header
+#define __MST_header
+
+/* Runs Kruskal's algorithm on Graph 'graph', configured by 'options' (NULL
+ * for the defaults), and returns the resulting MST: an array of
+ * numVertices - 1 Edges. Each undirected edge is collected once and the
+ * edges are sorted by weight with a parallel radix sort on
+ * options->numThreads threads; ties keep the order in which the edges
+ * appear in 'graph' (by u, then by position in u's adjacency list),
+ * so the tree does not depend on the number of threads.
+ * Returns NULL if 'graph' has no vertices.
+ * Precondition: 'graph' is connected. Otherwise the MST of each component is
+ * returned, followed by (r -- -1, INT_MAX) for one vertex r of every
+ * component that does not contain vertex 0.
+ */
+Edge* kruskalGetMST(Graph* graph, AlgoOptions* options);
+
+/* Like kruskalGetMST, on CSRGraph 'graph'. */
+Edge* kruskalGetMSTCSR(CSRGraph* graph, AlgoOptions* options);
+
+/* Runs Boruvka's algorithm on Graph 'graph', configured by 'options' (NULL
+ * for the defaults), and returns the resulting MST: an array of
+ * numVertices - 1 Edges. Each round, every component finds its lightest
+ * outgoing edge and merges across it, so at most log2(numVertices) rounds
+ * are needed; the edge scans, merging and contraction of a round run on
+ * options->numThreads threads. Ties are broken as in kruskalGetMST, so the
+ * tree does not depend on the number of threads.
+ * Returns NULL if 'graph' has no vertices.
+ * Precondition: 'graph' is connected. Otherwise the result is as described
+ * for kruskalGetMST.
+ */
+Edge* boruvkaGetMST(Graph* graph, AlgoOptions* options);
+
+/* Like boruvkaGetMST, on CSRGraph 'graph'. */
+Edge* boruvkaGetMSTCSR(CSRGraph* graph, AlgoOptions* options);
+
+/* Runs Filter-Kruskal on Graph 'graph', configured by 'options' (NULL for
+ * the defaults), and returns the resulting MST: an array of
+ * numVertices - 1 Edges. Edges are split around a pivot weight; the light
+ * half is solved first, then heavy edges whose endpoints it already
+ * connected are dropped before they are ever sorted. Returns the same tree
+ * as kruskalGetMST, in the same order. Only the edge collection uses
+ * options->numThreads threads.
+ * Returns NULL if 'graph' has no vertices.
+ * Precondition: 'graph' is connected. Otherwise the result is as described
+ * for kruskalGetMST.
+ */
+Edge* filterKruskalGetMST(Graph* graph, AlgoOptions* options);
+
+/* Like filterKruskalGetMST, on CSRGraph 'graph'. */
+Edge* filterKruskalGetMSTCSR(CSRGraph* graph, AlgoOptions* options);
+
+#endif
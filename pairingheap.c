@@ -0,0 +1,152 @@
+/*
+ * Our pairing heap implementation.
+ */
+
+#include "pairingheap.h"
+
+#define NOTHING -1
+
+/* Links the roots 'a' and 'b' of two trees in heap 'heap' and returns the
+ * root of the result: the one with the larger priority becomes the leftmost
+ * child of the other.
+ */
+static int meld(PairingHeap* heap, int a, int b) {
+  if (a == NOTHING) return b;
+  if (b == NOTHING) return a;
+  PairingNode* nodes = heap->nodes;
+  if (nodes[b].priority < nodes[a].priority) {
+    int t = a;
+    a = b;
+    b = t;
+  }
+  nodes[b].prev = a;
+  nodes[b].sibling = nodes[a].child;
+  if (nodes[a].child != NOTHING) nodes[nodes[a].child].prev = b;
+  nodes[a].child = b;
+  nodes[a].sibling = NOTHING;
+  nodes[a].prev = NOTHING;
+  return a;
+}
+
+/* Detaches the subtree rooted at non-root node 'id' from its parent. */
+static void cut(PairingHeap* heap, int id) {
+  PairingNode* nodes = heap->nodes;
+  int prev = nodes[id].prev;
+  int sibling = nodes[id].sibling;
+  if (nodes[prev].child == id) {
+    nodes[prev].child = sibling;
+  } else {
+    nodes[prev].sibling = sibling;
+  }
+  if (sibling != NOTHING) nodes[sibling].prev = prev;
+  nodes[id].prev = NOTHING;
+  nodes[id].sibling = NOTHING;
+}
+
+/* Removes and returns the node with minimum priority in heap 'heap'.
+ * Precondition: heap is non-empty
+ */
+HeapNode pairingExtractMin(PairingHeap* heap) {
+  PairingNode* nodes = heap->nodes;
+  int root = heap->root;
+  HeapNode min = {nodes[root].priority, root};
+  nodes[root].inHeap = false;
+  heap->size--;
+
+  // first pass: meld the root's children in pairs, left to right
+  int count = 0;
+  int child = nodes[root].child;
+  while (child != NOTHING) {
+    int next = nodes[child].sibling;
+    int after = NOTHING;
+    nodes[child].prev = NOTHING;
+    nodes[child].sibling = NOTHING;
+    if (next != NOTHING) {
+      after = nodes[next].sibling;
+      nodes[next].prev = NOTHING;
+      nodes[next].sibling = NOTHING;
+    }
+    heap->scratch[count++] = meld(heap, child, next);
+    child = after;
+  }
+  // second pass: meld the pairs right to left
+  int result = NOTHING;
+  while (count > 0) {
+    result = meld(heap, heap->scratch[--count], result);
+  }
+  nodes[root].child = NOTHING;
+  heap->root = result;
+  return min;
+}
+
+/* Inserts a new node with priority 'priority' and ID 'id' into heap 'heap'.
+ * Precondition: 'id' is unique within this heap
+ *               0 <= 'id' < heap->capacity
+ */
+void pairingInsert(PairingHeap* heap, int priority, int id) {
+  PairingNode* node = &heap->nodes[id];
+  node->priority = priority;
+  node->child = NOTHING;
+  node->sibling = NOTHING;
+  node->prev = NOTHING;
+  node->inHeap = true;
+  heap->root = meld(heap, heap->root, id);
+  heap->size++;
+}
+
+/* Returns priority of the node with ID 'id' in 'heap', or -1 if there is no
+ * such node.
+ * Precondition: 0 <= 'id' < heap->capacity
+ */
+int pairingGetPriority(PairingHeap* heap, int id) {
+  if (!heap->nodes[id].inHeap) {
+    return NOTHING;
+  }
+  return heap->nodes[id].priority;
+}
+
+/* Returns true iff a node with ID 'id' is in 'heap'. */
+bool pairingContains(PairingHeap* heap, int id) {
+  return 0 <= id && id < heap->capacity && heap->nodes[id].inHeap;
+}
+
+/* Sets priority of node with ID 'id' in heap 'heap' to 'newPriority', if
+ * such a node exists in 'heap' and its priority is larger than
+ * 'newPriority', and returns True. Has no effect and returns False, otherwise.
+ */
+bool pairingDecreasePriority(PairingHeap* heap, int id, int newPriority) {
+  if (!pairingContains(heap, id) || heap->nodes[id].priority <= newPriority) {
+    return false;
+  }
+  heap->nodes[id].priority = newPriority;
+  if (id != heap->root) {
+    cut(heap, id);
+    heap->root = meld(heap, heap->root, id);
+  }
+  return true;
+}
+
+/* Returns a newly created empty pairing heap for node IDs
+ * 0 .. 'capacity' - 1.
+ * Precondition: capacity >= 0
+ */
+PairingHeap* newPairingHeap(int capacity) {
+  PairingHeap* new = malloc(sizeof(PairingHeap));
+  new->size = 0;
+  new->capacity = capacity;
+  new->root = NOTHING;
+  new->nodes = malloc(sizeof(PairingNode) * (capacity > 0 ? capacity : 1));
+  new->scratch = malloc(sizeof(int) * (capacity > 0 ? capacity : 1));
+  for (int i = 0; i < capacity; i++) {
+    new->nodes[i].inHeap = false;
+  }
+  return new;
+}
+
+/* Frees all memory allocated for heap 'heap'.
+ */
+void deletePairingHeap(PairingHeap* heap) {
+  free(heap->nodes);
+  free(heap->scratch);
+  free(heap);
+}
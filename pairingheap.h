@@ -0,0 +1,73 @@
+/*
+ * Header file for our pairing heap implementation.
+ *
+ * A PairingHeap is a heap-ordered multiway tree. Nodes live in an array
+ * indexed by ID, so no allocation happens after creation. insert and
+ * decreasePriority are O(1) (a decreased node is cut from its parent and
+ * melded with the root); extractMin re-links the root's children in two
+ * passes, amortized O(log n). It has the same contract as MinHeap.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "minheap.h"
+
+#ifndef __PairingHeap_header
+#define __PairingHeap_header
+
+typedef struct pairing_node {
+  int priority;  // priority of this node
+  int child;     // ID of the leftmost child, or -1
+  int sibling;   // ID of the next sibling to the right, or -1
+  int prev;      // ID of the left sibling, or of the parent if this is the
+                 //   leftmost child, or -1 for the root
+  bool inHeap;   // true iff this node is in the heap
+} PairingNode;
+
+typedef struct pairing_heap {
+  int size;            // the number of nodes in this heap
+  int capacity;        // the number of node IDs this heap can hold
+  int root;            // ID of the node with minimum priority, or -1
+  PairingNode* nodes;  // nodes[id] is the node with ID id
+  int* scratch;        // work space for extractMin
+} PairingHeap;
+
+/* Removes and returns the node with minimum priority in heap 'heap'.
+ * Precondition: heap is non-empty
+ */
+HeapNode pairingExtractMin(PairingHeap* heap);
+
+/* Inserts a new node with priority 'priority' and ID 'id' into heap 'heap'.
+ * Precondition: 'id' is unique within this heap
+ *               0 <= 'id' < heap->capacity
+ */
+void pairingInsert(PairingHeap* heap, int priority, int id);
+
+/* Returns priority of the node with ID 'id' in 'heap', or -1 if there is no
+ * such node.
+ * Precondition: 0 <= 'id' < heap->capacity
+ */
+int pairingGetPriority(PairingHeap* heap, int id);
+
+/* Returns true iff a node with ID 'id' is in 'heap'. */
+bool pairingContains(PairingHeap* heap, int id);
+
+/* Sets priority of node with ID 'id' in heap 'heap' to 'newPriority', if
+ * such a node exists in 'heap' and its priority is larger than
+ * 'newPriority', and returns True. Has no effect and returns False, otherwise.
+ */
+bool pairingDecreasePriority(PairingHeap* heap, int id, int newPriority);
+
+/* Returns a newly created empty pairing heap for node IDs
+ * 0 .. 'capacity' - 1.
+ * Precondition: capacity >= 0
+ */
+PairingHeap* newPairingHeap(int capacity);
+
+/* Frees all memory allocated for heap 'heap'.
+ */
+void deletePairingHeap(PairingHeap* heap);
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * Our small thread helpers.
+ */
+
+#include "parallel.h"
+
+#include <unistd.h>
+
+typedef struct worker {
+  ParallelTask task;  // the task to run
+  void* arg;          // its argument
+  int thread;         // index of this thread
+  int numThreads;     // total number of threads
+} Worker;
+
+/* Entry point of every thread created by parallelRun. */
+static void* runWorker(void* arg) {
+  Worker* worker = arg;
+  worker->task(worker->arg, worker->thread, worker->numThreads);
+  return NULL;
+}
+
+/* Returns the number of threads to use when 'requested' were asked for: the
+ * number of online CPUs if 'requested' <= 0, and 'requested' otherwise.
+ */
+int threadCount(int requested) {
+  if (requested > 0) {
+    return requested;
+  }
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  return cpus > 0 ? (int)cpus : 1;
+}
+
+/* Returns the number of threads, at most 'numThreads', worth using on
+ * 'count' items when each thread should get at least 'grain' of them.
+ * Always returns at least 1.
+ */
+int threadsFor(long count, long grain, int numThreads) {
+  long useful = grain > 0 ? count / grain : count;
+  if (useful < numThreads) numThreads = useful;
+  return numThreads > 1 ? numThreads : 1;
+}
+
+/* Runs task('arg', t, 'numThreads') for every t in 0 .. numThreads-1, on
+ * separate threads, and returns when all have finished. Thread 0 runs on the
+ * calling thread. A thread that cannot be created has its share run on the
+ * calling thread instead.
+ * Precondition: numThreads >= 1
+ */
+void parallelRun(int numThreads, ParallelTask task, void* arg) {
+  if (numThreads == 1) {
+    task(arg, 0, 1);
+    return;
+  }
+  pthread_t* threads = malloc(sizeof(pthread_t) * numThreads);
+  Worker* workers = malloc(sizeof(Worker) * numThreads);
+  bool* started = calloc(numThreads, sizeof(bool));
+  for (int t = 1; t < numThreads; t++) {
+    workers[t] = (Worker){task, arg, t, numThreads};
+    started[t] = pthread_create(&threads[t], NULL, runWorker, &workers[t]) == 0;
+  }
+  task(arg, 0, numThreads);
+  for (int t = 1; t < numThreads; t++) {
+    if (started[t]) {
+      pthread_join(threads[t], NULL);
+    } else {
+      task(arg, t, numThreads);
+    }
+  }
+  free(threads);
+  free(workers);
+  free(started);
+}
+
+/* Sets ['*begin', '*end') to the chunk of 0 .. count-1 that thread 'thread'
+ * of 'numThreads' should process. The chunks are contiguous, in thread
+ * order, and differ in size by at most one.
+ */
+void chunkRange(long count, int thread, int numThreads, long* begin,
+                long* end) {
+  long base = count / numThreads;
+  long extra = count % numThreads;
+  *begin = thread * base + (thread < extra ? thread : extra);
+  *end = *begin + base + (thread < extra ? 1 : 0);
+}
+
+/* Returns a newly created Barrier for 'numThreads' threads.
+ * Precondition: numThreads >= 1
+ */
+Barrier* newBarrier(int numThreads) {
+  Barrier* new = malloc(sizeof(Barrier));
+  pthread_mutex_init(&new->lock, NULL);
+  pthread_cond_init(&new->passed, NULL);
+  new->numThreads = numThreads;
+  new->waiting = 0;
+  new->round = 0;
+  return new;
+}
+
+/* Blocks until all threads of 'barrier' have called barrierWait, then lets
+ * them all continue. The barrier can be reused right away.
+ */
+void barrierWait(Barrier* barrier) {
+  if (barrier->numThreads == 1) {
+    return;
+  }
+  pthread_mutex_lock(&barrier->lock);
+  unsigned long round = barrier->round;
+  if (++barrier->waiting == barrier->numThreads) {
+    barrier->waiting = 0;
+    barrier->round++;
+    pthread_cond_broadcast(&barrier->passed);
+  } else {
+    while (barrier->round == round) {
+      pthread_cond_wait(&barrier->passed, &barrier->lock);
+    }
+  }
+  pthread_mutex_unlock(&barrier->lock);
+}
+
+/* Frees all memory allocated for 'barrier'.
+ */
+void deleteBarrier(Barrier* barrier) {
+  pthread_mutex_destroy(&barrier->lock);
+  pthread_cond_destroy(&barrier->passed);
+  free(barrier);
+}
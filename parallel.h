@@ -0,0 +1,70 @@
+/*
+ * Header file for our small thread helpers.
+ *
+ * parallelRun runs one task on a fixed number of POSIX threads and waits for
+ * all of them. Each thread is told its index, so tasks split their work into
+ * contiguous chunks with chunkRange and need no further coordination.
+ * Tasks that work in phases line their threads up with a Barrier.
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef __Parallel_header
+#define __Parallel_header
+
+typedef struct barrier {
+  pthread_mutex_t lock;   // protects the fields below
+  pthread_cond_t passed;  // signalled when the last thread arrives
+  int numThreads;         // number of threads that must arrive
+  int waiting;            // number of threads that have arrived
+  unsigned long round;    // number of times the barrier has opened
+} Barrier;
+
+/* A task run by each of 'numThreads' threads; 'thread' is 0 .. numThreads-1.
+ */
+typedef void (*ParallelTask)(void* arg, int thread, int numThreads);
+
+/* Returns the number of threads to use when 'requested' were asked for: the
+ * number of online CPUs if 'requested' <= 0, and 'requested' otherwise.
+ */
+int threadCount(int requested);
+
+/* Returns the number of threads, at most 'numThreads', worth using on
+ * 'count' items when each thread should get at least 'grain' of them.
+ * Always returns at least 1.
+ */
+int threadsFor(long count, long grain, int numThreads);
+
+/* Runs task('arg', t, 'numThreads') for every t in 0 .. numThreads-1, on
+ * separate threads, and returns when all have finished. Thread 0 runs on the
+ * calling thread. A thread that cannot be created has its share run on the
+ * calling thread instead.
+ * Precondition: numThreads >= 1
+ */
+void parallelRun(int numThreads, ParallelTask task, void* arg);
+
+/* Sets ['*begin', '*end') to the chunk of 0 .. count-1 that thread 'thread'
+ * of 'numThreads' should process. The chunks are contiguous, in thread
+ * order, and differ in size by at most one.
+ */
+void chunkRange(long count, int thread, int numThreads, long* begin,
+                long* end);
+
+/* Returns a newly created Barrier for 'numThreads' threads.
+ * Precondition: numThreads >= 1
+ */
+Barrier* newBarrier(int numThreads);
+
+/* Blocks until all threads of 'barrier' have called barrierWait, then lets
+ * them all continue. The barrier can be reused right away.
+ */
+void barrierWait(Barrier* barrier);
+
+/* Frees all memory allocated for 'barrier'.
+ */
+void deleteBarrier(Barrier* barrier);
+
+#endif
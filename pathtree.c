@@ -0,0 +1,177 @@
+/*
+ * Our compact shortest path output.
+ */
+
+#include "pathtree.h"
+
+#include <limits.h>
+
+#define NOTHING -1
+
+/*************************************************************************
+ ** Construction
+ *************************************************************************/
+
+/* Returns a newly created PathTree of the distance tree 'distTree' produced
+ * by Dijkstra's algorithm on a graph with 'numVertices' vertices and with
+ * the start vertex 'startVertex'. 'distTree' is copied and may be freed
+ * afterwards.
+ * Returns NULL if 'startVertex' is not valid in 'distTree'.
+ */
+PathTree* newPathTree(Edge* distTree, int numVertices, int startVertex) {
+  if (startVertex < 0 || startVertex >= numVertices) {
+    return NULL;
+  }
+  PathTree* tree = malloc(sizeof(PathTree));
+  tree->numVertices = numVertices;
+  tree->startVertex = startVertex;
+  tree->parents = malloc(sizeof(int) * numVertices);
+  tree->distances = malloc(sizeof(int) * numVertices);
+  for (int v = 0; v < numVertices; v++) {
+    Edge edge = distTree[v];
+    int next = edge.fromVertex == v ? edge.toVertex : edge.fromVertex;
+    if (v == startVertex) {
+      tree->parents[v] = NOTHING;
+      tree->distances[v] = 0;
+    } else if (next < 0 || next >= numVertices || edge.weight == INT_MAX) {
+      tree->parents[v] = NOTHING;
+      tree->distances[v] = INT_MAX;
+    } else {
+      tree->parents[v] = next;
+      tree->distances[v] = edge.weight;
+    }
+  }
+  return tree;
+}
+
+/* Frees memory allocated for 'tree'.
+ */
+void deletePathTree(PathTree* tree) {
+  if (tree == NULL) return;
+  free(tree->parents);
+  free(tree->distances);
+  free(tree);
+}
+
+/*************************************************************************
+ ** Single paths
+ *************************************************************************/
+
+/* Returns the edge of 'tree' from 'vertex' to its parent.
+ * Precondition: 'vertex' has a parent
+ */
+static Edge hopFrom(PathTree* tree, int vertex) {
+  int parent = tree->parents[vertex];
+  return (Edge){vertex, parent,
+                tree->distances[vertex] - tree->distances[parent]};
+}
+
+/* Returns the number of edges on the path of vertex 'vertex' of 'tree'.
+ * Precondition: 0 <= vertex < tree->numVertices
+ */
+int pathTreeHops(PathTree* tree, int vertex) {
+  int hops = 0;
+  for (int v = tree->parents[vertex]; v != NOTHING; v = tree->parents[v]) {
+    hops++;
+  }
+  return hops;
+}
+
+/* Returns an iterator over the path of vertex 'vertex' of 'tree'.
+ * Precondition: 0 <= vertex < tree->numVertices
+ */
+PathIterator pathTreeIterate(PathTree* tree, int vertex) {
+  PathIterator iterator = {tree, vertex};
+  if (tree->parents[vertex] == NOTHING) iterator.vertex = NOTHING;
+  return iterator;
+}
+
+/* Stores the next edge of the path of 'iterator' in '*edge' and advances.
+ * Returns false, leaving '*edge' alone, once the path is exhausted.
+ */
+bool pathNext(PathIterator* iterator, Edge* edge) {
+  if (iterator->vertex == NOTHING) return false;
+  PathTree* tree = iterator->tree;
+  *edge = hopFrom(tree, iterator->vertex);
+  iterator->vertex = edge->toVertex;
+  if (tree->parents[iterator->vertex] == NOTHING) iterator->vertex = NOTHING;
+  return true;
+}
+
+/* Writes the path of vertex 'vertex' of 'tree' to 'edges', which must have
+ * room for pathTreeHops(tree, vertex) Edges, and returns its number of
+ * edges.
+ * Precondition: 0 <= vertex < tree->numVertices
+ */
+int pathTreeCopyPath(PathTree* tree, int vertex, Edge* edges) {
+  int hops = 0;
+  for (int v = vertex; tree->parents[v] != NOTHING; v = tree->parents[v]) {
+    edges[hops++] = hopFrom(tree, v);
+  }
+  return hops;
+}
+
+/*************************************************************************
+ ** All paths
+ *************************************************************************/
+
+/* Returns a newly created array of the number of edges on the path of each
+ * vertex of 'tree', computed in O(numVertices) time: each vertex walks up
+ * only until it meets a vertex whose count is known.
+ */
+int* pathTreeHopCounts(PathTree* tree) {
+  int numVertices = tree->numVertices;
+  int* hops = malloc(sizeof(int) * (numVertices > 0 ? numVertices : 1));
+  int* stack = malloc(sizeof(int) * (numVertices > 0 ? numVertices : 1));
+  for (int v = 0; v < numVertices; v++) {
+    hops[v] = NOTHING;
+  }
+  for (int v = 0; v < numVertices; v++) {
+    int size = 0;
+    int u = v;
+    while (hops[u] == NOTHING && tree->parents[u] != NOTHING) {
+      stack[size++] = u;
+      u = tree->parents[u];
+    }
+    if (hops[u] == NOTHING) hops[u] = 0;
+    while (size > 0) {
+      int w = stack[--size];
+      hops[w] = hops[tree->parents[w]] + 1;
+    }
+  }
+  free(stack);
+  return hops;
+}
+
+/* Returns a newly created PathBuffer holding the paths of all vertices of
+ * 'tree' in one allocation. The paths are built without recursion, so deep
+ * trees are fine.
+ */
+PathBuffer* materializePaths(PathTree* tree) {
+  int numVertices = tree->numVertices;
+  int* hops = pathTreeHopCounts(tree);
+  PathBuffer* buffer = malloc(sizeof(PathBuffer));
+  buffer->numVertices = numVertices;
+  buffer->offsets = malloc(sizeof(long) * (numVertices + 1));
+  buffer->offsets[0] = 0;
+  for (int v = 0; v < numVertices; v++) {
+    buffer->offsets[v + 1] = buffer->offsets[v] + hops[v];
+  }
+  free(hops);
+  buffer->numEdges = buffer->offsets[numVertices];
+  buffer->edges =
+      malloc(sizeof(Edge) * (buffer->numEdges > 0 ? buffer->numEdges : 1));
+  for (int v = 0; v < numVertices; v++) {
+    pathTreeCopyPath(tree, v, buffer->edges + buffer->offsets[v]);
+  }
+  return buffer;
+}
+
+/* Frees memory allocated for 'buffer'.
+ */
+void deletePathBuffer(PathBuffer* buffer) {
+  if (buffer == NULL) return;
+  free(buffer->offsets);
+  free(buffer->edges);
+  free(buffer);
+}
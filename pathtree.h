@@ -0,0 +1,103 @@
+/*
+ * Header file for our compact shortest path output.
+ *
+ * getPaths builds a separate linked list for the path of every vertex, so
+ * its output takes time and memory proportional to the total length of all
+ * paths: quadratic on a long chain. A PathTree instead keeps the distance
+ * tree once, in O(numVertices) space, and hands out the path of a vertex on
+ * demand: hop by hop through a PathIterator, copied into a caller's array,
+ * or, for all vertices at once, written into one contiguous PathBuffer.
+ *
+ * Paths run from a vertex to the start, as getPaths' do: the path of v is
+ *   [(v -- id_1, w_0), (id_1 -- id_2, w_1), ..., (id_n -- start, w_n)]
+ * The start vertex and unreached vertices have empty paths.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "graph.h"
+
+#ifndef __PathTree_header
+#define __PathTree_header
+
+typedef struct path_tree {
+  int numVertices;  // vertices are 0, 1, ..., numVertices-1
+  int startVertex;  // the vertex all paths lead to
+  int* parents;     // parents[v] is the next vertex on v's path, or -1 for
+                    //   the start vertex and unreached vertices
+  int* distances;   // distances[v] is the length of v's path, INT_MAX if v
+                    //   is unreached
+} PathTree;
+
+typedef struct path_iterator {
+  PathTree* tree;  // tree the path is in
+  int vertex;      // vertex the next hop leaves from, or -1 at the end
+} PathIterator;
+
+typedef struct path_buffer {
+  int numVertices;  // number of paths
+  long numEdges;    // total number of edges in all paths
+  long* offsets;    // array of numVertices + 1 offsets; the path of v is
+                    //   edges[offsets[v]] .. edges[offsets[v + 1] - 1]
+  Edge* edges;      // all paths, one after another
+} PathBuffer;
+
+/***** Construction *********************************************************/
+
+/* Returns a newly created PathTree of the distance tree 'distTree' produced
+ * by Dijkstra's algorithm on a graph with 'numVertices' vertices and with
+ * the start vertex 'startVertex'. 'distTree' is copied and may be freed
+ * afterwards.
+ * Returns NULL if 'startVertex' is not valid in 'distTree'.
+ */
+PathTree* newPathTree(Edge* distTree, int numVertices, int startVertex);
+
+/* Frees memory allocated for 'tree'.
+ */
+void deletePathTree(PathTree* tree);
+
+/***** Single paths *********************************************************/
+
+/* Returns the number of edges on the path of vertex 'vertex' of 'tree'.
+ * Precondition: 0 <= vertex < tree->numVertices
+ */
+int pathTreeHops(PathTree* tree, int vertex);
+
+/* Returns an iterator over the path of vertex 'vertex' of 'tree'.
+ * Precondition: 0 <= vertex < tree->numVertices
+ */
+PathIterator pathTreeIterate(PathTree* tree, int vertex);
+
+/* Stores the next edge of the path of 'iterator' in '*edge' and advances.
+ * Returns false, leaving '*edge' alone, once the path is exhausted.
+ */
+bool pathNext(PathIterator* iterator, Edge* edge);
+
+/* Writes the path of vertex 'vertex' of 'tree' to 'edges', which must have
+ * room for pathTreeHops(tree, vertex) Edges, and returns its number of
+ * edges.
+ * Precondition: 0 <= vertex < tree->numVertices
+ */
+int pathTreeCopyPath(PathTree* tree, int vertex, Edge* edges);
+
+/***** All paths ************************************************************/
+
+/* Returns a newly created array of the number of edges on the path of each
+ * vertex of 'tree', computed in O(numVertices) time: each vertex walks up
+ * only until it meets a vertex whose count is known.
+ */
+int* pathTreeHopCounts(PathTree* tree);
+
+/* Returns a newly created PathBuffer holding the paths of all vertices of
+ * 'tree' in one allocation. The paths are built without recursion, so deep
+ * trees are fine.
+ */
+PathBuffer* materializePaths(PathTree* tree);
+
+/* Frees memory allocated for 'buffer'.
+ */
+void deletePathBuffer(PathBuffer* buffer);
+
+#endif
@@ -0,0 +1,219 @@
+/*
+ * Adapters from our priority queues to the PQOps interface.
+ */
+
+#include "pq.h"
+
+#include "dheap.h"
+#include "pairingheap.h"
+#include "radixheap.h"
+
+// number of children per node of the PQ_DARY_HEAP queue; override with
+// e.g. -DHEAP_ARITY=8
+#ifndef HEAP_ARITY
+#define HEAP_ARITY 4
+#endif
+
+/***** MinHeap **************************************************************/
+
+static void* binaryCreate(int capacity) { return newHeap(capacity); }
+static void* binaryCreateFrom(int capacity, int* ids, int* priorities,
+                              int count) {
+  return newHeapFromArrays(capacity, ids, priorities, count);
+}
+static void binaryDestroy(void* queue) { deleteHeap(queue); }
+static int binarySize(void* queue) { return ((MinHeap*)queue)->size; }
+static void binaryInsert(void* queue, int priority, int id) {
+  insert(queue, priority, id);
+}
+static HeapNode binaryExtractMin(void* queue) { return extractMin(queue); }
+static int binaryGetPriority(void* queue, int id) {
+  return getPriority(queue, id);
+}
+static bool binaryContains(void* queue, int id) {
+  MinHeap* heap = queue;
+  return 0 <= id && id < heap->capacity && heap->indexMap[id] != -1;
+}
+static bool binaryDecreasePriority(void* queue, int id, int newPriority) {
+  return decreasePriority(queue, id, newPriority);
+}
+static void binaryPrint(void* queue) { printHeap(queue); }
+
+static const PQOps binaryHeapOps = {
+    .name = "binary heap",
+    .monotone = false,
+    .create = binaryCreate,
+    .createFrom = binaryCreateFrom,
+    .destroy = binaryDestroy,
+    .size = binarySize,
+    .insert = binaryInsert,
+    .extractMin = binaryExtractMin,
+    .getPriority = binaryGetPriority,
+    .contains = binaryContains,
+    .decreasePriority = binaryDecreasePriority,
+    .print = binaryPrint};
+
+/***** DaryHeap *************************************************************/
+
+static void* daryCreate(int capacity) {
+  return newDaryHeap(capacity, HEAP_ARITY);
+}
+static void* daryCreateFrom(int capacity, int* ids, int* priorities,
+                            int count) {
+  return newDaryHeapFromArrays(capacity, HEAP_ARITY, ids, priorities, count);
+}
+static void daryDestroy(void* queue) { deleteDaryHeap(queue); }
+static int darySize(void* queue) { return ((DaryHeap*)queue)->size; }
+static void daryInsertOp(void* queue, int priority, int id) {
+  daryInsert(queue, priority, id);
+}
+static HeapNode daryExtractMinOp(void* queue) { return daryExtractMin(queue); }
+static int daryGetPriorityOp(void* queue, int id) {
+  return daryGetPriority(queue, id);
+}
+static bool daryContainsOp(void* queue, int id) {
+  return daryContains(queue, id);
+}
+static bool daryDecreasePriorityOp(void* queue, int id, int newPriority) {
+  return daryDecreasePriority(queue, id, newPriority);
+}
+static void daryPrint(void* queue) { printDaryHeap(queue); }
+
+static const PQOps daryHeapOps = {
+    .name = "d-ary heap",
+    .monotone = false,
+    .create = daryCreate,
+    .createFrom = daryCreateFrom,
+    .destroy = daryDestroy,
+    .size = darySize,
+    .insert = daryInsertOp,
+    .extractMin = daryExtractMinOp,
+    .getPriority = daryGetPriorityOp,
+    .contains = daryContainsOp,
+    .decreasePriority = daryDecreasePriorityOp,
+    .print = daryPrint};
+
+/***** RadixHeap ************************************************************/
+
+static void* radixCreate(int capacity) { return newRadixHeap(capacity); }
+static void radixDestroy(void* queue) { deleteRadixHeap(queue); }
+static int radixSize(void* queue) { return ((RadixHeap*)queue)->size; }
+static void radixInsertOp(void* queue, int priority, int id) {
+  radixInsert(queue, priority, id);
+}
+static HeapNode radixExtractMinOp(void* queue) {
+  return radixExtractMin(queue);
+}
+static int radixGetPriorityOp(void* queue, int id) {
+  return radixGetPriority(queue, id);
+}
+static bool radixContainsOp(void* queue, int id) {
+  return radixContains(queue, id);
+}
+static bool radixDecreasePriorityOp(void* queue, int id, int newPriority) {
+  return radixDecreasePriority(queue, id, newPriority);
+}
+
+static const PQOps radixHeapOps = {
+    .name = "radix heap",
+    .monotone = true,
+    .create = radixCreate,
+    .destroy = radixDestroy,
+    .size = radixSize,
+    .insert = radixInsertOp,
+    .extractMin = radixExtractMinOp,
+    .getPriority = radixGetPriorityOp,
+    .contains = radixContainsOp,
+    .decreasePriority = radixDecreasePriorityOp,
+    .print = NULL};
+
+/***** PairingHeap **********************************************************/
+
+static void* pairingCreate(int capacity) { return newPairingHeap(capacity); }
+static void pairingDestroy(void* queue) { deletePairingHeap(queue); }
+static int pairingSize(void* queue) { return ((PairingHeap*)queue)->size; }
+static void pairingInsertOp(void* queue, int priority, int id) {
+  pairingInsert(queue, priority, id);
+}
+static HeapNode pairingExtractMinOp(void* queue) {
+  return pairingExtractMin(queue);
+}
+static int pairingGetPriorityOp(void* queue, int id) {
+  return pairingGetPriority(queue, id);
+}
+static bool pairingContainsOp(void* queue, int id) {
+  return pairingContains(queue, id);
+}
+static bool pairingDecreasePriorityOp(void* queue, int id, int newPriority) {
+  return pairingDecreasePriority(queue, id, newPriority);
+}
+
+static const PQOps pairingHeapOps = {
+    .name = "pairing heap",
+    .monotone = false,
+    .create = pairingCreate,
+    .destroy = pairingDestroy,
+    .size = pairingSize,
+    .insert = pairingInsertOp,
+    .extractMin = pairingExtractMinOp,
+    .getPriority = pairingGetPriorityOp,
+    .contains = pairingContainsOp,
+    .decreasePriority = pairingDecreasePriorityOp,
+    .print = NULL};
+
+/***** Interface ************************************************************/
+
+/* Returns the operations of the built-in queue 'kind', or NULL if there is
+ * no such queue.
+ */
+const PQOps* pqOpsFor(PQKind kind) {
+  switch (kind) {
+    case PQ_DARY_HEAP:
+      return &daryHeapOps;
+    case PQ_RADIX_HEAP:
+      return &radixHeapOps;
+    case PQ_BINARY_HEAP:
+      return &binaryHeapOps;
+    case PQ_PAIRING_HEAP:
+      return &pairingHeapOps;
+    default:
+      return NULL;
+  }
+}
+
+/* Sets up 'queue' as a new empty queue with room for IDs
+ * 0 .. 'capacity' - 1, implemented by 'ops'.
+ */
+void initPriorityQueue(PriorityQueue* queue, const PQOps* ops, int capacity) {
+  queue->ops = ops;
+  queue->impl = ops->create(capacity);
+}
+
+/* Sets up 'queue' as a new queue with room for IDs 0 .. 'capacity' - 1,
+ * implemented by 'ops', holding the 'count' nodes with IDs ids[i] and
+ * priorities priorities[i]. Backends with a createFrom operation build it in
+ * one pass; the others get 'count' inserts.
+ * Precondition: 0 <= count <= capacity
+ *               the IDs are unique and 0 <= ids[i] < capacity
+ */
+void initPriorityQueueFrom(PriorityQueue* queue, const PQOps* ops,
+                           int capacity, int* ids, int* priorities,
+                           int count) {
+  queue->ops = ops;
+  STATS_ADD(inserts, count);
+  STATS_MAX(peakQueueSize, count);
+  if (ops->createFrom != NULL) {
+    queue->impl = ops->createFrom(capacity, ids, priorities, count);
+    return;
+  }
+  queue->impl = ops->create(capacity);
+  for (int i = 0; i < count; i++) {
+    ops->insert(queue->impl, priorities[i], ids[i]);
+  }
+}
+
+/* Frees the backend of 'queue'. */
+void freePriorityQueue(PriorityQueue* queue) {
+  if (queue->impl != NULL) queue->ops->destroy(queue->impl);
+  queue->impl = NULL;
+}
@@ -0,0 +1,124 @@
+/*
+ * Header file for our pluggable priority queue interface.
+ *
+ * A PriorityQueue pairs an implementation with a PQOps table of its
+ * operations, so the graph algorithms can run on any queue that provides
+ * them. Every backend follows the MinHeap contract: node IDs are
+ * 0 .. capacity - 1, getPriority returns -1 for IDs not in the queue, and
+ * decreasePriority only ever lowers a priority.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "minheap.h"
+#include "stats.h"
+
+#ifndef __PQ_header
+#define __PQ_header
+
+typedef enum pq_kind {
+  PQ_DARY_HEAP = 0,  // DaryHeap with HEAP_ARITY children per node (default)
+  PQ_RADIX_HEAP,     // RadixHeap; monotone, so Dijkstra's algorithm only
+  PQ_BINARY_HEAP,    // MinHeap
+  PQ_PAIRING_HEAP,   // PairingHeap
+  PQ_NUM_KINDS       // number of built-in queues
+} PQKind;
+
+typedef struct pq_ops {
+  const char* name;  // short human-readable name of the backend
+  bool monotone;     // true iff priorities inserted or decreased must be at
+                     //   least the last extracted one, until the
+                     //   queue is emptied
+  void* (*create)(int capacity);
+  void* (*createFrom)(int capacity, int* ids, int* priorities,
+                      int count);  // may be NULL (see initPriorityQueueFrom)
+  void (*destroy)(void* queue);
+  int (*size)(void* queue);
+  void (*insert)(void* queue, int priority, int id);
+  HeapNode (*extractMin)(void* queue);
+  int (*getPriority)(void* queue, int id);
+  bool (*contains)(void* queue, int id);
+  bool (*decreasePriority)(void* queue, int id, int newPriority);
+  void (*print)(void* queue);  // may be NULL
+} PQOps;
+
+typedef struct priority_queue {
+  const PQOps* ops;  // operations of the backend
+  void* impl;        // the backend's queue
+} PriorityQueue;
+
+/* Returns the operations of the built-in queue 'kind', or NULL if there is
+ * no such queue.
+ */
+const PQOps* pqOpsFor(PQKind kind);
+
+/* Sets up 'queue' as a new empty queue with room for IDs
+ * 0 .. 'capacity' - 1, implemented by 'ops'.
+ */
+void initPriorityQueue(PriorityQueue* queue, const PQOps* ops, int capacity);
+
+/* Sets up 'queue' as a new queue with room for IDs 0 .. 'capacity' - 1,
+ * implemented by 'ops', holding the 'count' nodes with IDs ids[i] and
+ * priorities priorities[i]. Backends with a createFrom operation build it in
+ * one pass; the others get 'count' inserts.
+ * Precondition: 0 <= count <= capacity
+ *               the IDs are unique and 0 <= ids[i] < capacity
+ */
+void initPriorityQueueFrom(PriorityQueue* queue, const PQOps* ops,
+                           int capacity, int* ids, int* priorities,
+                           int count);
+
+/* Frees the backend of 'queue'. */
+void freePriorityQueue(PriorityQueue* queue);
+
+/* Returns the number of nodes in 'queue'. */
+static inline int pqSize(PriorityQueue* queue) {
+  return queue->ops->size(queue->impl);
+}
+
+/* Returns true iff 'queue' is empty. */
+static inline bool pqIsEmpty(PriorityQueue* queue) {
+  return pqSize(queue) == 0;
+}
+
+/* Inserts a new node with priority 'priority' and ID 'id' into 'queue'. */
+static inline void pqInsert(PriorityQueue* queue, int priority, int id) {
+  queue->ops->insert(queue->impl, priority, id);
+  STATS_ADD(inserts, 1);
+  STATS_MAX(peakQueueSize, pqSize(queue));
+}
+
+/* Removes and returns the node with minimum priority in 'queue'.
+ * Precondition: queue is non-empty
+ */
+static inline HeapNode pqExtractMin(PriorityQueue* queue) {
+  STATS_ADD(extractMins, 1);
+  return queue->ops->extractMin(queue->impl);
+}
+
+/* Returns priority of the node with ID 'id' in 'queue', or -1 if there is
+ * no such node.
+ */
+static inline int pqGetPriority(PriorityQueue* queue, int id) {
+  return queue->ops->getPriority(queue->impl, id);
+}
+
+/* Returns true iff a node with ID 'id' is in 'queue'. */
+static inline bool pqContains(PriorityQueue* queue, int id) {
+  return queue->ops->contains(queue->impl, id);
+}
+
+/* Lowers the priority of node 'id' in 'queue' to 'newPriority' if it is in
+ * 'queue' with a larger priority, and returns true. Returns false otherwise.
+ */
+static inline bool pqDecreasePriority(PriorityQueue* queue, int id,
+                                      int newPriority) {
+  bool lowered = queue->ops->decreasePriority(queue->impl, id, newPriority);
+  STATS_ADD(decreases, lowered);
+  STATS_ADD(rejectedDecreases, !lowered);
+  return lowered;
+}
+
+#endif
@@ -0,0 +1,161 @@
+/*
+ * Our radix heap implementation.
+ */
+
+#include "radixheap.h"
+
+#define NOTHING -1
+
+/* Returns the bucket for priority 'priority' relative to the last extracted
+ * priority 'last': 0 if they are equal, and otherwise one more than the
+ * index of the highest bit in which they differ.
+ */
+static inline int bucketIndex(unsigned last, unsigned priority) {
+  unsigned diff = last ^ priority;
+  return diff == 0 ? 0 : 32 - __builtin_clz(diff);
+}
+
+/* Appends 'node' to bucket 'index' of heap 'heap'. */
+static inline void pushToBucket(RadixHeap* heap, int index, HeapNode node) {
+  RadixBucket* bucket = &heap->buckets[index];
+  if (bucket->size == bucket->capacity) {
+    bucket->capacity = bucket->capacity > 0 ? 2 * bucket->capacity : 16;
+    bucket->nodes = realloc(bucket->nodes, sizeof(HeapNode) * bucket->capacity);
+  }
+  heap->locations[node.id].bucket = index;
+  heap->locations[node.id].slot = bucket->size;
+  bucket->nodes[bucket->size++] = node;
+}
+
+/* Removes node 'id' from its bucket in heap 'heap', by moving the bucket's
+ * last node into its slot.
+ */
+static inline void removeFromBucket(RadixHeap* heap, int id) {
+  RadixLocation* location = &heap->locations[id];
+  RadixBucket* bucket = &heap->buckets[location->bucket];
+  HeapNode moved = bucket->nodes[--bucket->size];
+  bucket->nodes[location->slot] = moved;
+  heap->locations[moved.id].slot = location->slot;
+  location->bucket = NOTHING;
+}
+
+/* Removes and returns the node with minimum priority in heap 'heap'.
+ * Precondition: heap is non-empty
+ */
+HeapNode radixExtractMin(RadixHeap* heap) {
+  if (heap->buckets[0].size == 0) {
+    // refill bucket 0: the smallest priority in the first non-empty bucket
+    // becomes 'last', and that bucket's nodes all move to lower buckets
+    int index = 1;
+    while (heap->buckets[index].size == 0) index++;
+    RadixBucket* bucket = &heap->buckets[index];
+    unsigned min = (unsigned)bucket->nodes[0].priority;
+    for (int i = 1; i < bucket->size; i++) {
+      if ((unsigned)bucket->nodes[i].priority < min) {
+        min = bucket->nodes[i].priority;
+      }
+    }
+    heap->last = min;
+    int count = bucket->size;
+    bucket->size = 0;
+    for (int i = 0; i < count; i++) {
+      HeapNode node = bucket->nodes[i];
+      pushToBucket(heap, bucketIndex(min, node.priority), node);
+    }
+  }
+  RadixBucket* zero = &heap->buckets[0];
+  HeapNode min = zero->nodes[--zero->size];
+  heap->locations[min.id].bucket = NOTHING;
+  heap->size--;
+  return min;
+}
+
+/* Inserts a new node with priority 'priority' and ID 'id' into heap 'heap'.
+ * Precondition: 'id' is unique within this heap
+ *               0 <= 'id' < heap->capacity
+ *               'priority' >= the priority last extracted from 'heap',
+ *                 unless 'heap' is empty
+ */
+void radixInsert(RadixHeap* heap, int priority, int id) {
+  if (heap->size == 0) {
+    heap->last = 0;  // an empty heap starts over, so it can be reused
+  }
+  HeapNode node = {priority, id};
+  pushToBucket(heap, bucketIndex(heap->last, priority), node);
+  heap->size++;
+}
+
+/* Returns priority of the node with ID 'id' in 'heap', or -1 if there is no
+ * such node.
+ * Precondition: 0 <= 'id' < heap->capacity
+ */
+int radixGetPriority(RadixHeap* heap, int id) {
+  RadixLocation location = heap->locations[id];
+  if (location.bucket == NOTHING) {
+    return NOTHING;
+  }
+  return heap->buckets[location.bucket].nodes[location.slot].priority;
+}
+
+/* Returns true iff a node with ID 'id' is in 'heap'. */
+bool radixContains(RadixHeap* heap, int id) {
+  return 0 <= id && id < heap->capacity &&
+         heap->locations[id].bucket != NOTHING;
+}
+
+/* Sets priority of node with ID 'id' in heap 'heap' to 'newPriority', if
+ * such a node exists in 'heap' and its priority is larger than
+ * 'newPriority', and returns True. Has no effect and returns False, otherwise.
+ * Precondition: 'newPriority' >= the priority last extracted from 'heap'
+ */
+bool radixDecreasePriority(RadixHeap* heap, int id, int newPriority) {
+  if (!radixContains(heap, id)) {
+    return false;
+  }
+  RadixLocation location = heap->locations[id];
+  HeapNode* node = &heap->buckets[location.bucket].nodes[location.slot];
+  if (node->priority <= newPriority) {
+    return false;
+  }
+  int index = bucketIndex(heap->last, newPriority);
+  if (index == location.bucket) {
+    node->priority = newPriority;
+  } else {
+    removeFromBucket(heap, id);
+    HeapNode moved = {newPriority, id};
+    pushToBucket(heap, index, moved);
+  }
+  return true;
+}
+
+/* Returns a newly created empty radix heap for node IDs
+ * 0 .. 'capacity' - 1.
+ * Precondition: capacity >= 0
+ */
+RadixHeap* newRadixHeap(int capacity) {
+  RadixHeap* new = malloc(sizeof(RadixHeap));
+  new->size = 0;
+  new->capacity = capacity;
+  new->last = 0;
+  new->locations =
+      malloc(sizeof(RadixLocation) * (capacity > 0 ? capacity : 1));
+  for (int i = 0; i < capacity; i++) {
+    new->locations[i].bucket = NOTHING;
+  }
+  for (int i = 0; i < RADIX_BUCKETS; i++) {
+    new->buckets[i].size = 0;
+    new->buckets[i].capacity = 0;
+    new->buckets[i].nodes = NULL;
+  }
+  return new;
+}
+
+/* Frees all memory allocated for heap 'heap'.
+ */
+void deleteRadixHeap(RadixHeap* heap) {
+  for (int i = 0; i < RADIX_BUCKETS; i++) {
+    free(heap->buckets[i].nodes);
+  }
+  free(heap->locations);
+  free(heap);
+}
@@ -0,0 +1,85 @@
+/*
+ * Header file for our radix heap implementation.
+ *
+ * A RadixHeap is a monotone priority queue for non-negative integer
+ * priorities: every inserted or decreased priority must be at least the
+ * priority most recently extracted, as is the case for Dijkstra's algorithm
+ * with non-negative edge weights. Nodes are kept in 33 buckets by the highest
+ * bit in which their priority differs from the last extracted one, which
+ * makes insert and decreasePriority O(1) and extractMin amortized
+ * O(log C), where C is the largest priority. It has the same contract as
+ * MinHeap, apart from the monotonicity precondition.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "minheap.h"
+
+#ifndef __RadixHeap_header
+#define __RadixHeap_header
+
+#define RADIX_BUCKETS 33
+
+typedef struct radix_bucket {
+  int size;         // number of nodes in this bucket
+  int capacity;     // number of nodes 'nodes' has room for
+  HeapNode* nodes;  // the nodes in this bucket, in no particular order
+} RadixBucket;
+
+typedef struct radix_location {
+  int bucket;  // the bucket holding a node, or -1 if it is not in the heap
+  int slot;    // the position of the node in that bucket
+} RadixLocation;
+
+typedef struct radix_heap {
+  int size;                  // the number of nodes in this heap
+  int capacity;              // the number of node IDs this heap can hold
+  unsigned last;             // priority of the last extracted node; 0 at
+                             //   first and whenever an insert finds the
+                             //   heap empty
+  RadixLocation* locations;  // locations[id] is where node with ID id is
+  RadixBucket buckets[RADIX_BUCKETS];
+} RadixHeap;
+
+/* Removes and returns the node with minimum priority in heap 'heap'.
+ * Precondition: heap is non-empty
+ */
+HeapNode radixExtractMin(RadixHeap* heap);
+
+/* Inserts a new node with priority 'priority' and ID 'id' into heap 'heap'.
+ * Precondition: 'id' is unique within this heap
+ *               0 <= 'id' < heap->capacity
+ *               'priority' >= the priority last extracted from 'heap',
+ *                 unless 'heap' is empty
+ */
+void radixInsert(RadixHeap* heap, int priority, int id);
+
+/* Returns priority of the node with ID 'id' in 'heap', or -1 if there is no
+ * such node.
+ * Precondition: 0 <= 'id' < heap->capacity
+ */
+int radixGetPriority(RadixHeap* heap, int id);
+
+/* Returns true iff a node with ID 'id' is in 'heap'. */
+bool radixContains(RadixHeap* heap, int id);
+
+/* Sets priority of node with ID 'id' in heap 'heap' to 'newPriority', if
+ * such a node exists in 'heap' and its priority is larger than
+ * 'newPriority', and returns True. Has no effect and returns False, otherwise.
+ * Precondition: 'newPriority' >= the priority last extracted from 'heap'
+ */
+bool radixDecreasePriority(RadixHeap* heap, int id, int newPriority);
+
+/* Returns a newly created empty radix heap for node IDs
+ * 0 .. 'capacity' - 1.
+ * Precondition: capacity >= 0
+ */
+RadixHeap* newRadixHeap(int capacity);
+
+/* Frees all memory allocated for heap 'heap'.
+ */
+void deleteRadixHeap(RadixHeap* heap);
+
+#endif
@@ -0,0 +1,183 @@
+/*
+ * Our vectorized edge relaxation kernel.
+ */
+
+#include "relax.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RELAX_X86
+#include <immintrin.h>
+#endif
+
+typedef int (*FilterFunction)(const int* targets, const int* weights,
+                              int count, int base, const int* distances,
+                              int* improved);
+
+/*************************************************************************
+ ** Kernels
+ *************************************************************************/
+
+/* Like filterRelaxations, but checks only indices 'start' .. 'count' - 1
+ * and appends to 'improved' after its first 'numImproved' entries. Returns
+ * the new number of entries.
+ */
+static int filterFrom(const int* targets, const int* weights, int start,
+                      int count, int base, const int* distances,
+                      int* improved, int numImproved) {
+  for (int i = start; i < count; i++) {
+    if ((long long)base + weights[i] < distances[targets[i]]) {
+      improved[numImproved++] = i;
+    }
+  }
+  return numImproved;
+}
+
+/* The scalar kernel. */
+static int filterScalar(const int* targets, const int* weights, int count,
+                        int base, const int* distances, int* improved) {
+  return filterFrom(targets, weights, 0, count, base, distances, improved, 0);
+}
+
+#ifdef RELAX_X86
+/* The AVX2 kernel: 8 slots per step. A sum that wraps around comes out
+ * negative, and is dropped by the second comparison.
+ */
+__attribute__((target("avx2"))) static int filterAVX2(
+    const int* targets, const int* weights, int count, int base,
+    const int* distances, int* improved) {
+  __m256i bases = _mm256_set1_epi32(base);
+  __m256i minusOne = _mm256_set1_epi32(-1);
+  int numImproved = 0;
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i ids = _mm256_loadu_si256((const __m256i*)(targets + i));
+    __m256i sums = _mm256_add_epi32(
+        bases, _mm256_loadu_si256((const __m256i*)(weights + i)));
+    __m256i current = _mm256_i32gather_epi32(distances, ids, 4);
+    __m256i better = _mm256_and_si256(_mm256_cmpgt_epi32(current, sums),
+                                      _mm256_cmpgt_epi32(sums, minusOne));
+    unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(better));
+    while (mask != 0) {
+      improved[numImproved++] = i + __builtin_ctz(mask);
+      mask &= mask - 1;
+    }
+  }
+  return filterFrom(targets, weights, i, count, base, distances, improved,
+                    numImproved);
+}
+
+/* The AVX-512 kernel: 16 slots per step, with the indices of the improving
+ * lanes written out by one compress-store.
+ */
+__attribute__((target("avx512f"))) static int filterAVX512(
+    const int* targets, const int* weights, int count, int base,
+    const int* distances, int* improved) {
+  __m512i bases = _mm512_set1_epi32(base);
+  __m512i zero = _mm512_setzero_si512();
+  __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+                                    12, 13, 14, 15);
+  int numImproved = 0;
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m512i ids = _mm512_loadu_si512(targets + i);
+    __m512i sums = _mm512_add_epi32(bases, _mm512_loadu_si512(weights + i));
+    __m512i current = _mm512_i32gather_epi32(ids, distances, 4);
+    __mmask16 better = _mm512_mask_cmplt_epi32_mask(
+        _mm512_cmpge_epi32_mask(sums, zero), sums, current);
+    _mm512_mask_compressstoreu_epi32(
+        improved + numImproved, better,
+        _mm512_add_epi32(lanes, _mm512_set1_epi32(i)));
+    numImproved += __builtin_popcount(better);
+  }
+  return filterFrom(targets, weights, i, count, base, distances, improved,
+                    numImproved);
+}
+#endif
+
+/*************************************************************************
+ ** Dispatch
+ *************************************************************************/
+
+static RelaxKernel kernel = RELAX_SCALAR;
+static FilterFunction filter = filterScalar;
+
+/* Returns true iff this CPU can run kernel 'candidate'. */
+static bool supported(RelaxKernel candidate) {
+#ifdef RELAX_X86
+  // __builtin_cpu_supports needs this when called from a constructor, as
+  // chooseKernel is; it does nothing once the CPU has been inspected
+  __builtin_cpu_init();
+#endif
+  switch (candidate) {
+    case RELAX_SCALAR:
+      return true;
+#ifdef RELAX_X86
+    case RELAX_AVX2:
+      return __builtin_cpu_supports("avx2");
+    case RELAX_AVX512:
+      return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+      return false;
+  }
+}
+
+/* Returns the fastest kernel this CPU supports. */
+RelaxKernel bestRelaxKernel(void) {
+  RelaxKernel best = RELAX_NUM_KERNELS - 1;
+  while (!supported(best)) best--;
+  return best;
+}
+
+/* Returns the name of kernel 'kernel', or NULL if there is no such kernel.
+ */
+const char* relaxKernelName(RelaxKernel kernel) {
+  switch (kernel) {
+    case RELAX_SCALAR:
+      return "scalar";
+    case RELAX_AVX2:
+      return "avx2";
+    case RELAX_AVX512:
+      return "avx512";
+    default:
+      return NULL;
+  }
+}
+
+/* Makes filterRelaxations use kernel 'kernel' from now on. Returns false,
+ * changing nothing, if this CPU does not support it.
+ */
+bool setRelaxKernel(RelaxKernel choice) {
+  if (!supported(choice)) return false;
+  kernel = choice;
+#ifdef RELAX_X86
+  if (choice == RELAX_AVX512) {
+    filter = filterAVX512;
+  } else if (choice == RELAX_AVX2) {
+    filter = filterAVX2;
+  } else {
+    filter = filterScalar;
+  }
+#endif
+  return true;
+}
+
+/* Returns the kernel filterRelaxations uses. */
+RelaxKernel currentRelaxKernel(void) { return kernel; }
+
+/* Picks the fastest kernel before main runs. */
+__attribute__((constructor)) static void chooseKernel(void) {
+  setRelaxKernel(bestRelaxKernel());
+}
+
+/* Writes to 'improved', in increasing order, every index i in
+ * 0 .. 'count' - 1 for which the path of length base + weights[i] is
+ * shorter than distances[targets[i]], and returns how many there are. Sums
+ * that do not fit in an int improve nothing.
+ * Precondition: base >= 0 and every weight is >= 0
+ *               'improved' has room for 'count' ints
+ */
+int filterRelaxations(const int* targets, const int* weights, int count,
+                      int base, const int* distances, int* improved) {
+  return filter(targets, weights, count, base, distances, improved);
+}
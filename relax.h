@@ -0,0 +1,54 @@
+/*
+ * Header file for our vectorized edge relaxation kernel.
+ *
+ * When Dijkstra's algorithm settles a vertex of a CSRGraph, its edges sit in
+ * two contiguous arrays, and most of them fail to improve anything. The
+ * kernel checks many of them at once: for each slot i it forms
+ * base + weights[i], gathers distances[targets[i]], and compares, 8 lanes at
+ * a time with AVX2 or 16 with AVX-512. Only the improving slots are handed
+ * back, for the caller to relax one by one.
+ *
+ * The kernel is chosen at start-up from what the CPU supports
+ * (__builtin_cpu_supports); the scalar one runs everywhere else.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef __Relax_header
+#define __Relax_header
+
+typedef enum relax_kernel {
+  RELAX_SCALAR = 0,  // one slot at a time
+  RELAX_AVX2,        // 8 slots at a time with AVX2 gathers
+  RELAX_AVX512,      // 16 slots at a time with AVX-512 gathers and masks
+  RELAX_NUM_KERNELS
+} RelaxKernel;
+
+/* Returns the fastest kernel this CPU supports. */
+RelaxKernel bestRelaxKernel(void);
+
+/* Returns the name of kernel 'kernel', or NULL if there is no such kernel.
+ */
+const char* relaxKernelName(RelaxKernel kernel);
+
+/* Makes filterRelaxations use kernel 'kernel' from now on. Returns false,
+ * changing nothing, if this CPU does not support it.
+ */
+bool setRelaxKernel(RelaxKernel kernel);
+
+/* Returns the kernel filterRelaxations uses. */
+RelaxKernel currentRelaxKernel(void);
+
+/* Writes to 'improved', in increasing order, every index i in
+ * 0 .. 'count' - 1 for which the path of length base + weights[i] is
+ * shorter than distances[targets[i]], and returns how many there are. Sums
+ * that do not fit in an int improve nothing.
+ * Precondition: base >= 0 and every weight is >= 0
+ *               'improved' has room for 'count' ints
+ */
+int filterRelaxations(const int* targets, const int* weights, int count,
+                      int base, const int* distances, int* improved);
+
+#endif
@@ -0,0 +1,341 @@
+/*
+ * Our vertex reordering pass.
+ */
+
+#include "reorder.h"
+
+#include <stdint.h>
+
+#define MAX_PERIPHERY_ROUNDS 8
+
+/*************************************************************************
+ ** Orders
+ *************************************************************************/
+
+/* Returns the number of neighbours of 'vertex' in 'graph'. */
+static int degreeOf(CSRGraph* graph, int vertex) {
+  return graph->offsets[vertex + 1] - graph->offsets[vertex];
+}
+
+/* Writes the vertices of 'graph' to 'order' by degree, lowest first if
+ * 'ascending' is true and highest first otherwise; ties keep ID order.
+ * Sorted by counting, in O(numVertices + maximum degree) time.
+ */
+static void sortByDegree(CSRGraph* graph, bool ascending, int* order) {
+  int numVertices = graph->numVertices;
+  int maxDegree = 0;
+  for (int v = 0; v < numVertices; v++) {
+    if (degreeOf(graph, v) > maxDegree) maxDegree = degreeOf(graph, v);
+  }
+  int* starts = calloc(maxDegree + 2, sizeof(int));
+  for (int v = 0; v < numVertices; v++) {
+    int key = ascending ? degreeOf(graph, v) : maxDegree - degreeOf(graph, v);
+    starts[key + 1]++;
+  }
+  for (int d = 0; d <= maxDegree; d++) {
+    starts[d + 1] += starts[d];
+  }
+  for (int v = 0; v < numVertices; v++) {
+    int key = ascending ? degreeOf(graph, v) : maxDegree - degreeOf(graph, v);
+    order[starts[key]++] = v;
+  }
+  free(starts);
+}
+
+/* Comparison function for qsort on uint64_t keys. */
+static int compareKeys(const void* a, const void* b) {
+  uint64_t x = *(const uint64_t*)a;
+  uint64_t y = *(const uint64_t*)b;
+  return (x > y) - (x < y);
+}
+
+/* Sorts the 'count' vertices of 'vertices' by increasing degree in 'graph',
+ * ties by ID, using 'keys' as scratch space for 'count' keys.
+ */
+static void sortVerticesByDegree(CSRGraph* graph, int* vertices, int count,
+                                 uint64_t* keys) {
+  for (int i = 0; i < count; i++) {
+    keys[i] = (uint64_t)degreeOf(graph, vertices[i]) << 32 | vertices[i];
+  }
+  qsort(keys, count, sizeof(uint64_t), compareKeys);
+  for (int i = 0; i < count; i++) {
+    vertices[i] = (int)(keys[i] & UINT32_MAX);
+  }
+}
+
+/* Appends to 'queue' (holding 'size' vertices) the unvisited vertices
+ * reachable from 'root' in breadth-first order, marking them in 'visited',
+ * and returns the new size. If 'keys' is not NULL, the neighbours of each
+ * vertex are taken by increasing degree, as Cuthill-McKee does, and 'keys'
+ * is scratch space for graph->numVertices keys.
+ */
+static int breadthFirst(CSRGraph* graph, int root, bool* visited,
+                        int* queue, int size, uint64_t* keys) {
+  int head = size;
+  visited[root] = true;
+  queue[size++] = root;
+  while (head < size) {
+    int u = queue[head++];
+    int first = size;
+    for (int i = graph->offsets[u]; i < graph->offsets[u + 1]; i++) {
+      int v = graph->targets[i];
+      if (visited[v]) continue;
+      visited[v] = true;
+      queue[size++] = v;
+    }
+    if (keys != NULL && size - first > 1) {
+      sortVerticesByDegree(graph, queue + first, size - first, keys);
+    }
+  }
+  return size;
+}
+
+/* Returns a pseudo-peripheral vertex of the component of 'root': starting
+ * from 'root', repeatedly moves to a vertex of lowest degree in the last
+ * breadth-first level while that lengthens the search, as George and Liu
+ * do. 'visited' and 'queue' are scratch space; 'visited' is left false.
+ */
+static int peripheralVertex(CSRGraph* graph, int root, bool* visited,
+                            int* queue) {
+  int depth = -1;
+  for (int round = 0; round < MAX_PERIPHERY_ROUNDS; round++) {
+    // a level by level search; 'levelStart' is where the last level begins
+    int size = 0;
+    int levelStart = 0;
+    int newDepth = -1;
+    visited[root] = true;
+    queue[size++] = root;
+    while (levelStart < size) {
+      int levelEnd = size;
+      newDepth++;
+      for (int k = levelStart; k < levelEnd; k++) {
+        int u = queue[k];
+        for (int i = graph->offsets[u]; i < graph->offsets[u + 1]; i++) {
+          int v = graph->targets[i];
+          if (visited[v]) continue;
+          visited[v] = true;
+          queue[size++] = v;
+        }
+      }
+      if (size == levelEnd) break;
+      levelStart = levelEnd;
+    }
+    int next = queue[levelStart];
+    for (int k = levelStart; k < size; k++) {
+      if (degreeOf(graph, queue[k]) < degreeOf(graph, next)) next = queue[k];
+    }
+    for (int k = 0; k < size; k++) {
+      visited[queue[k]] = false;
+    }
+    if (newDepth <= depth) break;
+    depth = newDepth;
+    root = next;
+  }
+  return root;
+}
+
+/* Writes the vertices of 'graph' to 'order' in breadth-first order, one
+ * component after another, with components started from 'seeds' in turn.
+ * If 'rcm' is true, each component starts from a pseudo-peripheral vertex,
+ * neighbours are taken by increasing degree and the result is reversed.
+ */
+static void breadthFirstOrder(CSRGraph* graph, int* seeds, bool rcm,
+                              int* order) {
+  int numVertices = graph->numVertices;
+  bool* visited = calloc(numVertices > 0 ? numVertices : 1, sizeof(bool));
+  int* scratch = rcm ? malloc(sizeof(int) * numVertices) : NULL;
+  uint64_t* keys = rcm ? malloc(sizeof(uint64_t) * numVertices) : NULL;
+  int size = 0;
+  for (int s = 0; s < numVertices; s++) {
+    int root = seeds[s];
+    if (visited[root]) continue;
+    if (rcm) root = peripheralVertex(graph, root, visited, scratch);
+    size = breadthFirst(graph, root, visited, order, size, keys);
+  }
+  for (int i = 0; rcm && i < numVertices / 2; i++) {
+    int swap = order[i];
+    order[i] = order[numVertices - 1 - i];
+    order[numVertices - 1 - i] = swap;
+  }
+  free(keys);
+  free(scratch);
+  free(visited);
+}
+
+/* Returns a newly created Permutation that renumbers the vertices of 'graph'
+ * in order 'order', or NULL if there is no such order.
+ */
+Permutation* vertexOrder(CSRGraph* graph, VertexOrder order) {
+  if (order < 0 || order >= ORDER_NUM_KINDS) return NULL;
+  int numVertices = graph->numVertices;
+  int slots = numVertices > 0 ? numVertices : 1;
+  Permutation* permutation = malloc(sizeof(Permutation));
+  permutation->numVertices = numVertices;
+  permutation->oldIds = malloc(sizeof(int) * slots);
+  permutation->newIds = malloc(sizeof(int) * slots);
+  int* oldIds = permutation->oldIds;
+  if (order == ORDER_DEGREE) {
+    sortByDegree(graph, false, oldIds);
+  } else {
+    // components start from their lowest-numbered vertex for BFS, and
+    // from one of lowest degree for RCM
+    int* seeds = malloc(sizeof(int) * slots);
+    if (order == ORDER_RCM) {
+      sortByDegree(graph, true, seeds);
+    } else {
+      for (int v = 0; v < numVertices; v++) seeds[v] = v;
+    }
+    breadthFirstOrder(graph, seeds, order == ORDER_RCM, oldIds);
+    free(seeds);
+  }
+  for (int v = 0; v < numVertices; v++) {
+    permutation->newIds[oldIds[v]] = v;
+  }
+  return permutation;
+}
+
+/* Returns the name of order 'order', or NULL if there is no such order. */
+const char* vertexOrderName(VertexOrder order) {
+  switch (order) {
+    case ORDER_BFS:
+      return "bfs";
+    case ORDER_RCM:
+      return "rcm";
+    case ORDER_DEGREE:
+      return "degree";
+    default:
+      return NULL;
+  }
+}
+
+/* Frees memory allocated for 'permutation'.
+ */
+void deletePermutation(Permutation* permutation) {
+  if (permutation == NULL) return;
+  free(permutation->newIds);
+  free(permutation->oldIds);
+  free(permutation);
+}
+
+/*************************************************************************
+ ** Renumbering
+ *************************************************************************/
+
+/* Returns ids['vertex'], or 'vertex' itself if it is not one of the
+ * 'numVertices' vertices.
+ */
+static int renamed(int vertex, int* ids, int numVertices) {
+  return 0 <= vertex && vertex < numVertices ? ids[vertex] : vertex;
+}
+
+/* Returns a newly created CSRGraph: 'graph' with its vertices renumbered by
+ * 'permutation'. Each vertex keeps its neighbours in their original order.
+ * Precondition: 'permutation' has graph->numVertices vertices
+ */
+CSRGraph* permuteCSRGraph(CSRGraph* graph, Permutation* permutation) {
+  int numVertices = graph->numVertices;
+  CSRGraph* result = newCSRGraph(numVertices, graph->numEdges);
+  int slot = 0;
+  for (int v = 0; v < numVertices; v++) {
+    int old = permutation->oldIds[v];
+    result->offsets[v] = slot;
+    for (int i = graph->offsets[old]; i < graph->offsets[old + 1]; i++) {
+      result->targets[slot] = permutation->newIds[graph->targets[i]];
+      result->weights[slot] = graph->weights[i];
+      slot++;
+    }
+  }
+  result->offsets[numVertices] = slot;
+  return result;
+}
+
+/* Returns a newly created arena-backed Graph: 'graph' with its vertices
+ * renumbered by 'permutation'. Adjacency lists keep their order and are
+ * allocated one vertex after another in the new order. Vertex values are
+ * carried over.
+ * Precondition: 'permutation' has graph->numVertices vertices
+ */
+Graph* permuteGraph(Graph* graph, Permutation* permutation) {
+  int numVertices = graph->numVertices;
+  Graph* result = newArenaGraph(numVertices);
+  result->numEdges = graph->numEdges;
+  int* newIds = permutation->newIds;
+  Edge** edges = NULL;
+  int capacity = 0;
+  for (int v = 0; v < numVertices; v++) {
+    Vertex* old = &graph->vertices[permutation->oldIds[v]];
+    Vertex* vertex = &result->vertices[v];
+    vertex->id = v;
+    vertex->value = old->value;
+    // prepending in reverse keeps the list in its original order
+    int count = 0;
+    for (AdjList* node = old->adjList; node != NULL; node = node->next) {
+      if (count == capacity) {
+        capacity = capacity > 0 ? 2 * capacity : 16;
+        edges = realloc(edges, sizeof(Edge*) * capacity);
+      }
+      edges[count++] = node->edge;
+    }
+    vertex->adjList = NULL;
+    while (count > 0) {
+      Edge* edge = edges[--count];
+      int from = renamed(edge->fromVertex, newIds, numVertices);
+      int to = renamed(edge->toVertex, newIds, numVertices);
+      vertex->adjList =
+          prependEdge(result, vertex->adjList, from, to, edge->weight);
+    }
+  }
+  free(edges);
+  return result;
+}
+
+/* Returns a newly created distance tree in original IDs from 'tree', a
+ * distance tree produced by Dijkstra's algorithm on a graph renumbered by
+ * 'permutation': entry v of the result is the edge of original vertex v.
+ * Endpoints outside the graph (such as -1 for unreached vertices) are kept.
+ */
+Edge* distanceTreeToOriginal(Edge* tree, Permutation* permutation) {
+  int numVertices = permutation->numVertices;
+  int* oldIds = permutation->oldIds;
+  Edge* result = malloc(sizeof(Edge) * (numVertices > 0 ? numVertices : 1));
+  for (int v = 0; v < numVertices; v++) {
+    Edge edge = tree[v];
+    result[oldIds[v]] = (Edge){renamed(edge.fromVertex, oldIds, numVertices),
+                               renamed(edge.toVertex, oldIds, numVertices),
+                               edge.weight};
+  }
+  return result;
+}
+
+/* Renames the endpoints of the 'numEdges' edges in 'edges', such as an MST
+ * produced by Prim's algorithm on a graph renumbered by 'permutation', back
+ * to original IDs. Endpoints outside the graph are kept.
+ */
+void edgesToOriginal(Edge* edges, int numEdges, Permutation* permutation) {
+  int numVertices = permutation->numVertices;
+  for (int i = 0; i < numEdges; i++) {
+    edges[i].fromVertex =
+        renamed(edges[i].fromVertex, permutation->oldIds, numVertices);
+    edges[i].toVertex =
+        renamed(edges[i].toVertex, permutation->oldIds, numVertices);
+  }
+}
+
+/*************************************************************************
+ ** Locality
+ *************************************************************************/
+
+/* Returns the mean distance between the IDs of a vertex and a neighbour
+ * over all adjacency slots of 'graph': a rough measure of how far apart in
+ * memory the records of neighbouring vertices are.
+ */
+double meanNeighbourGap(CSRGraph* graph) {
+  if (graph->numEdges == 0) return 0;
+  double total = 0;
+  for (int v = 0; v < graph->numVertices; v++) {
+    for (int i = graph->offsets[v]; i < graph->offsets[v + 1]; i++) {
+      total += abs(graph->targets[i] - v);
+    }
+  }
+  return total / graph->numEdges;
+}
@@ -0,0 +1,95 @@
+/*
+ * Header file for our vertex reordering pass.
+ *
+ * Vertex IDs come straight from the input, so the neighbours of a vertex
+ * can sit anywhere in the vertices array, the CSR offsets and the heap's
+ * indexMap, and nearly every relaxation misses the cache. Renumbering the
+ * vertices so that neighbours get nearby IDs fixes that:
+ *   ORDER_BFS     breadth-first order, one component after another
+ *   ORDER_RCM     reverse Cuthill-McKee: breadth-first from a
+ *                 pseudo-peripheral vertex, neighbours taken by increasing
+ *                 degree, and the whole order reversed; keeps the bandwidth
+ *                 of the adjacency matrix small
+ *   ORDER_DEGREE  by decreasing degree, so hubs share cache lines
+ * A Permutation records the renumbering both ways. Run the algorithms on
+ * the permuted graph, starting from newIds[start], and map their results
+ * back with distanceTreeToOriginal or edgesToOriginal. Distances and tree
+ * weights are the same as on the original graph; among equally short paths
+ * or equally light edges, a different one may be picked.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "csr.h"
+#include "graph.h"
+
+#ifndef __Reorder_header
+#define __Reorder_header
+
+typedef enum vertex_order {
+  ORDER_BFS = 0,  // breadth-first
+  ORDER_RCM,      // reverse Cuthill-McKee
+  ORDER_DEGREE,   // decreasing degree
+  ORDER_NUM_KINDS
+} VertexOrder;
+
+typedef struct permutation {
+  int numVertices;  // vertices are 0, 1, ..., numVertices-1
+  int* newIds;      // newIds[v] is the new ID of original vertex v
+  int* oldIds;      // oldIds[v] is the original ID of new vertex v
+} Permutation;
+
+/***** Orders ***************************************************************/
+
+/* Returns a newly created Permutation that renumbers the vertices of 'graph'
+ * in order 'order', or NULL if there is no such order.
+ */
+Permutation* vertexOrder(CSRGraph* graph, VertexOrder order);
+
+/* Returns the name of order 'order', or NULL if there is no such order. */
+const char* vertexOrderName(VertexOrder order);
+
+/* Frees memory allocated for 'permutation'.
+ */
+void deletePermutation(Permutation* permutation);
+
+/***** Renumbering **********************************************************/
+
+/* Returns a newly created CSRGraph: 'graph' with its vertices renumbered by
+ * 'permutation'. Each vertex keeps its neighbours in their original order.
+ * Precondition: 'permutation' has graph->numVertices vertices
+ */
+CSRGraph* permuteCSRGraph(CSRGraph* graph, Permutation* permutation);
+
+/* Returns a newly created arena-backed Graph: 'graph' with its vertices
+ * renumbered by 'permutation'. Adjacency lists keep their order and are
+ * allocated one vertex after another in the new order. Vertex values are
+ * carried over.
+ * Precondition: 'permutation' has graph->numVertices vertices
+ */
+Graph* permuteGraph(Graph* graph, Permutation* permutation);
+
+/* Returns a newly created distance tree in original IDs from 'tree', a
+ * distance tree produced by Dijkstra's algorithm on a graph renumbered by
+ * 'permutation': entry v of the result is the edge of original vertex v.
+ * Endpoints outside the graph (such as -1 for unreached vertices) are kept.
+ */
+Edge* distanceTreeToOriginal(Edge* tree, Permutation* permutation);
+
+/* Renames the endpoints of the 'numEdges' edges in 'edges', such as an MST
+ * produced by Prim's algorithm on a graph renumbered by 'permutation', back
+ * to original IDs. Endpoints outside the graph are kept.
+ */
+void edgesToOriginal(Edge* edges, int numEdges, Permutation* permutation);
+
+/***** Locality *************************************************************/
+
+/* Returns the mean distance between the IDs of a vertex and a neighbour
+ * over all adjacency slots of 'graph': a rough measure of how far apart in
+ * memory the records of neighbouring vertices are.
+ */
+double meanNeighbourGap(CSRGraph* graph);
+
+#endif
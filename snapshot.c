@@ -0,0 +1,266 @@
+/*
+ * Our binary graph snapshots.
+ */
+
+#include "snapshot.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FNV_PRIME 0x100000001b3ull
+
+/* Returns 'offset' rounded up to the next section boundary. */
+uint64_t alignSection(uint64_t offset) {
+  return (offset + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN;
+}
+
+/* Folds the 'count' ints at 'values' into the running FNV-1a hash 'hash',
+ * one 32-bit word at a time, and returns the result.
+ */
+uint64_t hashInts(uint64_t hash, const int* values, uint64_t count) {
+  for (uint64_t i = 0; i < count; i++) {
+    hash ^= (uint32_t)values[i];
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+/* Returns the checksum stored in snapshots of 'graph'. */
+uint64_t snapshotChecksum(CSRGraph* graph) {
+  uint64_t hash = CHECKSUM_SEED;
+  hash = hashInts(hash, graph->offsets, (uint64_t)graph->numVertices + 1);
+  hash = hashInts(hash, graph->targets, graph->numEdges);
+  hash = hashInts(hash, graph->weights, graph->numEdges);
+  return hash;
+}
+
+/* Returns true iff a section of 'count' items of 'itemSize' bytes each,
+ * starting at byte offset 'offset', ends at or before byte offset 'end'.
+ * Header fields are checked with this before any of them is added or
+ * multiplied, so a corrupt header cannot wrap around.
+ * Precondition: itemSize > 0
+ */
+bool sectionFits(uint64_t offset, uint64_t count, uint64_t itemSize,
+                 uint64_t end) {
+  return offset <= end && count <= (end - offset) / itemSize;
+}
+
+/* Fills in 'header' for a snapshot of 'graph'. */
+static void makeHeader(CSRGraph* graph, SnapshotHeader* header) {
+  memset(header, 0, sizeof(SnapshotHeader));
+  strcpy(header->magic, SNAPSHOT_MAGIC);
+  header->version = SNAPSHOT_VERSION;
+  header->byteOrder = SNAPSHOT_BYTE_ORDER;
+  header->headerSize = sizeof(SnapshotHeader);
+  header->weightSize = sizeof(int);
+  header->numVertices = graph->numVertices;
+  header->numEdges = graph->numEdges;
+  header->offsetsOffset = alignSection(sizeof(SnapshotHeader));
+  header->targetsOffset = alignSection(
+      header->offsetsOffset + sizeof(int) * (header->numVertices + 1));
+  header->weightsOffset =
+      alignSection(header->targetsOffset + sizeof(int) * header->numEdges);
+  header->fileSize = header->weightsOffset + sizeof(int) * header->numEdges;
+  header->checksum = snapshotChecksum(graph);
+}
+
+/* Writes 'size' bytes at 'data' to 'f' at byte offset 'offset', padding with
+ * zeros from the current position. Returns false on failure.
+ */
+bool writeSection(FILE* f, uint64_t offset, const void* data, uint64_t size) {
+  static const char zeros[SECTION_ALIGN] = {0};
+  long position = ftell(f);
+  if (position < 0 || (uint64_t)position > offset) return false;
+  if (fwrite(zeros, 1, offset - position, f) != offset - position) {
+    return false;
+  }
+  return fwrite(data, 1, size, f) == size;
+}
+
+/* Writes the 'numSections' 'sections' to the file at 'path', under a
+ * temporary name that is renamed into place, so readers never see a partial
+ * file. Returns false and fills in 'error' (if not NULL), naming the file
+ * 'kind', on failure.
+ * Precondition: the sections are in order of offset and do not overlap
+ */
+bool writeFileAtomically(const char* path, const FileSection* sections,
+                         int numSections, const char* kind, LoadError* error) {
+  size_t length = strlen(path);
+  char* tmpPath = malloc(length + 5);
+  memcpy(tmpPath, path, length);
+  memcpy(tmpPath + length, ".tmp", 5);
+
+  FILE* f = fopen(tmpPath, "wb");
+  if (f == NULL) {
+    setLoadError(error, 0, 0, 0, "Unable to create %s: %s", kind,
+                 strerror(errno));
+    free(tmpPath);
+    return false;
+  }
+  bool written = true;
+  for (int i = 0; i < numSections && written; i++) {
+    written = writeSection(f, sections[i].offset, sections[i].data,
+                           sections[i].size);
+  }
+  if (fclose(f) != 0) written = false;
+  if (!written || rename(tmpPath, path) != 0) {
+    setLoadError(error, 0, 0, 0, "Could not write %s: %s", kind,
+                 strerror(errno));
+    remove(tmpPath);
+    free(tmpPath);
+    return false;
+  }
+  free(tmpPath);
+  return true;
+}
+
+/* Writes 'graph' as a snapshot to the file at 'path'. The file is written
+ * under a temporary name and renamed into place, so readers never see a
+ * partial snapshot. Returns false and fills in 'error' (if not NULL) on
+ * failure.
+ */
+bool writeCSRSnapshot(CSRGraph* graph, const char* path, LoadError* error) {
+  if (error != NULL) error->failed = false;
+  SnapshotHeader header;
+  makeHeader(graph, &header);
+
+  FileSection sections[] = {
+      {0, &header, sizeof(SnapshotHeader)},
+      {header.offsetsOffset, graph->offsets,
+       sizeof(int) * (header.numVertices + 1)},
+      {header.targetsOffset, graph->targets, sizeof(int) * header.numEdges},
+      {header.weightsOffset, graph->weights, sizeof(int) * header.numEdges},
+  };
+  return writeFileAtomically(path, sections, 4, "snapshot", error);
+}
+
+/* Checks 'header' of a snapshot file of 'fileSize' bytes. Returns false and
+ * fills in 'error' if it is not a snapshot this code can read.
+ */
+static bool checkHeader(SnapshotHeader* header, uint64_t fileSize,
+                        LoadError* error) {
+  if (fileSize < sizeof(SnapshotHeader) ||
+      memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+    setLoadError(error, 0, 0, 0, "Not a graph snapshot");
+    return false;
+  }
+  if (header->version != SNAPSHOT_VERSION) {
+    setLoadError(error, 0, 0, 0, "Unsupported snapshot version %u",
+                 header->version);
+    return false;
+  }
+  if (header->byteOrder != SNAPSHOT_BYTE_ORDER ||
+      header->headerSize != sizeof(SnapshotHeader) ||
+      header->weightSize != sizeof(int)) {
+    setLoadError(error, 0, 0, 0, "Snapshot was written on another platform");
+    return false;
+  }
+  if (header->numVertices >= INT32_MAX || header->numEdges > INT32_MAX ||
+      header->fileSize != fileSize ||
+      header->offsetsOffset % SECTION_ALIGN != 0 ||
+      header->targetsOffset % SECTION_ALIGN != 0 ||
+      header->weightsOffset % SECTION_ALIGN != 0 ||
+      !sectionFits(header->offsetsOffset, header->numVertices + 1,
+                   sizeof(int), header->targetsOffset) ||
+      !sectionFits(header->targetsOffset, header->numEdges, sizeof(int),
+                   header->weightsOffset) ||
+      !sectionFits(header->weightsOffset, header->numEdges, sizeof(int),
+                   fileSize)) {
+    setLoadError(error, 0, 0, 0, "Snapshot is truncated or corrupt");
+    return false;
+  }
+  return true;
+}
+
+/* Checks the arrays of 'graph', loaded from a snapshot with 'header'.
+ * Returns false and fills in 'error' if they are inconsistent.
+ */
+static bool checkArrays(CSRGraph* graph, SnapshotHeader* header,
+                        LoadError* error) {
+  if (snapshotChecksum(graph) != header->checksum) {
+    setLoadError(error, 0, 0, 0, "Snapshot checksum mismatch");
+    return false;
+  }
+  if (graph->offsets[0] != 0 ||
+      graph->offsets[graph->numVertices] != graph->numEdges) {
+    setLoadError(error, 0, 0, header->offsetsOffset,
+                 "Snapshot offsets do not cover the edges");
+    return false;
+  }
+  for (int v = 0; v < graph->numVertices; v++) {
+    if (graph->offsets[v] > graph->offsets[v + 1]) {
+      setLoadError(error, 0, 0, header->offsetsOffset + sizeof(int) * v,
+                   "Snapshot offsets decrease at vertex %d", v);
+      return false;
+    }
+  }
+  for (int i = 0; i < graph->numEdges; i++) {
+    if (graph->targets[i] < 0 || graph->targets[i] >= graph->numVertices) {
+      setLoadError(error, 0, 0, header->targetsOffset + sizeof(int) * i,
+                   "Invalid vertex ID in snapshot: %d", graph->targets[i]);
+      return false;
+    }
+  }
+  for (int i = 0; i < graph->numEdges; i++) {
+    if (graph->weights[i] < 0) {
+      setLoadError(error, 0, 0, header->weightsOffset + sizeof(int) * i,
+                   "Negative weight in snapshot: %d", graph->weights[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Returns a CSRGraph whose arrays point straight into the memory-mapped
+ * snapshot at 'path'. The header is always validated; if 'verify' is true,
+ * the checksum and the offsets/targets/weights arrays are checked as well,
+ * which reads the whole file. The result must be freed with deleteCSRGraph
+ * and must not be modified.
+ * Returns NULL and fills in 'error' (if not NULL) on failure.
+ */
+CSRGraph* loadCSRSnapshot(const char* path, bool verify, LoadError* error) {
+  if (error != NULL) error->failed = false;
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    setLoadError(error, 0, 0, 0, "Unable to open snapshot: %s",
+                 strerror(errno));
+    return NULL;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(SnapshotHeader)) {
+    setLoadError(error, 0, 0, 0, "Not a graph snapshot");
+    close(fd);
+    return NULL;
+  }
+  void* mapping = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    setLoadError(error, 0, 0, 0, "Could not map snapshot: %s",
+                 strerror(errno));
+    return NULL;
+  }
+
+  SnapshotHeader* header = mapping;
+  if (!checkHeader(header, info.st_size, error)) {
+    munmap(mapping, info.st_size);
+    return NULL;
+  }
+  CSRGraph* graph = malloc(sizeof(CSRGraph));
+  char* base = mapping;
+  graph->numVertices = header->numVertices;
+  graph->numEdges = header->numEdges;
+  graph->offsets = (int*)(base + header->offsetsOffset);
+  graph->targets = (int*)(base + header->targetsOffset);
+  graph->weights = (int*)(base + header->weightsOffset);
+  graph->mapping = mapping;
+  graph->mappingSize = info.st_size;
+  if (verify && !checkArrays(graph, header, error)) {
+    deleteCSRGraph(graph);
+    return NULL;
+  }
+  return graph;
+}
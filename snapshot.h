@@ -0,0 +1,104 @@
+/*
+ * Header file for our binary graph snapshots.
+ *
+ * A snapshot stores a CSRGraph exactly as it sits in memory, so loading one
+ * is a single mmap: the offsets, targets and weights arrays are used in
+ * place, with no parsing and no per-edge allocation.
+ *
+ * Layout (native byte order, every section 64-byte aligned):
+ *   SnapshotHeader
+ *   int offsets[numVertices + 1]
+ *   int targets[numEdges]
+ *   int weights[numEdges]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "csr.h"
+#include "graph_io.h"
+
+#ifndef __Snapshot_header
+#define __Snapshot_header
+
+#define SNAPSHOT_MAGIC "PRIMCSR"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+#define SECTION_ALIGN 64
+#define CHECKSUM_SEED 0xcbf29ce484222325ull
+
+typedef struct snapshot_header {
+  char magic[8];           // SNAPSHOT_MAGIC, NUL-terminated
+  uint32_t version;        // SNAPSHOT_VERSION of the writer
+  uint32_t byteOrder;      // SNAPSHOT_BYTE_ORDER as written by the writer
+  uint32_t headerSize;     // sizeof(SnapshotHeader)
+  uint32_t weightSize;     // sizeof of one weight, in bytes
+  uint64_t numVertices;    // number of vertices
+  uint64_t numEdges;       // number of adjacency slots
+  uint64_t offsetsOffset;  // byte offset of the offsets array in the file
+  uint64_t targetsOffset;  // byte offset of the targets array in the file
+  uint64_t weightsOffset;  // byte offset of the weights array in the file
+  uint64_t fileSize;       // total size of the file, in bytes
+  uint64_t checksum;       // snapshotChecksum of the three arrays
+} SnapshotHeader;
+
+typedef struct file_section {
+  uint64_t offset;   // byte offset of the section in the file
+  const void* data;  // the bytes to write there
+  uint64_t size;     // number of bytes at 'data'
+} FileSection;
+
+/* Writes 'graph' as a snapshot to the file at 'path'. The file is written
+ * under a temporary name and renamed into place, so readers never see a
+ * partial snapshot. Returns false and fills in 'error' (if not NULL) on
+ * failure.
+ */
+bool writeCSRSnapshot(CSRGraph* graph, const char* path, LoadError* error);
+
+/* Returns a CSRGraph whose arrays point straight into the memory-mapped
+ * snapshot at 'path'. The header is always validated; if 'verify' is true,
+ * the checksum and the offsets/targets/weights arrays are checked as well,
+ * which reads the whole file. The result must be freed with deleteCSRGraph
+ * and must not be modified.
+ * Returns NULL and fills in 'error' (if not NULL) on failure.
+ */
+CSRGraph* loadCSRSnapshot(const char* path, bool verify, LoadError* error);
+
+/* Returns the checksum stored in snapshots of 'graph'. */
+uint64_t snapshotChecksum(CSRGraph* graph);
+
+/* Folds the 'count' ints at 'values' into the running FNV-1a hash 'hash',
+ * one 32-bit word at a time, and returns the result. A checksum starts from
+ * CHECKSUM_SEED.
+ */
+uint64_t hashInts(uint64_t hash, const int* values, uint64_t count);
+
+/* Returns true iff a section of 'count' items of 'itemSize' bytes each,
+ * starting at byte offset 'offset', ends at or before byte offset 'end'.
+ * Header fields are checked with this before any of them is added or
+ * multiplied, so a corrupt header cannot wrap around.
+ * Precondition: itemSize > 0
+ */
+bool sectionFits(uint64_t offset, uint64_t count, uint64_t itemSize,
+                 uint64_t end);
+
+/* Returns 'offset' rounded up to the next section boundary. */
+uint64_t alignSection(uint64_t offset);
+
+/* Writes 'size' bytes at 'data' to 'f' at byte offset 'offset', padding with
+ * zeros from the current position. Returns false on failure.
+ */
+bool writeSection(FILE* f, uint64_t offset, const void* data, uint64_t size);
+
+/* Writes the 'numSections' 'sections' to the file at 'path', under a
+ * temporary name that is renamed into place, so readers never see a partial
+ * file. Returns false and fills in 'error' (if not NULL), naming the file
+ * 'kind', on failure.
+ * Precondition: the sections are in order of offset and do not overlap
+ */
+bool writeFileAtomically(const char* path, const FileSection* sections,
+                         int numSections, const char* kind, LoadError* error);
+
+#endif
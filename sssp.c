@@ -0,0 +1,371 @@
+/*
+ * Our parallel shortest path engines.
+ */
+
+#include "sssp.h"
+
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "parallel.h"
+
+#define NOTHING -1
+
+// label of a vertex that has not been reached: (INT_MAX, NOTHING)
+#define UNREACHED ((uint64_t)INT_MAX << 32 | UINT32_MAX)
+
+// most buckets a thread keeps; delta is raised if the weights need more
+#define MAX_BUCKETS 4096
+
+// number of frontier vertices a thread claims at a time
+#define FRONTIER_CHUNK 64
+
+/*************************************************************************
+ ** Labels and vertex lists
+ *************************************************************************/
+
+/* Returns the label of a vertex at distance 'distance' via 'pred'. */
+static inline uint64_t makeLabel(int distance, int pred) {
+  return (uint64_t)distance << 32 | (uint32_t)pred;
+}
+
+/* Returns the distance in 'label'. */
+static inline int labelDistance(uint64_t label) { return label >> 32; }
+
+/* Returns the predecessor in 'label'. */
+static inline int labelPred(uint64_t label) { return (int)(uint32_t)label; }
+
+typedef struct vertex_list {
+  int size;      // number of vertices in the list
+  int capacity;  // number of vertices 'ids' has room for
+  int* ids;      // the vertices
+} VertexList;
+
+/* Appends vertex 'id' to 'list'. Returns false, leaving 'list' unchanged,
+ * if it cannot grow.
+ */
+static bool listPush(VertexList* list, int id) {
+  if (list->size == list->capacity) {
+    int capacity = list->capacity > 0 ? 2 * list->capacity : 16;
+    int* bigger = realloc(list->ids, sizeof(int) * capacity);
+    if (bigger == NULL) return false;
+    list->ids = bigger;
+    list->capacity = capacity;
+  }
+  list->ids[list->size++] = id;
+  return true;
+}
+
+/*************************************************************************
+ ** Delta-stepping
+ *************************************************************************/
+
+typedef struct delta_job {
+  CSRGraph* graph;          // the graph
+  int delta;                // width of a bucket
+  int numBuckets;           // number of buckets each thread keeps, cyclically
+  _Atomic uint64_t* labels;  // labels[v] is (distance << 32 | pred) of v
+  _Atomic int* relaxedAt;   // relaxedAt[v] is the distance at which v's
+                            //   light edges were last relaxed, or -1
+  int* frontier;            // vertices of the current bucket to process
+  int frontierSize;         // number of vertices in 'frontier'
+  int frontierCapacity;     // number of vertices 'frontier' has room for
+  _Atomic int nextChunk;    // first frontier slot not yet claimed
+  long bucket;              // index of the bucket being settled
+  bool done;                // true iff no bucket is left
+  bool failed;              // true iff the frontier or a vertex list could
+                            //   not grow
+  _Atomic bool pushFailed;  // true iff a vertex list could not grow; turned
+                            //   into 'failed' by gatherFrontier
+  VertexList* buckets;      // numBuckets buckets for each thread
+  VertexList* settled;      // settled[t] lists the vertices thread t took
+                            //   from the current bucket
+  long* shared;             // one value published by each thread
+  Barrier* barrier;         // lines the threads up between phases
+} DeltaJob;
+
+/* Returns the index of the bucket holding distance 'distance'. */
+static inline long bucketOf(DeltaJob* job, long distance) {
+  return distance / job->delta;
+}
+
+/* Offers vertex 'v' the path through vertex 'u', at distance 'distance' over
+ * an edge of weight 'weight'. If that is shorter, updates v's label and puts
+ * v into the right one of 'buckets'.
+ */
+static void relax(DeltaJob* job, VertexList* buckets, int u, int distance,
+                  int v, int weight) {
+  long offer = (long)distance + weight;
+  if (offer >= INT_MAX) return;
+  uint64_t label = makeLabel(offer, u);
+  uint64_t current =
+      atomic_load_explicit(&job->labels[v], memory_order_relaxed);
+  while (labelDistance(current) > offer) {
+    if (atomic_compare_exchange_weak_explicit(&job->labels[v], &current, label,
+                                              memory_order_relaxed,
+                                              memory_order_relaxed)) {
+      if (!listPush(&buckets[bucketOf(job, offer) % job->numBuckets], v)) {
+        atomic_store_explicit(&job->pushFailed, true, memory_order_relaxed);
+      }
+      return;
+    }
+  }
+}
+
+/* Makes the frontier the union of every thread's copy of bucket
+ * 'job->bucket', emptying those copies. Called by all threads together.
+ * If the frontier cannot grow to hold them, or some vertex list could not
+ * grow before, sets 'job->failed' and leaves it empty.
+ */
+static void gatherFrontier(DeltaJob* job, int thread, int numThreads,
+                           VertexList* buckets) {
+  VertexList* mine = &buckets[job->bucket % job->numBuckets];
+  job->shared[thread] = mine->size;
+  barrierWait(job->barrier);
+  if (thread == 0) {
+    long total = 0;
+    for (int t = 0; t < numThreads; t++) {
+      long size = job->shared[t];
+      job->shared[t] = total;
+      total += size;
+    }
+    // 'failed' changes only here, while the other threads wait, so that
+    // they all see the same value until the next call
+    if (atomic_load_explicit(&job->pushFailed, memory_order_relaxed)) {
+      job->failed = true;
+      total = 0;
+    } else if (total > job->frontierCapacity) {
+      int* bigger = realloc(job->frontier, sizeof(int) * total);
+      if (bigger == NULL) {
+        job->failed = true;
+        total = 0;
+      } else {
+        job->frontier = bigger;
+        job->frontierCapacity = total;
+      }
+    }
+    job->frontierSize = total;
+    atomic_store_explicit(&job->nextChunk, 0, memory_order_relaxed);
+  }
+  barrierWait(job->barrier);
+  if (mine->size > 0 && !job->failed) {
+    memcpy(job->frontier + job->shared[thread], mine->ids,
+           sizeof(int) * mine->size);
+  }
+  mine->size = 0;
+  barrierWait(job->barrier);
+}
+
+/* Relaxes the light edges of the frontier vertices this thread claims that
+ * still belong to the current bucket, and records them in 'settled'.
+ */
+static void relaxLight(DeltaJob* job, VertexList* buckets,
+                       VertexList* settled) {
+  CSRGraph* graph = job->graph;
+  int start;
+  while ((start = atomic_fetch_add_explicit(&job->nextChunk, FRONTIER_CHUNK,
+                                            memory_order_relaxed)) <
+         job->frontierSize) {
+    int end = start + FRONTIER_CHUNK;
+    if (end > job->frontierSize) end = job->frontierSize;
+    for (int i = start; i < end; i++) {
+      int u = job->frontier[i];
+      int distance = labelDistance(
+          atomic_load_explicit(&job->labels[u], memory_order_relaxed));
+      if (bucketOf(job, distance) != job->bucket) continue;  // stale entry
+      int last = atomic_exchange_explicit(&job->relaxedAt[u], distance,
+                                          memory_order_relaxed);
+      if (last == distance) continue;  // duplicate entry
+      if ((last < 0 || bucketOf(job, last) != job->bucket) &&
+          !listPush(settled, u)) {
+        atomic_store_explicit(&job->pushFailed, true, memory_order_relaxed);
+      }
+      for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+        if (graph->weights[e] <= job->delta) {
+          relax(job, buckets, u, distance, graph->targets[e],
+                graph->weights[e]);
+        }
+      }
+    }
+  }
+}
+
+/* Relaxes the heavy edges of the vertices in 'settled', whose distances are
+ * now final, and empties it.
+ */
+static void relaxHeavy(DeltaJob* job, VertexList* buckets,
+                       VertexList* settled) {
+  CSRGraph* graph = job->graph;
+  for (int i = 0; i < settled->size; i++) {
+    int u = settled->ids[i];
+    int distance = labelDistance(
+        atomic_load_explicit(&job->labels[u], memory_order_relaxed));
+    for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+      if (graph->weights[e] > job->delta) {
+        relax(job, buckets, u, distance, graph->targets[e], graph->weights[e]);
+      }
+    }
+  }
+  settled->size = 0;
+}
+
+/* Returns the index of this thread's lowest non-empty bucket after the
+ * current one, or -1 if they are all empty.
+ */
+static long nextBucket(DeltaJob* job, VertexList* buckets) {
+  for (long b = job->bucket + 1; b < job->bucket + job->numBuckets; b++) {
+    if (buckets[b % job->numBuckets].size > 0) {
+      return b;
+    }
+  }
+  return NOTHING;
+}
+
+/* The work of thread 'thread': settles buckets in increasing order together
+ * with the other threads until none is left.
+ */
+static void deltaTask(void* arg, int thread, int numThreads) {
+  DeltaJob* job = arg;
+  VertexList* buckets = job->buckets + (long)thread * job->numBuckets;
+  VertexList* settled = &job->settled[thread];
+  while (true) {
+    // light phase: repeat until the bucket stays empty
+    while (job->frontierSize > 0) {
+      relaxLight(job, buckets, settled);
+      barrierWait(job->barrier);
+      gatherFrontier(job, thread, numThreads, buckets);
+      if (job->failed) return;
+    }
+    // heavy phase: every heavy edge lands in a later bucket
+    relaxHeavy(job, buckets, settled);
+    job->shared[thread] = nextBucket(job, buckets);
+    barrierWait(job->barrier);
+    if (thread == 0) {
+      long bucket = NOTHING;
+      for (int t = 0; t < numThreads; t++) {
+        long b = job->shared[t];
+        if (b != NOTHING && (bucket == NOTHING || b < bucket)) bucket = b;
+      }
+      job->done = bucket == NOTHING;
+      job->bucket = bucket;
+    }
+    barrierWait(job->barrier);
+    if (job->done) return;
+    gatherFrontier(job, thread, numThreads, buckets);
+    if (job->failed) return;
+  }
+}
+
+/*************************************************************************
+ ** Engines
+ *************************************************************************/
+
+/* Returns the bucket width deltaSteppingCSR uses on 'graph' when none is
+ * given: the largest weight divided by the average degree (Meyer and
+ * Sanders' choice for random weights), at least 1.
+ */
+int chooseDelta(CSRGraph* graph) {
+  int maxWeight = 0;
+  for (int i = 0; i < graph->numEdges; i++) {
+    if (graph->weights[i] > maxWeight) maxWeight = graph->weights[i];
+  }
+  long degree =
+      graph->numVertices > 0 ? graph->numEdges / graph->numVertices : 0;
+  long delta = degree > 1 ? maxWeight / degree : maxWeight;
+  return delta > 1 ? delta : 1;
+}
+
+/* Runs delta-stepping on CSRGraph 'graph' starting from vertex with ID
+ * 'startVertex', configured by 'options' (NULL for the defaults), and
+ * returns the resulting distance tree: an array of numVertices Edges.
+ * Vertices are kept in buckets of width options->delta by tentative
+ * distance. The lowest bucket is settled by options->numThreads threads at
+ * once, relaxing edges of weight at most delta until the bucket stays
+ * empty, and heavier edges once afterwards. The distances equal those of
+ * getShortestPaths; when several shortest paths tie, the predecessor
+ * chosen may vary from run to run with more than one thread.
+ * Returns NULL if 'startVertex' is not valid in 'graph', or if the frontier
+ * or the bucket lists cannot be allocated.
+ */
+Edge* deltaSteppingCSR(CSRGraph* graph, int startVertex,
+                       AlgoOptions* options) {
+  int numVertices = graph->numVertices;
+  if (startVertex < 0 || startVertex >= numVertices) {
+    return NULL;
+  }
+  int numThreads = threadCount(options != NULL ? options->numThreads : 0);
+  numThreads = threadsFor(graph->numEdges, 1 << 16, numThreads);
+  int maxWeight = 0;
+  for (int i = 0; i < graph->numEdges; i++) {
+    if (graph->weights[i] > maxWeight) maxWeight = graph->weights[i];
+  }
+
+  DeltaJob job;
+  job.graph = graph;
+  job.delta = options != NULL && options->delta > 0 ? options->delta
+                                                    : chooseDelta(graph);
+  // pending distances never span more than maxWeight past the current
+  // bucket, so that many buckets (plus two) can be reused cyclically
+  long minDelta = maxWeight / (MAX_BUCKETS - 2) + 1;
+  if (job.delta < minDelta) job.delta = minDelta;
+  job.numBuckets = maxWeight / job.delta + 2;
+  job.labels = malloc(sizeof(_Atomic uint64_t) * numVertices);
+  job.relaxedAt = malloc(sizeof(_Atomic int) * numVertices);
+  for (int v = 0; v < numVertices; v++) {
+    atomic_init(&job.labels[v], UNREACHED);
+    atomic_init(&job.relaxedAt[v], NOTHING);
+  }
+  atomic_store(&job.labels[startVertex], makeLabel(0, startVertex));
+  job.frontierCapacity = numVertices;
+  job.frontier = malloc(sizeof(int) * numVertices);
+  job.frontier[0] = startVertex;
+  job.frontierSize = 1;
+  atomic_init(&job.nextChunk, 0);
+  job.bucket = 0;
+  job.done = false;
+  job.failed = false;
+  atomic_init(&job.pushFailed, false);
+  job.buckets = calloc((long)numThreads * job.numBuckets, sizeof(VertexList));
+  job.settled = calloc(numThreads, sizeof(VertexList));
+  job.shared = malloc(sizeof(long) * numThreads);
+  job.barrier = newBarrier(numThreads);
+
+  parallelRun(numThreads, deltaTask, &job);
+
+  // the last bucket may have ended with a failed push and no gather
+  bool failed = job.failed || atomic_load(&job.pushFailed);
+  Edge* tree = failed ? NULL : malloc(sizeof(Edge) * numVertices);
+  for (int v = 0; tree != NULL && v < numVertices; v++) {
+    uint64_t label = atomic_load(&job.labels[v]);
+    tree[v] = (Edge){v, labelPred(label), labelDistance(label)};
+  }
+  for (long i = 0; i < (long)numThreads * job.numBuckets; i++) {
+    free(job.buckets[i].ids);
+  }
+  for (int t = 0; t < numThreads; t++) {
+    free(job.settled[t].ids);
+  }
+  free(job.buckets);
+  free(job.settled);
+  free(job.shared);
+  free(job.labels);
+  free(job.relaxedAt);
+  free(job.frontier);
+  deleteBarrier(job.barrier);
+  return tree;
+}
+
+/* Like deltaSteppingCSR, on Graph 'graph', which is first copied into a
+ * CSRGraph.
+ */
+Edge* deltaStepping(Graph* graph, int startVertex, AlgoOptions* options) {
+  if (startVertex < 0 || startVertex >= graph->numVertices) {
+    return NULL;
+  }
+  CSRGraph* csr = csrFromGraph(graph);
+  Edge* tree = deltaSteppingCSR(csr, startVertex, options);
+  deleteCSRGraph(csr);
+  return tree;
+}
@@ -0,0 +1,46 @@
+/*
+ * Header file for our parallel shortest path engines.
+ *
+ * These compute the same distances as getShortestPaths by other means, and
+ * return the same distance tree format: tree[v] is (v -- pred, distance),
+ * tree[start] is (start -- start, 0), and a vertex that cannot be reached is
+ * (v -- -1, INT_MAX). The trees work unchanged with getPaths and printTree.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "csr.h"
+#include "graph.h"
+#include "graph_algos.h"
+
+#ifndef __SSSP_header
+#define __SSSP_header
+
+/* Returns the bucket width deltaSteppingCSR uses on 'graph' when none is
+ * given: the largest weight divided by the average degree (Meyer and
+ * Sanders' choice for random weights), at least 1.
+ */
+int chooseDelta(CSRGraph* graph);
+
+/* Runs delta-stepping on CSRGraph 'graph' starting from vertex with ID
+ * 'startVertex', configured by 'options' (NULL for the defaults), and
+ * returns the resulting distance tree: an array of numVertices Edges.
+ * Vertices are kept in buckets of width options->delta by tentative
+ * distance. The lowest bucket is settled by options->numThreads threads at
+ * once, relaxing edges of weight at most delta until the bucket stays
+ * empty, and heavier edges once afterwards. The distances equal those of
+ * getShortestPaths; when several shortest paths tie, the predecessor
+ * chosen may vary from run to run with more than one thread.
+ * Returns NULL if 'startVertex' is not valid in 'graph', or if the frontier
+ * or the bucket lists cannot be allocated.
+ */
+Edge* deltaSteppingCSR(CSRGraph* graph, int startVertex, AlgoOptions* options);
+
+/* Like deltaSteppingCSR, on Graph 'graph', which is first copied into a
+ * CSRGraph.
+ */
+Edge* deltaStepping(Graph* graph, int startVertex, AlgoOptions* options);
+
+#endif
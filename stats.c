@@ -0,0 +1,171 @@
+/*
+ * Our instrumentation counters and phase timers.
+ */
+
+#include "stats.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef GRAPH_STATS
+bool graphStatsOn = true;
+#else
+bool graphStatsOn = false;
+#endif
+
+_Thread_local GraphStats threadStats;
+
+static GraphStats totals;  // counts flushed by all threads so far
+static pthread_mutex_t totalsLock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char* phaseNames[STATS_NUM_PHASES] = {"init", "main_loop",
+                                                   "teardown"};
+
+/*************************************************************************
+ ** Start-up
+ *************************************************************************/
+
+/* Prints the totals to stderr; registered with atexit. */
+static void dumpAtExit(void) { printGraphStats(stderr); }
+
+/* Switches collection on if the environment asks for it, and arranges for
+ * the totals to be printed at exit if it is on. Runs before main.
+ */
+__attribute__((constructor)) static void readEnvironment(void) {
+#ifdef GRAPH_NO_STATS
+  return;  // nothing is counted, so there is nothing to print
+#endif
+  const char* setting = getenv("GRAPH_STATS");
+  if (setting != NULL && setting[0] != '\0' && strcmp(setting, "0") != 0) {
+    graphStatsOn = true;
+  }
+  if (graphStatsOn) atexit(dumpAtExit);
+}
+
+/*************************************************************************
+ ** Collection
+ *************************************************************************/
+
+/* Switches collection on if 'on' is true, and off otherwise. Counts taken
+ * so far are kept.
+ */
+void setGraphStatsEnabled(bool on) { graphStatsOn = on; }
+
+#ifndef GRAPH_NO_STATS
+/* Returns the current time in seconds if collection is on, and 0
+ * otherwise.
+ */
+double statsNow(void) { return graphStatsOn ? clockNow() : 0; }
+
+/* Adds the time elapsed since 'since', a value returned by statsNow, to
+ * phase 'phase' of the calling thread. Has no effect if collection is off.
+ */
+void statsAddTime(StatsPhase phase, double since) {
+  // 'since' is 0 if collection was switched on in between
+  if (!graphStatsOn || since == 0) return;
+  threadStats.seconds[phase] += statsNow() - since;
+}
+#endif
+
+/* Adds 'stats' to 'sum': counters add up, maxima take the larger. */
+static void addStats(GraphStats* sum, GraphStats* stats) {
+  sum->runs += stats->runs;
+  sum->extractMins += stats->extractMins;
+  sum->inserts += stats->inserts;
+  sum->decreases += stats->decreases;
+  sum->rejectedDecreases += stats->rejectedDecreases;
+  sum->relaxations += stats->relaxations;
+  sum->siftSteps += stats->siftSteps;
+  sum->siftOps += stats->siftOps;
+  if (stats->maxSiftDepth > sum->maxSiftDepth) {
+    sum->maxSiftDepth = stats->maxSiftDepth;
+  }
+  if (stats->peakQueueSize > sum->peakQueueSize) {
+    sum->peakQueueSize = stats->peakQueueSize;
+  }
+  for (int p = 0; p < STATS_NUM_PHASES; p++) {
+    sum->seconds[p] += stats->seconds[p];
+  }
+}
+
+/* Adds the counts of the calling thread to the process totals and clears
+ * them, whether collection is on or not.
+ */
+static void flushThreadStats(void) {
+  pthread_mutex_lock(&totalsLock);
+  addStats(&totals, &threadStats);
+  pthread_mutex_unlock(&totalsLock);
+  memset(&threadStats, 0, sizeof(GraphStats));
+}
+
+#ifndef GRAPH_NO_STATS
+/* Adds the counts of the calling thread to the process totals and clears
+ * them. Has no effect if collection is off, so that runs do not take the
+ * lock on the totals for nothing.
+ */
+void flushGraphStats(void) {
+  if (graphStatsOn) flushThreadStats();
+}
+#endif
+
+/* Stores the process totals, including the calling thread's counts, in
+ * '*stats'.
+ */
+void getGraphStats(GraphStats* stats) {
+  flushThreadStats();
+  pthread_mutex_lock(&totalsLock);
+  *stats = totals;
+  pthread_mutex_unlock(&totalsLock);
+}
+
+/* Clears the process totals and the counts of the calling thread. */
+void resetGraphStats(void) {
+  pthread_mutex_lock(&totalsLock);
+  memset(&totals, 0, sizeof(GraphStats));
+  pthread_mutex_unlock(&totalsLock);
+  memset(&threadStats, 0, sizeof(GraphStats));
+}
+
+/*************************************************************************
+ ** Output
+ *************************************************************************/
+
+/* Prints the process totals, including the calling thread's counts, to
+ * 'stream' as one JSON object on a line.
+ */
+void printGraphStats(FILE* stream) {
+  GraphStats stats;
+  getGraphStats(&stats);
+  fprintf(stream,
+          "{\"runs\": %ld, \"extract_min\": %ld, \"inserts\": %ld, "
+          "\"decreases\": %ld, \"rejected_decreases\": %ld, "
+          "\"relaxations\": %ld, \"sift_steps\": %ld, \"sift_ops\": %ld, "
+          "\"max_sift_depth\": %d, \"peak_queue_size\": %d",
+          stats.runs, stats.extractMins, stats.inserts, stats.decreases,
+          stats.rejectedDecreases, stats.relaxations, stats.siftSteps,
+          stats.siftOps, stats.maxSiftDepth, stats.peakQueueSize);
+  for (int p = 0; p < STATS_NUM_PHASES; p++) {
+    fprintf(stream, ", \"%s_ms\": %.3f", phaseNames[p],
+            stats.seconds[p] * 1e3);
+  }
+  fprintf(stream, "}\n");
+}
+
+/*************************************************************************
+ ** Timing
+ *************************************************************************/
+
+/* Returns the current time in seconds on a monotonic clock. */
+double clockNow(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+/* Comparison function for qsort on doubles, such as times from clockNow. */
+int compareDoubles(const void* a, const void* b) {
+  double x = *(const double*)a;
+  double y = *(const double*)b;
+  return (x > y) - (x < y);
+}
@@ -0,0 +1,143 @@
+/*
+ * Header file for our instrumentation counters and phase timers.
+ *
+ * The priority queues and Prim's and Dijkstra's algorithms in graph_algos.c
+ * count their hot-path operations and time their phases into a GraphStats,
+ * so a slow run can be told apart as heap-bound (many sift steps per
+ * extraction, most time in the main loop) or memory-bound (few sift steps,
+ * time spent in initialisation and teardown, or a main loop slow for its
+ * operation count).
+ *
+ * Collection is off by default and then costs one well-predicted branch
+ * per hook. It is switched on at compile time by building with
+ * -DGRAPH_STATS, or at run time by setting the environment variable
+ * GRAPH_STATS to anything but "" or "0"; either way the totals are printed
+ * to stderr as one JSON object when the program exits. Programs can also
+ * switch it with setGraphStatsEnabled and read the totals themselves with
+ * getGraphStats. Building with -DGRAPH_NO_STATS removes the hooks
+ * altogether: the counters, statsNow, statsAddTime and flushGraphStats
+ * compile to nothing.
+ *
+ * Each thread counts into its own GraphStats; a thread's counts join the
+ * process totals when one of its algorithm runs ends, or when it calls
+ * getGraphStats or printGraphStats.
+ *
+ * clockNow and compareDoubles are the clock and the sort order the
+ * benchmarks time with.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef __Stats_header
+#define __Stats_header
+
+typedef enum stats_phase {
+  STATS_INIT = 0,   // setting up records and the priority queue
+  STATS_MAIN_LOOP,  // extracting vertices and relaxing their edges
+  STATS_TEARDOWN,   // completing the tree and freeing the records
+  STATS_NUM_PHASES
+} StatsPhase;
+
+typedef struct graph_stats {
+  long runs;               // number of single-source searches started
+  long extractMins;        // number of nodes extracted from a queue
+  long inserts;            // number of nodes inserted into a queue, one by
+                           //   one or in bulk
+  long decreases;          // decreasePriority calls that lowered a priority
+  long rejectedDecreases;  // decreasePriority calls that changed nothing
+  long relaxations;        // number of edges examined from a settled vertex
+  long siftSteps;          // levels moved by heap sift-ups and sift-downs
+  long siftOps;            // number of sift-ups and sift-downs
+  int maxSiftDepth;        // most levels moved by a single sift
+  int peakQueueSize;       // most nodes held by a single queue
+  double seconds[STATS_NUM_PHASES];  // time spent in each phase
+} GraphStats;
+
+extern bool graphStatsOn;                     // true iff collection is on
+extern _Thread_local GraphStats threadStats;  // the calling thread's counts
+
+#ifdef GRAPH_NO_STATS
+#define STATS_ADD(field, amount) ((void)0)
+#define STATS_MAX(field, value) ((void)0)
+#define STATS_SIFT(depth) ((void)0)
+#else
+/* Adds 'amount' to counter 'field' of the calling thread. */
+#define STATS_ADD(field, amount)     \
+  do {                               \
+    if (graphStatsOn) {              \
+      threadStats.field += (amount); \
+    }                                \
+  } while (0)
+
+/* Raises counter 'field' of the calling thread to 'value' if it is lower. */
+#define STATS_MAX(field, value)                        \
+  do {                                                 \
+    if (graphStatsOn && (value) > threadStats.field) { \
+      threadStats.field = (value);                     \
+    }                                                  \
+  } while (0)
+
+/* Records a heap sift that moved a node 'depth' levels. */
+#define STATS_SIFT(depth)                       \
+  do {                                          \
+    if (graphStatsOn) {                         \
+      threadStats.siftSteps += (depth);         \
+      threadStats.siftOps++;                    \
+      if ((depth) > threadStats.maxSiftDepth) { \
+        threadStats.maxSiftDepth = (depth);     \
+      }                                         \
+    }                                           \
+  } while (0)
+#endif
+
+/* Switches collection on if 'on' is true, and off otherwise. Counts taken
+ * so far are kept.
+ */
+void setGraphStatsEnabled(bool on);
+
+#ifdef GRAPH_NO_STATS
+static inline double statsNow(void) { return 0; }
+static inline void statsAddTime(StatsPhase phase, double since) {}
+static inline void flushGraphStats(void) {}
+#else
+/* Returns the current time in seconds if collection is on, and 0
+ * otherwise.
+ */
+double statsNow(void);
+
+/* Adds the time elapsed since 'since', a value returned by statsNow, to
+ * phase 'phase' of the calling thread. Has no effect if collection is off.
+ */
+void statsAddTime(StatsPhase phase, double since);
+
+/* Adds the counts of the calling thread to the process totals and clears
+ * them. Has no effect if collection is off, so that runs do not take the
+ * lock on the totals for nothing.
+ */
+void flushGraphStats(void);
+#endif
+
+/* Stores the process totals, including the calling thread's counts, in
+ * '*stats'.
+ */
+void getGraphStats(GraphStats* stats);
+
+/* Clears the process totals and the counts of the calling thread. */
+void resetGraphStats(void);
+
+/* Prints the process totals, including the calling thread's counts, to
+ * 'stream' as one JSON object on a line.
+ */
+void printGraphStats(FILE* stream);
+
+/***** Timing ***************************************************************/
+
+/* Returns the current time in seconds on a monotonic clock. */
+double clockNow(void);
+
+/* Comparison function for qsort on doubles, such as times from clockNow. */
+int compareDoubles(const void* a, const void* b);
+
+#endif
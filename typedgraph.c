@@ -0,0 +1,229 @@
+/*
+ * Our graphs with specialized weight types.
+ */
+
+#include "typedgraph.h"
+
+#include <math.h>
+
+#define NOTHING -1
+#define SETTLED -2
+#define TYPED_ARITY 4
+
+typedef struct weight_ops {
+  const char* name;     // short name of the weight type
+  size_t weightSize;    // size of one weight in bytes
+  size_t distanceSize;  // size of one distance in bytes
+  bool (*convertWeights)(CSRGraph* graph, void* weights);
+  void (*shortestPaths)(TypedGraph* graph, int startVertex, TypedTree* tree);
+  void (*primMST)(TypedGraph* graph, int startVertex, TypedTree* tree);
+} WeightOps;
+
+/*************************************************************************
+ ** Specializations (see typedgraph_impl.h)
+ *************************************************************************/
+
+#define SUFFIX U16
+#define WEIGHT_NAME "u16"
+#define WEIGHT_T uint16_t
+#define DIST_T uint32_t
+#define DIST_MAX UINT32_MAX
+#define WEIGHT_FITS(w) ((w) >= 0 && (w) <= UINT16_MAX)
+#define ADD_DIST(a, b, sum) __builtin_add_overflow(a, b, sum)
+#include "typedgraph_impl.h"
+
+#define SUFFIX U32
+#define WEIGHT_NAME "u32"
+#define WEIGHT_T uint32_t
+#define DIST_T uint64_t
+#define DIST_MAX UINT64_MAX
+#define WEIGHT_FITS(w) ((w) >= 0)
+#define ADD_DIST(a, b, sum) __builtin_add_overflow(a, b, sum)
+#include "typedgraph_impl.h"
+
+#define SUFFIX U64
+#define WEIGHT_NAME "u64"
+#define WEIGHT_T uint64_t
+#define DIST_T uint64_t
+#define DIST_MAX UINT64_MAX
+#define WEIGHT_FITS(w) ((w) >= 0)
+#define ADD_DIST(a, b, sum) __builtin_add_overflow(a, b, sum)
+#include "typedgraph_impl.h"
+
+#define SUFFIX Float
+#define WEIGHT_NAME "float"
+#define WEIGHT_T float
+#define DIST_T double
+#define DIST_MAX INFINITY
+// a float holds every integer up to 2^24 exactly, and rounds larger ones
+#define WEIGHT_FITS(w) ((w) >= 0 && (w) <= (1 << 24))
+#define ADD_DIST(a, b, sum) (*(sum) = (double)(a) + (b), false)
+#include "typedgraph_impl.h"
+
+/* Returns the operations of weight type 'type', or NULL if there is no such
+ * type.
+ */
+static const WeightOps* opsFor(WeightType type) {
+  switch (type) {
+    case WEIGHT_U16:
+      return &opsU16;
+    case WEIGHT_U32:
+      return &opsU32;
+    case WEIGHT_U64:
+      return &opsU64;
+    case WEIGHT_FLOAT:
+      return &opsFloat;
+    default:
+      return NULL;
+  }
+}
+
+/*************************************************************************
+ ** Construction
+ *************************************************************************/
+
+/* Returns the name of weight type 'type', or NULL if there is no such type.
+ */
+const char* weightTypeName(WeightType type) {
+  const WeightOps* ops = opsFor(type);
+  return ops != NULL ? ops->name : NULL;
+}
+
+/* Returns true iff every distance in a graph with 'numVertices' vertices and
+ * weights at most 'maxWeight' fits in a uint32_t below UINT32_MAX: a
+ * shortest path has at most numVertices - 1 edges.
+ */
+static bool distancesFitU32(int numVertices, int maxWeight) {
+  uint64_t longest = (uint64_t)(numVertices > 0 ? numVertices - 1 : 0) *
+                     (uint64_t)maxWeight;
+  return longest < UINT32_MAX;
+}
+
+/* Returns the largest weight of 'graph', or -1 if some weight is negative.
+ */
+static int maxWeightOf(CSRGraph* graph) {
+  int maxWeight = 0;
+  for (int i = 0; i < graph->numEdges; i++) {
+    if (graph->weights[i] < 0) return -1;
+    if (graph->weights[i] > maxWeight) maxWeight = graph->weights[i];
+  }
+  return maxWeight;
+}
+
+/* Returns the narrowest integer weight type that holds every weight of
+ * 'graph' and every distance in it, or WEIGHT_NUM_TYPES if some weight is
+ * negative.
+ */
+WeightType narrowestWeightType(CSRGraph* graph) {
+  int maxWeight = maxWeightOf(graph);
+  if (maxWeight < 0) return WEIGHT_NUM_TYPES;
+  if (maxWeight <= UINT16_MAX &&
+      distancesFitU32(graph->numVertices, maxWeight)) {
+    return WEIGHT_U16;
+  }
+  return WEIGHT_U32;
+}
+
+/* Returns a newly created TypedGraph of weight type 'type' with space for
+ * 'numVertices' vertices and 'numEdges' adjacency slots, for the caller to
+ * fill in. All offsets are 0. Returns NULL if 'type' is not a weight type.
+ * Precondition: numVertices >= 0, numEdges >= 0
+ */
+TypedGraph* newTypedGraph(WeightType type, int numVertices, int numEdges) {
+  const WeightOps* ops = opsFor(type);
+  if (ops == NULL) return NULL;
+  TypedGraph* graph = malloc(sizeof(TypedGraph));
+  graph->type = type;
+  graph->numVertices = numVertices;
+  graph->numEdges = numEdges;
+  graph->offsets = calloc(numVertices + 1, sizeof(int));
+  graph->targets = malloc(sizeof(int) * (numEdges > 0 ? numEdges : 1));
+  graph->weights = malloc(ops->weightSize * (numEdges > 0 ? numEdges : 1));
+  return graph;
+}
+
+/* Returns a newly created TypedGraph with the vertices and adjacencies of
+ * 'graph' and its weights converted to 'type'.
+ * Returns NULL if 'type' is not a weight type, if some weight is negative
+ * or too large for 'type', or if 'type' is WEIGHT_U16 and some distance in
+ * 'graph' might not fit in a uint32_t.
+ */
+TypedGraph* typedGraphFromCSR(CSRGraph* graph, WeightType type) {
+  if (type == WEIGHT_U16 &&
+      !distancesFitU32(graph->numVertices, maxWeightOf(graph))) {
+    return NULL;
+  }
+  TypedGraph* typed = newTypedGraph(type, graph->numVertices, graph->numEdges);
+  if (typed == NULL) return NULL;
+  if (!opsFor(type)->convertWeights(graph, typed->weights)) {
+    deleteTypedGraph(typed);
+    return NULL;
+  }
+  for (int v = 0; v <= graph->numVertices; v++) {
+    typed->offsets[v] = graph->offsets[v];
+  }
+  for (int i = 0; i < graph->numEdges; i++) {
+    typed->targets[i] = graph->targets[i];
+  }
+  return typed;
+}
+
+/* Frees memory allocated for 'graph'.
+ */
+void deleteTypedGraph(TypedGraph* graph) {
+  if (graph == NULL) return;
+  free(graph->offsets);
+  free(graph->targets);
+  free(graph->weights);
+  free(graph);
+}
+
+/*************************************************************************
+ ** Algorithms
+ *************************************************************************/
+
+/* Returns a newly created TypedTree for 'graph' rooted at 'startVertex',
+ * with its arrays allocated but not filled.
+ */
+static TypedTree* newTypedTree(TypedGraph* graph, int startVertex) {
+  int slots = graph->numVertices > 0 ? graph->numVertices : 1;
+  TypedTree* tree = malloc(sizeof(TypedTree));
+  tree->type = graph->type;
+  tree->numVertices = graph->numVertices;
+  tree->startVertex = startVertex;
+  tree->parents = malloc(sizeof(int) * slots);
+  tree->values = malloc(opsFor(graph->type)->distanceSize * slots);
+  return tree;
+}
+
+/* Runs Dijkstra's algorithm on 'graph' from vertex with ID 'startVertex' and
+ * returns the resulting shortest path tree. 'graph' need not be connected.
+ * Returns NULL if 'startVertex' is not valid in 'graph'.
+ */
+TypedTree* typedShortestPaths(TypedGraph* graph, int startVertex) {
+  if (startVertex < 0 || startVertex >= graph->numVertices) return NULL;
+  TypedTree* tree = newTypedTree(graph, startVertex);
+  opsFor(graph->type)->shortestPaths(graph, startVertex, tree);
+  return tree;
+}
+
+/* Runs Prim's algorithm on 'graph' from vertex with ID 'startVertex' and
+ * returns the minimum spanning tree of the component of 'startVertex'.
+ * Returns NULL if 'startVertex' is not valid in 'graph'.
+ * Precondition: 'graph' is undirected
+ */
+TypedTree* typedPrimMST(TypedGraph* graph, int startVertex) {
+  if (startVertex < 0 || startVertex >= graph->numVertices) return NULL;
+  TypedTree* tree = newTypedTree(graph, startVertex);
+  opsFor(graph->type)->primMST(graph, startVertex, tree);
+  return tree;
+}
+
+/* Frees memory allocated for 'tree'.
+ */
+void deleteTypedTree(TypedTree* tree) {
+  if (tree == NULL) return;
+  free(tree->parents);
+  free(tree->values);
+  free(tree);
+}
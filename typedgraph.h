@@ -0,0 +1,118 @@
+/*
+ * Header file for our graphs with specialized weight types.
+ *
+ * Graph, CSRGraph and the algorithms of graph_algos.h keep weights and
+ * distances in plain ints, with INT_MAX standing for "unreached", so long
+ * paths overflow and small weights take four bytes each. A TypedGraph is a
+ * CSRGraph whose weights have one of the types below, chosen when the graph
+ * is built; Dijkstra's and Prim's algorithms on it run on a heap keyed by
+ * the matching distance type:
+ *   WEIGHT_U16    uint16_t weights, uint32_t distances
+ *   WEIGHT_U32    uint32_t weights, uint64_t distances
+ *   WEIGHT_U64    uint64_t weights, uint64_t distances
+ *   WEIGHT_FLOAT  float weights, double distances
+ * Each type has its own copy of the heap and the algorithms, stamped out
+ * from typedgraph_impl.h, so the inner loops work on the narrow types
+ * directly.
+ *
+ * Float weights are exact integers: typedGraphFromCSR refuses weights
+ * above 2^24, which a float would round.
+ *
+ * A path whose length does not fit its distance type is treated as not
+ * existing. That cannot happen for WEIGHT_U32 or WEIGHT_FLOAT, nor for
+ * WEIGHT_U16 graphs built by typedGraphFromCSR.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "csr.h"
+
+#ifndef __TypedGraph_header
+#define __TypedGraph_header
+
+typedef enum weight_type {
+  WEIGHT_U16 = 0,  // uint16_t weights, uint32_t distances
+  WEIGHT_U32,      // uint32_t weights, uint64_t distances
+  WEIGHT_U64,      // uint64_t weights, uint64_t distances
+  WEIGHT_FLOAT,    // float weights, double distances
+  WEIGHT_NUM_TYPES
+} WeightType;
+
+typedef struct typed_graph {
+  WeightType type;  // type of the weights
+  int numVertices;  // total number of vertices
+  int numEdges;     // total number of adjacency slots (directed edges)
+  int* offsets;     // array of numVertices + 1 offsets into targets and
+                    //   weights, as in a CSRGraph
+  int* targets;     // targets[i] is the neighbour stored in slot i
+  void* weights;    // weights[i] is the weight of the edge in slot i, an
+                    //   array of the weight type of 'type'
+} TypedGraph;
+
+typedef struct typed_tree {
+  WeightType type;  // type of the graph the tree was computed on
+  int numVertices;  // vertices are 0, 1, ..., numVertices-1
+  int startVertex;  // the root of the tree
+  int* parents;     // parents[v] is v's parent, or -1 for the start vertex
+                    //   and unreached vertices
+  void* values;     // an array of the distance type of 'type': the distance
+                    //   of each vertex from the start for a shortest path
+                    //   tree, the weight of the edge to its parent for an
+                    //   MST; the type's maximum (INFINITY for double) for
+                    //   unreached vertices
+} TypedTree;
+
+/***** Construction *********************************************************/
+
+/* Returns the name of weight type 'type', or NULL if there is no such type.
+ */
+const char* weightTypeName(WeightType type);
+
+/* Returns the narrowest integer weight type that holds every weight of
+ * 'graph' and every distance in it, or WEIGHT_NUM_TYPES if some weight is
+ * negative.
+ */
+WeightType narrowestWeightType(CSRGraph* graph);
+
+/* Returns a newly created TypedGraph with the vertices and adjacencies of
+ * 'graph' and its weights converted to 'type'.
+ * Returns NULL if 'type' is not a weight type, if some weight is negative
+ * or too large for 'type', or if 'type' is WEIGHT_U16 and some distance in
+ * 'graph' might not fit in a uint32_t.
+ */
+TypedGraph* typedGraphFromCSR(CSRGraph* graph, WeightType type);
+
+/* Returns a newly created TypedGraph of weight type 'type' with space for
+ * 'numVertices' vertices and 'numEdges' adjacency slots, for the caller to
+ * fill in. All offsets are 0. Returns NULL if 'type' is not a weight type.
+ * Precondition: numVertices >= 0, numEdges >= 0
+ */
+TypedGraph* newTypedGraph(WeightType type, int numVertices, int numEdges);
+
+/* Frees memory allocated for 'graph'.
+ */
+void deleteTypedGraph(TypedGraph* graph);
+
+/***** Algorithms ***********************************************************/
+
+/* Runs Dijkstra's algorithm on 'graph' from vertex with ID 'startVertex' and
+ * returns the resulting shortest path tree. 'graph' need not be connected.
+ * Returns NULL if 'startVertex' is not valid in 'graph'.
+ */
+TypedTree* typedShortestPaths(TypedGraph* graph, int startVertex);
+
+/* Runs Prim's algorithm on 'graph' from vertex with ID 'startVertex' and
+ * returns the minimum spanning tree of the component of 'startVertex'.
+ * Returns NULL if 'startVertex' is not valid in 'graph'.
+ * Precondition: 'graph' is undirected
+ */
+TypedTree* typedPrimMST(TypedGraph* graph, int startVertex);
+
+/* Frees memory allocated for 'tree'.
+ */
+void deleteTypedTree(TypedTree* tree);
+
+#endif
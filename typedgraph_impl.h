@@ -0,0 +1,220 @@
+/*
+ * Template for one weight type of typedgraph.c: a d-ary heap keyed by the
+ * distance type, and Dijkstra's and Prim's algorithms on it. typedgraph.c
+ * includes this file once per weight type, with these macros defined:
+ *   SUFFIX               suffix of every generated name, e.g. U16
+ *   WEIGHT_NAME          name of the weight type, e.g. "u16"
+ *   WEIGHT_T             the weight type
+ *   DIST_T               the distance type, also the heap's key type
+ *   DIST_MAX             the largest DIST_T, standing for "unreached"
+ *   WEIGHT_FITS(w)       true iff the int weight 'w' is a valid WEIGHT_T
+ *   ADD_DIST(a, b, sum)  stores a + b in '*sum'; true iff it overflowed
+ * and undefines them at the end. There is no include guard on purpose.
+ */
+
+#define TYPED_PASTE(name, suffix) name##suffix
+#define TYPED_NAME(name, suffix) TYPED_PASTE(name, suffix)
+#define TYPED(name) TYPED_NAME(name, SUFFIX)
+
+typedef struct TYPED(typed_heap_) {
+  int size;       // the number of nodes in this heap
+  DIST_T* keys;   // keys[i] is the key of the node at index i
+  int* ids;       // ids[i] is the ID of the node at index i
+  int* indexMap;  // indexMap[id] is the index of node with ID id, NOTHING
+                  //   if it was never inserted, SETTLED once extracted
+} TYPED(Heap);
+
+/*************************************************************************
+ ** Heap
+ *************************************************************************/
+
+/* Returns a newly created empty heap for IDs 0 .. 'capacity' - 1. */
+static TYPED(Heap) * TYPED(newHeap)(int capacity) {
+  TYPED(Heap)* heap = malloc(sizeof(TYPED(Heap)));
+  int slots = capacity > 0 ? capacity : 1;
+  heap->size = 0;
+  heap->keys = malloc(sizeof(DIST_T) * slots);
+  heap->ids = malloc(sizeof(int) * slots);
+  heap->indexMap = malloc(sizeof(int) * slots);
+  for (int i = 0; i < capacity; i++) {
+    heap->indexMap[i] = NOTHING;
+  }
+  return heap;
+}
+
+/* Frees memory allocated for 'heap'. */
+static void TYPED(deleteHeap)(TYPED(Heap) * heap) {
+  free(heap->keys);
+  free(heap->ids);
+  free(heap->indexMap);
+  free(heap);
+}
+
+/* Moves the hole at index 'index' of 'heap' up until node ('key', 'id') can
+ * be placed there, then places it.
+ */
+static void TYPED(siftUp)(TYPED(Heap) * heap, int index, DIST_T key,
+                          int id) {
+  while (index > 0) {
+    int parent = (index - 1) / TYPED_ARITY;
+    if (heap->keys[parent] <= key) break;
+    heap->keys[index] = heap->keys[parent];
+    heap->ids[index] = heap->ids[parent];
+    heap->indexMap[heap->ids[index]] = index;
+    index = parent;
+  }
+  heap->keys[index] = key;
+  heap->ids[index] = id;
+  heap->indexMap[id] = index;
+}
+
+/* Moves the hole at index 'index' of 'heap' down until node ('key', 'id')
+ * can be placed there, then places it.
+ */
+static void TYPED(siftDown)(TYPED(Heap) * heap, int index, DIST_T key,
+                            int id) {
+  while (1) {
+    int first = TYPED_ARITY * index + 1;
+    if (first >= heap->size) break;
+    int last = first + TYPED_ARITY < heap->size ? first + TYPED_ARITY
+                                                : heap->size;
+    int minIdx = first;
+    for (int child = first + 1; child < last; child++) {
+      if (heap->keys[child] < heap->keys[minIdx]) minIdx = child;
+    }
+    if (heap->keys[minIdx] >= key) break;
+    heap->keys[index] = heap->keys[minIdx];
+    heap->ids[index] = heap->ids[minIdx];
+    heap->indexMap[heap->ids[index]] = index;
+    index = minIdx;
+  }
+  heap->keys[index] = key;
+  heap->ids[index] = id;
+  heap->indexMap[id] = index;
+}
+
+/* Inserts node ('key', 'id') into 'heap' if 'id' has never been in it, or
+ * lowers its key to 'key' if it is in it.
+ * Precondition: 'id' is not settled; 'key' is below its current key
+ */
+static void TYPED(offer)(TYPED(Heap) * heap, DIST_T key, int id) {
+  int index = heap->indexMap[id];
+  if (index == NOTHING) index = heap->size++;
+  TYPED(siftUp)(heap, index, key, id);
+}
+
+/* Removes the node with the smallest key from 'heap', marks it settled,
+ * and returns its ID.
+ * Precondition: heap is non-empty
+ */
+static int TYPED(extract)(TYPED(Heap) * heap) {
+  int id = heap->ids[0];
+  heap->indexMap[id] = SETTLED;
+  int last = --heap->size;
+  if (last > 0) {
+    TYPED(siftDown)(heap, 0, heap->keys[last], heap->ids[last]);
+  }
+  return id;
+}
+
+/*************************************************************************
+ ** Algorithms
+ *************************************************************************/
+
+/* Converts the weights of 'graph' into the array 'weights' of WEIGHT_T.
+ * Returns false if some weight is not a valid WEIGHT_T.
+ */
+static bool TYPED(convertWeights)(CSRGraph* graph, void* weights) {
+  WEIGHT_T* out = weights;
+  for (int i = 0; i < graph->numEdges; i++) {
+    int weight = graph->weights[i];
+    if (!WEIGHT_FITS(weight)) return false;
+    out[i] = (WEIGHT_T)weight;
+  }
+  return true;
+}
+
+/* Runs Dijkstra's algorithm on 'graph' from 'startVertex' and writes the
+ * shortest path tree to 'tree', whose arrays are allocated.
+ */
+static void TYPED(shortestPaths)(TypedGraph* graph, int startVertex,
+                                 TypedTree* tree) {
+  int numVertices = graph->numVertices;
+  const int* offsets = graph->offsets;
+  const int* targets = graph->targets;
+  const WEIGHT_T* weights = graph->weights;
+  DIST_T* distances = tree->values;
+  int* parents = tree->parents;
+  for (int v = 0; v < numVertices; v++) {
+    distances[v] = DIST_MAX;
+    parents[v] = NOTHING;
+  }
+  TYPED(Heap)* heap = TYPED(newHeap)(numVertices);
+  distances[startVertex] = 0;
+  TYPED(offer)(heap, 0, startVertex);
+  while (heap->size > 0) {
+    int u = TYPED(extract)(heap);
+    DIST_T distance = distances[u];
+    for (int i = offsets[u]; i < offsets[u + 1]; i++) {
+      int v = targets[i];
+      if (heap->indexMap[v] == SETTLED) continue;
+      DIST_T total;
+      // a sum reaching DIST_MAX is no better than "unreached"
+      if (ADD_DIST(distance, weights[i], &total) || total >= distances[v]) {
+        continue;
+      }
+      distances[v] = total;
+      parents[v] = u;
+      TYPED(offer)(heap, total, v);
+    }
+  }
+  TYPED(deleteHeap)(heap);
+}
+
+/* Runs Prim's algorithm on 'graph' from 'startVertex' and writes the
+ * minimum spanning tree of its component to 'tree', whose arrays are
+ * allocated.
+ */
+static void TYPED(primMST)(TypedGraph* graph, int startVertex,
+                           TypedTree* tree) {
+  int numVertices = graph->numVertices;
+  const int* offsets = graph->offsets;
+  const int* targets = graph->targets;
+  const WEIGHT_T* weights = graph->weights;
+  DIST_T* edgeWeights = tree->values;
+  int* parents = tree->parents;
+  for (int v = 0; v < numVertices; v++) {
+    edgeWeights[v] = DIST_MAX;
+    parents[v] = NOTHING;
+  }
+  TYPED(Heap)* heap = TYPED(newHeap)(numVertices);
+  edgeWeights[startVertex] = 0;
+  TYPED(offer)(heap, 0, startVertex);
+  while (heap->size > 0) {
+    int u = TYPED(extract)(heap);
+    for (int i = offsets[u]; i < offsets[u + 1]; i++) {
+      int v = targets[i];
+      DIST_T weight = weights[i];
+      if (heap->indexMap[v] == SETTLED || weight >= edgeWeights[v]) continue;
+      edgeWeights[v] = weight;
+      parents[v] = u;
+      TYPED(offer)(heap, weight, v);
+    }
+  }
+  TYPED(deleteHeap)(heap);
+}
+
+static const WeightOps TYPED(ops) = {
+    WEIGHT_NAME,           sizeof(WEIGHT_T),      sizeof(DIST_T),
+    TYPED(convertWeights), TYPED(shortestPaths), TYPED(primMST)};
+
+#undef TYPED
+#undef TYPED_NAME
+#undef TYPED_PASTE
+#undef SUFFIX
+#undef WEIGHT_NAME
+#undef WEIGHT_T
+#undef DIST_T
+#undef DIST_MAX
+#undef WEIGHT_FITS
+#undef ADD_DIST
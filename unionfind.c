@@ -0,0 +1,76 @@
+/*
+ * Our union-find (disjoint set) implementation.
+ */
+
+#include "unionfind.h"
+
+/* Returns the representative of the set containing 'x' in 'sets'.
+ * Precondition: 0 <= x < sets->numElements
+ */
+int ufFind(UnionFind* sets, int x) {
+  int root = x;
+  while (sets->parent[root] != root) {
+    root = sets->parent[root];
+  }
+  // second pass: point every node on the path straight at the root
+  while (sets->parent[x] != root) {
+    int next = sets->parent[x];
+    sets->parent[x] = root;
+    x = next;
+  }
+  return root;
+}
+
+/* Merges the sets containing 'x' and 'y' in 'sets'. Returns true iff they
+ * were different sets.
+ * Precondition: 0 <= x, y < sets->numElements
+ */
+bool ufUnion(UnionFind* sets, int x, int y) {
+  x = ufFind(sets, x);
+  y = ufFind(sets, y);
+  if (x == y) {
+    return false;
+  }
+  if (sets->rank[x] < sets->rank[y]) {
+    int t = x;
+    x = y;
+    y = t;
+  }
+  sets->parent[y] = x;
+  if (sets->rank[x] == sets->rank[y]) {
+    sets->rank[x]++;
+  }
+  sets->numSets--;
+  return true;
+}
+
+/* Returns true iff 'x' and 'y' are in the same set in 'sets'.
+ * Precondition: 0 <= x, y < sets->numElements
+ */
+bool ufConnected(UnionFind* sets, int x, int y) {
+  return ufFind(sets, x) == ufFind(sets, y);
+}
+
+/* Returns a newly created UnionFind in which each of the elements
+ * 0 .. 'numElements' - 1 is in a set of its own.
+ * Precondition: numElements >= 0
+ */
+UnionFind* newUnionFind(int numElements) {
+  UnionFind* new = malloc(sizeof(UnionFind));
+  new->numElements = numElements;
+  new->numSets = numElements;
+  new->parent = malloc(sizeof(int) * (numElements > 0 ? numElements : 1));
+  new->rank = calloc(numElements > 0 ? numElements : 1, sizeof(int));
+  for (int i = 0; i < numElements; i++) {
+    new->parent[i] = i;
+  }
+  return new;
+}
+
+/* Frees all memory allocated for 'sets'.
+ */
+void deleteUnionFind(UnionFind* sets) {
+  free(sets->parent);
+  free(sets->rank);
+  free(sets);
+}
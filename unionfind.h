@@ -0,0 +1,49 @@
+/*
+ * Header file for our union-find (disjoint set) implementation.
+ *
+ * A UnionFind partitions the elements 0 .. numElements - 1 into disjoint
+ * sets. Sets are merged by rank and find compresses the paths it walks, so
+ * a sequence of operations runs in nearly linear time.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef __UnionFind_header
+#define __UnionFind_header
+
+typedef struct union_find {
+  int numElements;  // elements are 0, 1, ..., numElements-1
+  int numSets;      // current number of disjoint sets
+  int* parent;      // parent[x] is the parent of x, or x if x is a root
+  int* rank;        // rank[x] bounds the height of the tree rooted at x
+} UnionFind;
+
+/* Returns the representative of the set containing 'x' in 'sets'.
+ * Precondition: 0 <= x < sets->numElements
+ */
+int ufFind(UnionFind* sets, int x);
+
+/* Merges the sets containing 'x' and 'y' in 'sets'. Returns true iff they
+ * were different sets.
+ * Precondition: 0 <= x, y < sets->numElements
+ */
+bool ufUnion(UnionFind* sets, int x, int y);
+
+/* Returns true iff 'x' and 'y' are in the same set in 'sets'.
+ * Precondition: 0 <= x, y < sets->numElements
+ */
+bool ufConnected(UnionFind* sets, int x, int y);
+
+/* Returns a newly created UnionFind in which each of the elements
+ * 0 .. 'numElements' - 1 is in a set of its own.
+ * Precondition: numElements >= 0
+ */
+UnionFind* newUnionFind(int numElements);
+
+/* Frees all memory allocated for 'sets'.
+ */
+void deleteUnionFind(UnionFind* sets);
+
+#endif